@@ -0,0 +1,116 @@
+#Converts the given FieldML library document into a table of object creation records, which can be instantiated into
+#a session without parsing the document. Used to generate the built-in library image in Image_InternalLibrary.cpp
+#from FieldML_Library_0.5.xml. The output is expected to be pasted in to Image_InternalLibrary.cpp.
+#
+#The records are listed in the order in which FieldmlDOM would create the objects, so that the objects' handles are
+#the same either way. Only the elements used by the library are supported.
+
+import sys
+from xml.dom import minidom
+
+def elementChildren( node, tag = None ):
+  children = []
+  for child in node.childNodes:
+    if( ( child.nodeType == child.ELEMENT_NODE ) and ( ( tag == None ) or ( child.tagName == tag ) ) ):
+      children.append( child )
+  return children
+
+def firstChild( node, tag ):
+  children = elementChildren( node, tag )
+  if( len( children ) == 0 ):
+    return None
+  return children[0]
+
+def quote( value ):
+  if( value == None ):
+    return "NULL"
+  return "\"" + value.replace( "\\", "\\\\" ).replace( "\"", "\\\"" ) + "\""
+
+class LibraryImage:
+  def __init__( self, regionNode ):
+    self.objects = elementChildren( regionNode )
+    self.objectsByName = {}
+    for node in self.objects:
+      if( node.hasAttribute( "name" ) ):
+        self.objectsByName[node.getAttribute( "name" )] = node
+    self.states = {}
+    self.records = []
+
+  def addRecord( self, operation, name = None, reference = None, values = ( 0, 0, 0 ) ):
+    self.records.append( ( operation, name, reference, values ) )
+
+  #As with getObjectAttribute in FieldmlDOM.cpp, an object is created before any object that refers to it.
+  def resolve( self, name ):
+    node = self.objectsByName.get( name )
+    if( ( node != None ) and ( self.states.get( id( node ) ) != "parsed" ) ):
+      self.parse( node )
+    return name
+
+  def parseArguments( self, node ):
+    argumentsNode = firstChild( node, "Arguments" )
+    if( argumentsNode == None ):
+      return
+    for argumentNode in elementChildren( argumentsNode, "Argument" ):
+      self.addRecord( "LIBRARY_ARGUMENT", reference = self.resolve( argumentNode.getAttribute( "name" ) ) )
+
+  def parse( self, node ):
+    name = node.getAttribute( "name" )
+    if( self.states.get( id( node ) ) == "parsing" ):
+      sys.exit( "Recursive object definition: " + name )
+    self.states[id( node )] = "parsing"
+
+    if( node.tagName == "BooleanType" ):
+      self.addRecord( "LIBRARY_BOOLEAN_TYPE", name )
+    elif( node.tagName == "ContinuousType" ):
+      self.addRecord( "LIBRARY_CONTINUOUS_TYPE", name )
+      componentsNode = firstChild( node, "Components" )
+      if( componentsNode != None ):
+        count = int( componentsNode.getAttribute( "count" ) )
+        self.addRecord( "LIBRARY_TYPE_COMPONENTS", componentsNode.getAttribute( "name" ), values = ( count, 0, 0 ) )
+    elif( node.tagName == "EnsembleType" ):
+      self.addRecord( "LIBRARY_ENSEMBLE_TYPE", name )
+      membersNode = firstChild( node, "Members" )
+      rangeNode = None
+      if( membersNode != None ):
+        rangeNode = firstChild( membersNode, "MemberRange" )
+      if( ( rangeNode == None ) or ( elementChildren( membersNode )[0] != rangeNode ) ):
+        sys.exit( "Unsupported member specification: " + name )
+      stride = 1
+      if( rangeNode.hasAttribute( "stride" ) ):
+        stride = int( rangeNode.getAttribute( "stride" ) )
+      values = ( int( rangeNode.getAttribute( "min" ) ), int( rangeNode.getAttribute( "max" ) ), stride )
+      self.addRecord( "LIBRARY_MEMBERS_RANGE", values = values )
+    elif( node.tagName == "ArgumentEvaluator" ):
+      valueType = self.resolve( node.getAttribute( "valueType" ) )
+      self.addRecord( "LIBRARY_ARGUMENT_EVALUATOR", name, valueType )
+      self.parseArguments( node )
+    elif( node.tagName == "ExternalEvaluator" ):
+      valueType = self.resolve( node.getAttribute( "valueType" ) )
+      self.addRecord( "LIBRARY_EXTERNAL_EVALUATOR", name, valueType )
+      self.parseArguments( node )
+    else:
+      sys.exit( "Unsupported library element: " + node.tagName )
+
+    self.states[id( node )] = "parsed"
+
+  def parseAll( self ):
+    for node in self.objects:
+      if( self.states.get( id( node ) ) == None ):
+        self.parse( node )
+
+def processFile( filename ):
+  document = minidom.parse( filename )
+
+  image = LibraryImage( firstChild( document.documentElement, "Region" ) )
+  image.parseAll()
+
+  sys.stdout.write( "const LibraryImageRecord FML_IMAGE_INTERNAL_LIBRARY[] =\n" )
+  sys.stdout.write( "{\n" )
+  for record in image.records:
+    values = "{ %d, %d, %d }" % record[3]
+    sys.stdout.write( "    { %s, %s, %s, %s },\n" % ( record[0], quote( record[1] ), quote( record[2] ), values ) )
+  sys.stdout.write( "};\n" )
+  sys.stdout.write( "\n" )
+  sys.stdout.write( "const int FML_IMAGE_INTERNAL_LIBRARY_LENGTH = sizeof( FML_IMAGE_INTERNAL_LIBRARY ) / sizeof( LibraryImageRecord );\n" )
+
+processFile( sys.argv[1] )
@@ -0,0 +1,592 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "EnsembleMembers.h"
+#include "FieldmlSession.h"
+#include "fieldml_structs.h"
+#include "string_const.h"
+#include "Util.h"
+
+using namespace std;
+
+/**
+ * Reads whitespace (or otherwise) separated integers from plain-text array data, in the same way as the
+ * IO library's text reader.
+ */
+class IntScanner
+{
+private:
+    const char *current;
+    
+    const char * const end;
+    
+    bool outOfRange;
+    
+public:
+    IntScanner( const string &text ) :
+        current( text.data() ), end( text.data() + text.size() ), outOfRange( false ) {}
+    
+    bool skipLines( int lineCount )
+    {
+        while( ( lineCount > 0 ) && ( current < end ) )
+        {
+            if( *current++ == '\n' )
+            {
+                lineCount--;
+            }
+        }
+        
+        return lineCount == 0;
+    }
+    
+    bool read( FmlEnsembleValue &value )
+    {
+        bool negative = false;
+        while( ( current < end ) && ( ( *current < '0' ) || ( *current > '9' ) ) )
+        {
+            negative = ( *current == '-' );
+            current++;
+        }
+        
+        if( current == end )
+        {
+            return false;
+        }
+        
+        //NOTE: Accumulation stops once the value is out of range, so that long digit strings cannot overflow.
+        int64_t magnitude = 0;
+        while( ( current < end ) && ( *current >= '0' ) && ( *current <= '9' ) )
+        {
+            if( magnitude <= INT_MAX )
+            {
+                magnitude = ( magnitude * 10 ) + ( *current - '0' );
+            }
+            current++;
+        }
+        
+        if( magnitude > (int64_t)INT_MAX + ( negative ? 1 : 0 ) )
+        {
+            outOfRange = true;
+            magnitude = 0;
+        }
+        
+        value = (FmlEnsembleValue)( negative ? -magnitude : magnitude );
+        
+        return true;
+    }
+    
+    /**
+     * \return True if any value read so far did not fit in an ensemble value.
+     */
+    bool isOutOfRange() const
+    {
+        return outOfRange;
+    }
+    
+    bool skip( int64_t count )
+    {
+        FmlEnsembleValue value;
+        for( int64_t i = 0; i < count; i++ )
+        {
+            if( !read( value ) )
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+};
+
+
+/**
+ * Reads the given ensemble's member data as a list of entries, each consisting of the given number of values.
+ * Only plain-text array data can be read here, as the core library has no access to other formats.
+ */
+static bool readMemberData( FieldmlSession *session, EnsembleType *ensemble, int width, vector<FmlEnsembleValue> &values )
+{
+    FieldmlObject *object = session->getObject( ensemble->dataSource );
+    if( ( object == NULL ) || ( object->objectType != FHT_DATA_SOURCE ) || ( ( (DataSource*)object )->sourceType != FML_DATA_SOURCE_ARRAY ) )
+    {
+        session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensemble->dataSource, "Cannot decode ensemble members. Must be an array data source." );
+        return false;
+    }
+    
+    ArrayDataSource *source = (ArrayDataSource*)object;
+    DataResource *resource = source->resource;
+    if( resource->format != PLAIN_TEXT_NAME )
+    {
+        session->setError( FML_ERR_UNSUPPORTED, ensemble->dataSource, "Cannot decode ensemble members. Only plain-text member data is supported." );
+        return false;
+    }
+    
+    if( ( source->rank != 1 ) && ( source->rank != 2 ) )
+    {
+        session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensemble->dataSource, "Cannot decode ensemble members. Member data must have rank 1 or 2." );
+        return false;
+    }
+    
+    int64_t offsets[2] = { 0, 0 };
+    int64_t sizes[2] = { 0, width };
+    int64_t rawSizes[2] = { 0, width };
+    for( int i = 0; i < source->rank; i++ )
+    {
+        offsets[i] = source->offsets[i];
+        sizes[i] = source->sizes[i];
+        rawSizes[i] = source->rawSizes[i];
+        if( sizes[i] == 0 )
+        {
+            //NOTE: Intentional. If the array-source size has not been set, use the underlying size.
+            sizes[i] = ( rawSizes[i] == 0 ) ? 0 : rawSizes[i] - offsets[i];
+        }
+    }
+    
+    if( ( sizes[1] != width ) || ( rawSizes[1] < offsets[1] + sizes[1] ) )
+    {
+        session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensemble->dataSource, "Cannot decode ensemble members. Member data has the wrong shape." );
+        return false;
+    }
+    
+    string fileText;
+    if( resource->resourceType == FML_DATA_RESOURCE_HREF )
+    {
+        const string root = ( session->region != NULL ) ? session->region->getRoot() : "";
+        ifstream file( makeFilename( root, resource->description ).c_str(), ios::in | ios::binary );
+        ostringstream contents;
+        if( !file || !( contents << file.rdbuf() ) )
+        {
+            session->setError( FML_ERR_READ_ERR, ensemble->dataSource, "Cannot decode ensemble members. Could not read member data." );
+            return false;
+        }
+        fileText = contents.str();
+    }
+    const string &text = ( resource->resourceType == FML_DATA_RESOURCE_HREF ) ? fileText : resource->description;
+    
+    IntScanner scanner( text );
+    
+    istringstream location( source->location );
+    int lineNumber;
+    if( !( location >> lineNumber ) || !scanner.skipLines( lineNumber - 1 ) || !scanner.skip( offsets[0] * rawSizes[1] ) )
+    {
+        session->setError( FML_ERR_READ_ERR, ensemble->dataSource, "Cannot decode ensemble members. Invalid member data location." );
+        return false;
+    }
+    
+    //NOTE: If no size is known, entries are read until the data runs out.
+    bool readToEnd = ( sizes[0] == 0 );
+    
+    //NOTE: The declared size is not trusted for the reservation, as each value takes at least two characters of
+    //member data (including its separator).
+    int64_t maximumEntries = ( ( (int64_t)text.length() + 1 ) / 2 ) / width;
+    if( sizes[0] > 0 )
+    {
+        values.reserve( (size_t)( ( ( sizes[0] < maximumEntries ) ? sizes[0] : maximumEntries ) * width ) );
+    }
+    for( int64_t entry = 0; readToEnd || ( entry < sizes[0] ); entry++ )
+    {
+        FmlEnsembleValue value;
+        if( !scanner.skip( offsets[1] ) || !scanner.read( value ) )
+        {
+            if( readToEnd && ( offsets[1] == 0 ) )
+            {
+                break;
+            }
+            session->setError( FML_ERR_READ_ERR, ensemble->dataSource, "Cannot decode ensemble members. Unexpected end of member data." );
+            return false;
+        }
+        
+        values.push_back( value );
+        for( int i = 1; i < width; i++ )
+        {
+            if( !scanner.read( value ) )
+            {
+                session->setError( FML_ERR_READ_ERR, ensemble->dataSource, "Cannot decode ensemble members. Unexpected end of member data." );
+                return false;
+            }
+            values.push_back( value );
+        }
+        
+        scanner.skip( rawSizes[1] - ( offsets[1] + width ) );
+    }
+    
+    if( scanner.isOutOfRange() )
+    {
+        session->setError( FML_ERR_READ_ERR, ensemble->dataSource, "Cannot decode ensemble members. Member data value out of range." );
+        return false;
+    }
+    
+    return true;
+}
+
+
+EnsembleMembers::EnsembleMembers() :
+    count( 0 ),
+    indexed( false ),
+    indexBase( 0 ),
+    hashShift( 0 )
+{
+}
+
+
+bool EnsembleMembers::addRange( FmlEnsembleValue min, FmlEnsembleValue max, int stride )
+{
+    int64_t rangeCount = ( ( (int64_t)max - min ) / stride ) + 1;
+    if( rangeCount > INT_MAX - count )
+    {
+        return false;
+    }
+    
+    if( !runs.empty() )
+    {
+        Run &last = runs.back();
+        int64_t gap = (int64_t)min - last.first;
+        
+        //NOTE: A single-member run can take on whatever stride continues it.
+        if( ( last.count == 1 ) && ( gap > 0 ) && ( gap <= INT_MAX ) && ( ( rangeCount == 1 ) || ( gap == stride ) ) )
+        {
+            last.stride = (int)gap;
+        }
+        
+        if( ( gap == (int64_t)last.stride * last.count ) && ( ( rangeCount == 1 ) || ( last.stride == stride ) ) )
+        {
+            last.count += (int)rangeCount;
+            count += (int)rangeCount;
+            return true;
+        }
+    }
+    
+    Run run;
+    run.first = min;
+    run.stride = stride;
+    run.count = (int)rangeCount;
+    run.start = count;
+    runs.push_back( run );
+    
+    count += (int)rangeCount;
+    
+    return true;
+}
+
+
+bool EnsembleMembers::addMember( FmlEnsembleValue value )
+{
+    return addRange( value, value, 1 );
+}
+
+
+size_t EnsembleMembers::findRun( int position ) const
+{
+    size_t low = 0;
+    size_t high = runs.size();
+    
+    //NOTE: Finds the last run starting at or before the given position.
+    while( high - low > 1 )
+    {
+        size_t middle = ( low + high ) / 2;
+        if( runs[middle].start <= position )
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    
+    return low;
+}
+
+
+int EnsembleMembers::getCount() const
+{
+    return count;
+}
+
+
+FmlEnsembleValue EnsembleMembers::getMember( int position ) const
+{
+    const Run &run = runs[findRun( position )];
+    
+    return run.first + ( run.stride * ( position - run.start ) );
+}
+
+
+int EnsembleMembers::getMembers( int position, FmlEnsembleValue *buffer, int capacity ) const
+{
+    if( ( position < 0 ) || ( position >= count ) )
+    {
+        return 0;
+    }
+    
+    int copied = 0;
+    for( size_t r = findRun( position ); ( r < runs.size() ) && ( copied < capacity ); r++ )
+    {
+        const Run &run = runs[r];
+        int index = ( position + copied ) - run.start;
+        FmlEnsembleValue value = run.first + ( run.stride * index );
+        
+        for( ; ( index < run.count ) && ( copied < capacity ); index++ )
+        {
+            buffer[copied++] = value;
+            value += run.stride;
+        }
+    }
+    
+    return copied;
+}
+
+
+bool EnsembleMembers::isIndexed() const
+{
+    return indexed;
+}
+
+
+size_t EnsembleMembers::hashSlot( FmlEnsembleValue value ) const
+{
+    //NOTE: Fibonacci hashing. The multiplication scatters consecutive values, and the top bits are the best mixed.
+    return (size_t)( ( (uint32_t)value * 2654435769U ) >> hashShift );
+}
+
+
+void EnsembleMembers::buildIndex()
+{
+    indexed = true;
+    
+    if( runs.size() <= 1 )
+    {
+        return;
+    }
+    
+    FmlEnsembleValue min = runs[0].first;
+    FmlEnsembleValue max = runs[0].first;
+    for( vector<Run>::const_iterator i = runs.begin(); i != runs.end(); i++ )
+    {
+        FmlEnsembleValue last = i->first + ( i->stride * ( i->count - 1 ) );
+        min = ( i->first < min ) ? i->first : min;
+        max = ( last > max ) ? last : max;
+    }
+    
+    //NOTE: Duplicated members keep their first position.
+    if( (int64_t)max - min < 2 * (int64_t)count )
+    {
+        indexBase = min;
+        directIndex.assign( (size_t)( max - min ) + 1, -1 );
+        for( vector<Run>::const_iterator i = runs.begin(); i != runs.end(); i++ )
+        {
+            for( int j = 0; j < i->count; j++ )
+            {
+                int &position = directIndex[( i->first + ( i->stride * j ) ) - indexBase];
+                if( position < 0 )
+                {
+                    position = i->start + j;
+                }
+            }
+        }
+        return;
+    }
+    
+    //NOTE: Keeping the table at most half full keeps probe sequences short.
+    size_t capacity = 2;
+    hashShift = 31;
+    while( capacity < 2 * (size_t)count )
+    {
+        capacity *= 2;
+        hashShift--;
+    }
+    
+    IndexEntry empty;
+    empty.value = 0;
+    empty.position = -1;
+    hashIndex.assign( capacity, empty );
+    for( vector<Run>::const_iterator i = runs.begin(); i != runs.end(); i++ )
+    {
+        for( int j = 0; j < i->count; j++ )
+        {
+            FmlEnsembleValue value = i->first + ( i->stride * j );
+            size_t slot = hashSlot( value );
+            while( ( hashIndex[slot].position >= 0 ) && ( hashIndex[slot].value != value ) )
+            {
+                slot = ( slot + 1 ) & ( capacity - 1 );
+            }
+            if( hashIndex[slot].position < 0 )
+            {
+                hashIndex[slot].value = value;
+                hashIndex[slot].position = i->start + j;
+            }
+        }
+    }
+}
+
+
+int EnsembleMembers::getPosition( FmlEnsembleValue value ) const
+{
+    if( runs.size() == 1 )
+    {
+        const Run &run = runs[0];
+        int64_t offset = (int64_t)value - run.first;
+        if( ( offset < 0 ) || ( offset % run.stride != 0 ) || ( offset / run.stride >= run.count ) )
+        {
+            return -1;
+        }
+        return (int)( offset / run.stride );
+    }
+    
+    if( !directIndex.empty() )
+    {
+        int64_t offset = (int64_t)value - indexBase;
+        if( ( offset < 0 ) || ( offset >= (int64_t)directIndex.size() ) )
+        {
+            return -1;
+        }
+        return directIndex[(size_t)offset];
+    }
+    
+    if( hashIndex.empty() )
+    {
+        return -1;
+    }
+    
+    for( size_t slot = hashSlot( value ); hashIndex[slot].position >= 0; slot = ( slot + 1 ) & ( hashIndex.size() - 1 ) )
+    {
+        if( hashIndex[slot].value == value )
+        {
+            return hashIndex[slot].position;
+        }
+    }
+    
+    return -1;
+}
+
+
+size_t EnsembleMembers::getMemoryUsage() const
+{
+    return sizeof( EnsembleMembers ) + FmlUtil::memoryUsage( runs ) + FmlUtil::memoryUsage( directIndex ) + FmlUtil::memoryUsage( hashIndex );
+}
+
+
+EnsembleMembers *EnsembleMembers::create( FieldmlSession *session, FmlObjectHandle ensembleHandle )
+{
+    EnsembleType *ensemble = (EnsembleType*)session->getObject( ensembleHandle );
+    
+    int width;
+    switch( ensemble->membersType )
+    {
+    case FML_ENSEMBLE_MEMBER_RANGE:
+        width = 0;
+        break;
+    case FML_ENSEMBLE_MEMBER_LIST_DATA:
+        width = 1;
+        break;
+    case FML_ENSEMBLE_MEMBER_RANGE_DATA:
+        width = 2;
+        break;
+    case FML_ENSEMBLE_MEMBER_STRIDE_RANGE_DATA:
+        width = 3;
+        break;
+    default:
+        session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensembleHandle, "Cannot decode ensemble members. Members have not been defined." );
+        return NULL;
+    }
+    
+    EnsembleMembers *members = new EnsembleMembers();
+    
+    if( width == 0 )
+    {
+        if( !members->addRange( ensemble->min, ensemble->max, ensemble->stride ) )
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensembleHandle, "Cannot decode ensemble members. Too many members." );
+            delete members;
+            return NULL;
+        }
+        return members;
+    }
+    
+    vector<FmlEnsembleValue> values;
+    if( !readMemberData( session, ensemble, width, values ) )
+    {
+        delete members;
+        return NULL;
+    }
+    
+    for( size_t i = 0; i < values.size(); i += width )
+    {
+        bool added;
+        if( width == 1 )
+        {
+            added = members->addMember( values[i] );
+        }
+        else
+        {
+            int stride = ( width == 3 ) ? values[i + 2] : 1;
+            if( ( values[i] > values[i + 1] ) || ( stride < 1 ) )
+            {
+                session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensembleHandle, "Cannot decode ensemble members. Invalid member range." );
+                delete members;
+                return NULL;
+            }
+            added = members->addRange( values[i], values[i + 1], stride );
+        }
+        
+        if( !added )
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensembleHandle, "Cannot decode ensemble members. Too many members." );
+            delete members;
+            return NULL;
+        }
+    }
+    
+    if( members->count != ensemble->count )
+    {
+        session->setError( FML_ERR_MISCONFIGURED_OBJECT, ensembleHandle, "Cannot decode ensemble members. Member data does not match the member count." );
+        delete members;
+        return NULL;
+    }
+    
+    vector<Run>( members->runs ).swap( members->runs );
+    
+    return members;
+}
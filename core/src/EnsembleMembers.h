@@ -0,0 +1,152 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_ENSEMBLE_MEMBERS
+#define H_ENSEMBLE_MEMBERS
+
+#include <cstddef>
+#include <vector>
+
+#include "fieldml_api.h"
+
+class FieldmlSession;
+
+/**
+ * The decoded members of an ensemble, stored as runs of evenly spaced values. Ranges decode to a
+ * single run each, and sorted member lists collapse into a handful of runs, so even very large
+ * ensembles take little memory and can be iterated without any per-member lookups.
+ */
+class EnsembleMembers
+{
+private:
+    struct Run
+    {
+        FmlEnsembleValue first;
+        
+        int stride;
+        
+        int count;
+        
+        /**
+         * The position of this run's first member in the ensemble.
+         */
+        int start;
+    };
+    
+    struct IndexEntry
+    {
+        FmlEnsembleValue value;
+        
+        int position;
+    };
+    
+    std::vector<Run> runs;
+    
+    int count;
+    
+    bool indexed;
+    
+    /**
+     * Positions of the members, indexed by value - indexBase, with -1 for non-members. Used when the members are dense.
+     */
+    std::vector<int> directIndex;
+    
+    FmlEnsembleValue indexBase;
+    
+    /**
+     * An open-addressed hash table of member positions, used when the members are too sparse for a direct index.
+     */
+    std::vector<IndexEntry> hashIndex;
+    
+    unsigned int hashShift;
+    
+    size_t hashSlot( FmlEnsembleValue value ) const;
+    
+    size_t findRun( int position ) const;
+    
+    EnsembleMembers();
+    
+    /**
+     * \return False if the ensemble would have more members than can be counted.
+     */
+    bool addRange( FmlEnsembleValue min, FmlEnsembleValue max, int stride );
+    
+    bool addMember( FmlEnsembleValue value );
+    
+public:
+    int getCount() const;
+    
+    /**
+     * \return The member at the given zero-based position. The position must be valid.
+     */
+    FmlEnsembleValue getMember( int position ) const;
+    
+    /**
+     * Copies at most capacity members, starting at the given zero-based position, into the given buffer.
+     * 
+     * \return The number of members copied.
+     */
+    int getMembers( int position, FmlEnsembleValue *buffer, int capacity ) const;
+    
+    bool isIndexed() const;
+    
+    /**
+     * Builds the value-to-position index used by getPosition. Members forming a single run need no index, as their
+     * positions can be computed directly.
+     */
+    void buildIndex();
+    
+    /**
+     * \return The zero-based position of the given member, or -1 if it is not a member. The index must have been built.
+     */
+    int getPosition( FmlEnsembleValue value ) const;
+    
+    size_t getMemoryUsage() const;
+    
+    /**
+     * Decodes the members of the given ensemble type, reading its member data source if it has one.
+     * 
+     * \return The decoded members, or NULL if they could not be decoded, in which case the session's error is set.
+     */
+    static EnsembleMembers *create( FieldmlSession *session, FmlObjectHandle ensembleHandle );
+};
+
+#endif //H_ENSEMBLE_MEMBERS
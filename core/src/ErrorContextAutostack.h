@@ -58,11 +58,30 @@ private:
     FieldmlSession *errorSession;
     
 public:
-    ErrorContextAutostack( FieldmlSession *_errorSession, const char *file, const int line, const char *function );
+    ErrorContextAutostack( FieldmlSession *_errorSession, const char *file, const int line, const char *function ) :
+        errorSession( _errorSession )
+    {
+        if( errorSession != NULL )
+        {
+            errorSession->pushErrorContext( file, line, function );
+        }
+    }
     
-    ~ErrorContextAutostack();
+    
+    ~ErrorContextAutostack()
+    {
+        if( errorSession != NULL )
+        {
+            errorSession->popErrorContext();
+        }
+    }
 };
 
+#if defined FIELDML_NO_ERROR_CONTEXT
+//Error reports will not include the API call stack.
+#define ERROR_AUTOSTACK( errorHandler )
+#else
 #define ERROR_AUTOSTACK( errorHandler ) ErrorContextAutostack _tracer( errorHandler, __FILE__, __LINE__, __ECA_FUNC__ )
+#endif
 
 #endif //H_ERROR_CONTEXT_AUTOSTACK
@@ -42,6 +42,7 @@
 #include "string_const.h"
 #include "Evaluators.h"
 #include "ErrorContextAutostack.h"
+#include "Util.h"
 
 using namespace std;
 
@@ -66,7 +67,7 @@ template <typename T> T *checkedCast(FieldmlSession *session, const FmlObjectHan
 
 } //End namespace EvaluatorsUtil
 
-Evaluator::Evaluator( const string _name, FieldmlHandleType _type, FmlObjectHandle _valueType, bool _isVirtual ) :
+Evaluator::Evaluator( const InternedName &_name, FieldmlHandleType _type, FmlObjectHandle _valueType, bool _isVirtual ) :
     FieldmlObject( _name, _type, _isVirtual ),
     valueType( _valueType )
 {
@@ -96,13 +97,19 @@ Evaluator *Evaluator::checkedCast( FieldmlSession *session, FmlObjectHandle obje
 }
 
 
-ConstantEvaluator::ConstantEvaluator( const string _name, const string _valueString, FmlObjectHandle _valueType ) :
+ConstantEvaluator::ConstantEvaluator( const InternedName &_name, const string _valueString, FmlObjectHandle _valueType ) :
     Evaluator( _name, FHT_CONSTANT_EVALUATOR, _valueType, false ),
     valueString( _valueString )
 {
 }
 
 
+FieldmlObject *ConstantEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ConstantEvaluator( *this );
+}
+
+
 bool ConstantEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     return false;
@@ -115,7 +122,7 @@ ConstantEvaluator *ConstantEvaluator::checkedCast( FieldmlSession *session, FmlO
 }
 
 
-ReferenceEvaluator::ReferenceEvaluator( const string _name, FmlObjectHandle _evaluator, FmlObjectHandle _valueType, bool _isVirtual ) :
+ReferenceEvaluator::ReferenceEvaluator( const InternedName &_name, FmlObjectHandle _evaluator, FmlObjectHandle _valueType, bool _isVirtual ) :
     Evaluator( _name, FHT_REFERENCE_EVALUATOR, _valueType, _isVirtual ),
     sourceEvaluator( _evaluator ),
     binds( FML_INVALID_HANDLE )
@@ -123,6 +130,18 @@ ReferenceEvaluator::ReferenceEvaluator( const string _name, FmlObjectHandle _eva
 }
 
 
+FieldmlObject *ReferenceEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ReferenceEvaluator( *this );
+}
+
+
+size_t ReferenceEvaluator::getContentSize() const
+{
+    return binds.getMemoryUsage();
+}
+
+
 bool ReferenceEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     delegates.insert( sourceEvaluator );
@@ -140,12 +159,24 @@ ReferenceEvaluator *ReferenceEvaluator::checkedCast( FieldmlSession *session, Fm
 }
 
 
-ArgumentEvaluator::ArgumentEvaluator( const string _name, FmlObjectHandle _valueType, bool _isVirtual ) :
+ArgumentEvaluator::ArgumentEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual ) :
     Evaluator( _name, FHT_ARGUMENT_EVALUATOR, _valueType, _isVirtual )
 {
 }
 
 
+FieldmlObject *ArgumentEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ArgumentEvaluator( *this );
+}
+
+
+size_t ArgumentEvaluator::getContentSize() const
+{
+    return FmlUtil::memoryUsage( arguments );
+}
+
+
 bool ArgumentEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     return false;
@@ -158,12 +189,24 @@ ArgumentEvaluator *ArgumentEvaluator::checkedCast( FieldmlSession *session, FmlO
 }
 
 
-ExternalEvaluator::ExternalEvaluator( const string _name, FmlObjectHandle _valueType, bool _isVirtual ) :
+ExternalEvaluator::ExternalEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual ) :
     Evaluator( _name, FHT_EXTERNAL_EVALUATOR, _valueType, _isVirtual )
 {
 }
 
 
+FieldmlObject *ExternalEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ExternalEvaluator( *this );
+}
+
+
+size_t ExternalEvaluator::getContentSize() const
+{
+    return FmlUtil::memoryUsage( arguments );
+}
+
+
 bool ExternalEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     return false;
@@ -176,10 +219,25 @@ ExternalEvaluator *ExternalEvaluator::checkedCast( FieldmlSession *session, FmlO
 }
 
 
-ParameterEvaluator::ParameterEvaluator( const string _name, FmlObjectHandle _valueType, bool _isVirtual ) :
+ParameterEvaluator::ParameterEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual, ObjectArena &arena ) :
     Evaluator( _name, FHT_PARAMETER_EVALUATOR, _valueType, _isVirtual )
 {
-    dataDescription = new UnknownDataDescription();
+    dataDescription = new( arena ) UnknownDataDescription();
+}
+
+
+FieldmlObject *ParameterEvaluator::clone( ObjectArena &arena ) const
+{
+    ParameterEvaluator *copy = new( arena ) ParameterEvaluator( *this );
+    copy->dataDescription = dataDescription->clone( arena );
+    
+    return copy;
+}
+
+
+size_t ParameterEvaluator::getContentSize() const
+{
+    return dataDescription->getContentSize();
 }
 
 
@@ -203,7 +261,7 @@ ParameterEvaluator *ParameterEvaluator::checkedCast( FieldmlSession *session, Fm
 }
 
 
-PiecewiseEvaluator::PiecewiseEvaluator( const string _name, FmlObjectHandle _valueType, bool _isVirtual ) :
+PiecewiseEvaluator::PiecewiseEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual ) :
     Evaluator( _name, FHT_PIECEWISE_EVALUATOR, _valueType, _isVirtual ),
     binds( FML_INVALID_HANDLE ),
     evaluators( FML_INVALID_HANDLE ),
@@ -212,6 +270,18 @@ PiecewiseEvaluator::PiecewiseEvaluator( const string _name, FmlObjectHandle _val
 }
 
 
+FieldmlObject *PiecewiseEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) PiecewiseEvaluator( *this );
+}
+
+
+size_t PiecewiseEvaluator::getContentSize() const
+{
+    return binds.getMemoryUsage() + evaluators.getMemoryUsage();
+}
+
+
 bool PiecewiseEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     const set<FmlObjectHandle> &evaluatorValues = evaluators.getValues();
@@ -232,7 +302,7 @@ PiecewiseEvaluator *PiecewiseEvaluator::checkedCast( FieldmlSession *session, Fm
 }
 
 
-AggregateEvaluator::AggregateEvaluator( const string _name, FmlObjectHandle _valueType, bool _isVirtual ) :
+AggregateEvaluator::AggregateEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual ) :
     Evaluator( _name, FHT_AGGREGATE_EVALUATOR, _valueType, _isVirtual ),
     binds( FML_INVALID_HANDLE ),
     evaluators( FML_INVALID_HANDLE ),
@@ -241,6 +311,18 @@ AggregateEvaluator::AggregateEvaluator( const string _name, FmlObjectHandle _val
 }
 
 
+FieldmlObject *AggregateEvaluator::clone( ObjectArena &arena ) const
+{
+    return new( arena ) AggregateEvaluator( *this );
+}
+
+
+size_t AggregateEvaluator::getContentSize() const
+{
+    return binds.getMemoryUsage() + evaluators.getMemoryUsage();
+}
+
+
 bool AggregateEvaluator::addDelegates( set<FmlObjectHandle> &delegates )
 {
     const set<FmlObjectHandle> &evaluatorValues = evaluators.getValues();
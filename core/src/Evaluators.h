@@ -57,7 +57,7 @@ class Evaluator :
 public:
     const FmlObjectHandle valueType;
 
-    Evaluator( const std::string _name, FieldmlHandleType _type, FmlObjectHandle _valueType, bool _isVirtual );
+    Evaluator( const InternedName &_name, FieldmlHandleType _type, FmlObjectHandle _valueType, bool _isVirtual );
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates ) = 0;
     
@@ -71,7 +71,9 @@ class ConstantEvaluator :
 public:
     const std::string valueString;
     
-    ConstantEvaluator( const std::string _name, const std::string _literal, FmlObjectHandle _valueType );
+    ConstantEvaluator( const InternedName &_name, const std::string _literal, FmlObjectHandle _valueType );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -87,7 +89,11 @@ public:
 
     SimpleMap<FmlObjectHandle, FmlObjectHandle> binds;
 
-    ReferenceEvaluator( const std::string _name, FmlObjectHandle _evaluator, FmlObjectHandle _valueType, bool _isVirtual );
+    ReferenceEvaluator( const InternedName &_name, FmlObjectHandle _evaluator, FmlObjectHandle _valueType, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -104,7 +110,11 @@ public:
     SimpleMap<FmlObjectHandle, FmlObjectHandle> binds;
     SimpleMap<FmlEnsembleValue, FmlObjectHandle> evaluators;
     
-    PiecewiseEvaluator( const std::string name, FmlObjectHandle valueType, bool _isVirtual );
+    PiecewiseEvaluator( const InternedName &_name, FmlObjectHandle valueType, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -121,7 +131,11 @@ public:
     
     FmlObjectHandle indexEvaluator;
     
-    AggregateEvaluator( const std::string _name, FmlObjectHandle _valueType, bool _isVirtual );
+    AggregateEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -135,7 +149,11 @@ class ArgumentEvaluator :
 public:
     std::set<FmlObjectHandle> arguments;
     
-    ArgumentEvaluator( const std::string name, FmlObjectHandle _valueType, bool _isVirtual );
+    ArgumentEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -149,7 +167,11 @@ class ExternalEvaluator :
 public:
     std::set<FmlObjectHandle> arguments;
     
-    ExternalEvaluator( const std::string name, FmlObjectHandle _valueType, bool _isVirtual );
+    ExternalEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -163,7 +185,11 @@ class ParameterEvaluator :
 public:
     BaseDataDescription *dataDescription;
     
-    ParameterEvaluator( const std::string _name, FmlObjectHandle _valueType, bool _isVirtual );
+    ParameterEvaluator( const InternedName &_name, FmlObjectHandle _valueType, bool _isVirtual, ObjectArena &arena );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
     
     virtual bool addDelegates( std::set<FmlObjectHandle> &delegates );
     
@@ -39,6 +39,7 @@
  *
  */
 
+#include <climits>
 #include <cstring>
 #include <cstdio>
 #include <vector>
@@ -54,7 +55,9 @@
 #include "Util.h"
 #include "String_InternalLibrary.h"
 #include "String_InternalXSD.h"
+#include "StringTable.h"
 #include "string_const.h"
+#include "ThreadSupport.h"
 
 #include "FieldmlDOM.h"
 
@@ -62,12 +65,48 @@ using namespace std;
 
 //========================================================================
 
+enum ObjectNodeState
+{
+    OBJECT_NODE_UNPARSED,
+    OBJECT_NODE_PARSING,
+    OBJECT_NODE_PARSED
+};
+
+
+/**
+ * An object element read from the document. Each object is parsed when it is first referred to, or else in document
+ * order once the whole document has been read.
+ */
+struct ObjectNode
+{
+    xmlNodePtr node;
+    
+    ObjectNodeState state;
+    
+    ObjectNode( xmlNodePtr _node ) :
+        node( _node ), state( OBJECT_NODE_UNPARSED ) {}
+};
+
+
 struct ParseState
 {
     FmlSessionHandle session;
     FieldmlErrorHandler *errorHandler;
-    vector<xmlNodePtr> parseStack;
-    vector<xmlNodePtr> unparsedNodes;
+    
+    //NOTE: Held in document order.
+    vector<ObjectNode> objectNodes;
+    
+    /**
+     * The index in objectNodes of the object with each name, indexed by the name's id in objectNames.
+     */
+    StringTable objectNames;
+    vector<int> objectNodesByName;
+    
+    /**
+     * True if the document has not been validated against the schema, and its structure must be checked as it is
+     * parsed.
+     */
+    bool checkStructure;
     
     //14102011 CPL Currently, mesh shapes depends on an evaluator which typically depends on mesh-argument which depends on mesh.
     //To work around this cyclic dependency, the shapes attribute is analysed after rest of the document has been parsed.
@@ -113,38 +152,51 @@ static void addContextError( void *context, const char *msg, ... )
 
 //========================================================================
 
-static int validate( FieldmlErrorHandler *errorHandler, xmlParserInputBufferPtr buffer, const char *resourceName )
-{
-    xmlSchemaPtr schemas = NULL;
-    xmlSchemaParserCtxtPtr sctxt;
-    xmlSchemaValidCtxtPtr vctxt;
-    
-    LIBXML_TEST_VERSION
+static Mutex schemaLock;
 
-    xmlSubstituteEntitiesDefault( 1 );
+static xmlSchemaPtr compiledSchema = NULL;
 
-    if( buffer == NULL )
-    {
-        return 1;
-    }
 
-    sctxt = xmlSchemaNewMemParserCtxt( FML_STRING_FIELDML_XSD, strlen( FML_STRING_FIELDML_XSD ) );
-    xmlSchemaSetParserErrors( sctxt, (xmlSchemaValidityErrorFunc)addContextError, (xmlSchemaValidityWarningFunc)addContextError, errorHandler );
-    schemas = xmlSchemaParse( sctxt );
-    if( schemas == NULL )
+/**
+ * \return The internal FieldML schema, compiling it on first use. The compiled schema is shared by all sessions and
+ * threads, as libxml2 only reads it during validation, and is kept for the lifetime of the process.
+ */
+static xmlSchemaPtr getSchema( FieldmlErrorHandler *errorHandler )
+{
+    MutexGuard guard( schemaLock );
+    
+    //NOTE: The schema imports the xlink schema by URL, so a failure to compile it may be transient, and is not cached.
+    if( compiledSchema == NULL )
     {
-        xmlGenericError( xmlGenericErrorContext, "Internal schema failed to compile\n" );
+        xmlSchemaParserCtxtPtr sctxt = xmlSchemaNewMemParserCtxt( FML_STRING_FIELDML_XSD, strlen( FML_STRING_FIELDML_XSD ) );
+        xmlSchemaSetParserErrors( sctxt, (xmlSchemaValidityErrorFunc)addContextError, (xmlSchemaValidityWarningFunc)addContextError, errorHandler );
+        compiledSchema = xmlSchemaParse( sctxt );
+        if( compiledSchema == NULL )
+        {
+            xmlGenericError( xmlGenericErrorContext, "Internal schema failed to compile\n" );
+        }
+        xmlSchemaFreeParserCtxt( sctxt );
     }
-    xmlSchemaFreeParserCtxt( sctxt );
+    
+    return compiledSchema;
+}
+
 
-    vctxt = xmlSchemaNewValidCtxt( schemas );
+/**
+ * Validates an already-parsed document, so that the document's text is only read and tokenized once.
+ */
+static int validate( FieldmlErrorHandler *errorHandler, xmlDocPtr doc, const char *resourceName )
+{
+    xmlSchemaValidCtxtPtr vctxt;
+    
+    vctxt = xmlSchemaNewValidCtxt( getSchema( errorHandler ) );
     xmlSchemaSetValidErrors( vctxt, (xmlSchemaValidityErrorFunc)addContextError, (xmlSchemaValidityWarningFunc)addContextError, errorHandler );
 
-    int result = xmlSchemaValidateStream( vctxt, buffer, (xmlCharEncoding)0, NULL, NULL );
+    //NOTE: libxml's last error is per-thread, and would otherwise still hold errors from previous documents.
+    xmlResetLastError();
+    int result = xmlSchemaValidateDoc( vctxt, doc );
 
     xmlSchemaFreeValidCtxt( vctxt );
-
-    xmlSchemaFree( schemas );
     
     xmlErrorPtr err = xmlGetLastError();
     if( ( err != NULL ) && ( err->message != NULL ) )
@@ -160,11 +212,221 @@ static int validate( FieldmlErrorHandler *errorHandler, xmlParserInputBufferPtr
 }
 
 
+/**
+ * Logs the reason the given parser context failed to produce a document.
+ */
+static void logParseError( FieldmlErrorHandler *errorHandler, xmlParserCtxtPtr ctxt, const char *error, const char *resourceName )
+{
+    string errorMessage = error;
+    errorMessage += ": ";
+    errorMessage += resourceName;
+    
+    xmlErrorPtr err = xmlCtxtGetLastError( ctxt );
+    if( ( err != NULL ) && ( err->message != NULL ) )
+    {
+        errorMessage += ": ";
+        errorMessage += err->message;
+        //libxml likes to put \n at the end of its error messages
+        if( errorMessage[errorMessage.length() - 1] == '\n' )
+        {
+            errorMessage.erase( errorMessage.length() - 1 );
+        }
+    }
+    
+    errorHandler->logError( errorMessage );
+}
+
+
 static bool checkName( xmlNodePtr node, const xmlChar *name )
 {
     return ( strcmp( ( char*)node->name, (char*)name ) == 0 );
 }
 
+//========================================================================
+
+/**
+ * The subset of the schema's rules for an element that the parser relies on. Names are space-separated, and a
+ * rule with a parent only applies to elements with that parent.
+ */
+struct ElementRule
+{
+    const char *name;
+    const char *parent;
+    const char *requiredAttributes;
+    const char *requiredChildren;
+    const char *optionalChildren;
+};
+
+
+//NOTE: Rules with a parent must come before the rule without one for the same element.
+static const ElementRule elementRules[] =
+{
+    { "Import", NULL, "xlink:href region", "", "ImportType ImportEvaluator" },
+    { "ImportType", NULL, "localName remoteName", "", "" },
+    { "ImportEvaluator", NULL, "localName remoteName", "", "" },
+    { "DataResource", NULL, "name", "DataResourceDescription", "ArrayDataSource" },
+    { "DataResourceDescription", NULL, "", "", "DataResourceHref DataResourceString" },
+    { "DataResourceHref", NULL, "xlink:href format", "", "" },
+    { "DataResourceString", NULL, "", "", "" },
+    { "ArrayDataSource", NULL, "name location rank", "", "ArrayDataSize ArrayDataOffset RawArraySize" },
+    { "ArrayDataSize", NULL, "", "", "" },
+    { "ArrayDataOffset", NULL, "", "", "" },
+    { "RawArraySize", NULL, "", "", "" },
+    { "BooleanType", NULL, "name", "", "" },
+    { "EnsembleType", NULL, "name", "Members", "" },
+    { "Members", NULL, "", "", "MemberRange MemberListData MemberRangeData MemberStrideRangeData" },
+    { "MemberRange", NULL, "min max", "", "" },
+    { "MemberListData", NULL, "count data", "", "" },
+    { "MemberRangeData", NULL, "count data", "", "" },
+    { "MemberStrideRangeData", NULL, "count data", "", "" },
+    { "ContinuousType", NULL, "name", "", "Components" },
+    { "Components", NULL, "name count", "", "" },
+    { "MeshType", NULL, "name", "Elements Chart Shapes", "" },
+    { "Elements", NULL, "name", "Members", "" },
+    { "Chart", NULL, "name", "", "Components" },
+    { "Shapes", NULL, "evaluator", "", "" },
+    { "ArgumentEvaluator", NULL, "name valueType", "", "Arguments" },
+    { "ExternalEvaluator", NULL, "name valueType", "", "Arguments" },
+    { "Arguments", NULL, "", "", "Argument" },
+    { "Argument", NULL, "name", "", "" },
+    { "ConstantEvaluator", NULL, "name value valueType", "", "" },
+    { "ReferenceEvaluator", NULL, "name evaluator", "", "Arguments Bindings" },
+    { "Bindings", "AggregateEvaluator", "", "", "Bind BindIndex" },
+    { "Bindings", NULL, "", "", "Bind" },
+    { "Bind", NULL, "argument source", "", "" },
+    { "BindIndex", NULL, "argument indexNumber", "", "" },
+    { "PiecewiseEvaluator", NULL, "name valueType", "EvaluatorMap", "Arguments Bindings IndexEvaluators" },
+    { "EvaluatorMap", NULL, "", "", "EvaluatorMapEntry" },
+    { "EvaluatorMapEntry", NULL, "value evaluator", "", "" },
+    { "IndexEvaluators", NULL, "", "", "IndexEvaluator" },
+    { "IndexEvaluator", "IndexEvaluators", "evaluator indexNumber", "", "" },
+    { "IndexEvaluator", NULL, "evaluator", "", "" },
+    { "ParameterEvaluator", NULL, "name valueType", "", "Arguments DenseArrayData DOKArrayData" },
+    { "DenseArrayData", NULL, "data", "", "DenseIndexes" },
+    { "DOKArrayData", NULL, "keyData valueData", "SparseIndexes", "DenseIndexes" },
+    { "DenseIndexes", NULL, "", "", "IndexEvaluator" },
+    { "SparseIndexes", NULL, "", "", "IndexEvaluator" },
+    { "AggregateEvaluator", NULL, "name valueType", "ComponentEvaluators", "Arguments Bindings" },
+    { "ComponentEvaluators", NULL, "", "", "ComponentEvaluator" },
+    { "ComponentEvaluator", NULL, "component evaluator", "", "" },
+};
+
+
+static const ElementRule *getElementRule( xmlNodePtr node )
+{
+    const int ruleCount = sizeof( elementRules ) / sizeof( ElementRule );
+    for( int i = 0; i < ruleCount; i++ )
+    {
+        const ElementRule &rule = elementRules[i];
+        if( !checkName( node, (const xmlChar*)rule.name ) )
+        {
+            continue;
+        }
+        if( ( rule.parent == NULL ) || ( ( node->parent != NULL ) && checkName( node->parent, (const xmlChar*)rule.parent ) ) )
+        {
+            return &rule;
+        }
+    }
+    
+    return NULL;
+}
+
+
+/**
+ * \return The length of the first name in the given space-separated list, after skipping any leading spaces.
+ */
+static size_t nextName( const char *&names )
+{
+    names += strspn( names, " " );
+    return strcspn( names, " " );
+}
+
+
+static bool containsName( const char *names, const char *name )
+{
+    size_t nameLength = strlen( name );
+    for( size_t length = nextName( names ); length > 0; names += length, length = nextName( names ) )
+    {
+        if( ( length == nameLength ) && ( strncmp( names, name, length ) == 0 ) )
+        {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+
+static bool hasAttribute( xmlNodePtr node, const string &attribute )
+{
+    if( attribute.compare( 0, 6, "xlink:" ) == 0 )
+    {
+        return xmlHasNsProp( node, (const xmlChar*)attribute.c_str() + 6, XLINK_NAMESPACE_STRING ) != NULL;
+    }
+    
+    return xmlHasProp( node, (const xmlChar*)attribute.c_str() ) != NULL;
+}
+
+
+/**
+ * Checks that the given element, and all the elements within it, have the attributes and child elements that the
+ * parser relies on. Used in place of schema validation, so that each object is checked just before it is created.
+ */
+static int checkStructure( xmlNodePtr node, ParseState &state )
+{
+    const ElementRule *rule = getElementRule( node );
+    if( rule == NULL )
+    {
+        state.errorHandler->logError( "Unexpected element", (const char*)node->name, ( node->parent != NULL ) ? (const char*)node->parent->name : NULL );
+        return 1;
+    }
+    
+    int err = 0;
+    
+    const char *names = rule->requiredAttributes;
+    for( size_t length = nextName( names ); length > 0; names += length, length = nextName( names ) )
+    {
+        string attribute( names, length );
+        if( !hasAttribute( node, attribute ) )
+        {
+            state.errorHandler->logError( "Missing required attribute", attribute.c_str(), (const char*)node->name );
+            err = 1;
+        }
+    }
+    
+    names = rule->requiredChildren;
+    for( size_t length = nextName( names ); length > 0; names += length, length = nextName( names ) )
+    {
+        string child( names, length );
+        xmlNodePtr cur = xmlFirstElementChild( node );
+        while( ( cur != NULL ) && !checkName( cur, (const xmlChar*)child.c_str() ) )
+        {
+            cur = xmlNextElementSibling( cur );
+        }
+        if( cur == NULL )
+        {
+            state.errorHandler->logError( "Missing required element", child.c_str(), (const char*)node->name );
+            err = 1;
+        }
+    }
+    
+    for( xmlNodePtr cur = xmlFirstElementChild( node ); cur != NULL; cur = xmlNextElementSibling( cur ) )
+    {
+        const char *childName = (const char*)cur->name;
+        if( !containsName( rule->requiredChildren, childName ) && !containsName( rule->optionalChildren, childName ) )
+        {
+            state.errorHandler->logError( "Unexpected element", childName, (const char*)node->name );
+            err = 1;
+        }
+        else if( checkStructure( cur, state ) != 0 )
+        {
+            err = 1;
+        }
+    }
+    
+    return err;
+}
+
 
 const char *getStringAttribute( xmlNodePtr node, const xmlChar *attribute, const xmlChar *ns = NULL )
 {
@@ -193,7 +455,30 @@ int getIntAttribute( xmlNodePtr node, const xmlChar *attribute, int defaultValue
 }
 
 
-static int parseObjectNode( xmlNodePtr objectNode, ParseState &state );
+static int parseObjectNode( int index, ParseState &state );
+
+/**
+ * Parses the document's object with the given name, unless it has already been parsed.
+ * 
+ * \return False if the document has no object with the given name.
+ */
+static bool resolveObject( const char *objectName, ParseState &state )
+{
+    int nameId = state.objectNames.find( objectName );
+    if( nameId < 0 )
+    {
+        return false;
+    }
+    
+    int index = state.objectNodesByName[nameId];
+    if( state.objectNodes[index].state != OBJECT_NODE_PARSED )
+    {
+        parseObjectNode( index, state );
+    }
+    
+    return true;
+}
+
 
 FmlObjectHandle getObjectAttribute( xmlNodePtr node, const xmlChar *attribute, ParseState &state )
 {
@@ -203,19 +488,13 @@ FmlObjectHandle getObjectAttribute( xmlNodePtr node, const xmlChar *attribute, P
         return FML_INVALID_HANDLE;
     }
 
-    for( vector<xmlNodePtr>::iterator i = state.unparsedNodes.begin(); i != state.unparsedNodes.end(); i++ )
-    {
-        const char *nodeObjectName = getStringAttribute( *i, NAME_ATTRIB );
-        if( strcmp( objectName, nodeObjectName ) == 0 )
-        {
-            parseObjectNode( *i, state );
-            break;
-        }
-        if (nodeObjectName)
-        	xmlFree(const_cast<char *>(nodeObjectName));
-    }
+    resolveObject( objectName, state );
 
     FmlObjectHandle objectHandle = Fieldml_GetObjectByName( state.session, objectName );
+    if( ( objectHandle == FML_INVALID_HANDLE ) && state.checkStructure )
+    {
+        state.errorHandler->logError( "Unresolved object reference", objectName, (const char*)attribute );
+    }
     xmlFree(const_cast<char *>(objectName));
 
     return objectHandle;
@@ -343,12 +622,12 @@ private:
     const int rank;
     
 public:
-    int *values;
+    int64_t *values;
     
     IntVectorParser( int _rank ) :
         rank( _rank )
     {
-        values = new int[rank];
+        values = new int64_t[rank];
     }
     
     int parseNode( xmlNodePtr node, ParseState &state )
@@ -387,7 +666,7 @@ public:
     
     ~IntVectorParser()
     {
-        delete values;
+        delete[] values;
     }
 };
 
@@ -457,7 +736,7 @@ public:
                 xmlFree(const_cast<char *>(name));
                 return err;
             }
-            if( Fieldml_SetArrayDataSourceOffsets( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
+            if( Fieldml_SetArrayDataSourceOffsets64( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
             {
                 state.errorHandler->logError( "ArrayDataSource has invalid offset specification", name );
             }
@@ -473,7 +752,7 @@ public:
                 xmlFree(const_cast<char *>(name));
                 return err;
             }
-            if( Fieldml_SetArrayDataSourceSizes( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
+            if( Fieldml_SetArrayDataSourceSizes64( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
             {
                 state.errorHandler->logError( "ArrayDataSource has invalid size specification", name );
             }
@@ -489,7 +768,7 @@ public:
                 xmlFree(const_cast<char *>(name));
                 return err;
             }
-            if( Fieldml_SetArrayDataSourceRawSizes( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
+            if( Fieldml_SetArrayDataSourceRawSizes64( state.session, dataSource, vectorParser.values ) != FML_ERR_NO_ERROR )
             {
                 state.errorHandler->logError( "ArrayDataSource has invalid raw size specification", name );
             }
@@ -1013,29 +1292,37 @@ public:
 };
 
 
-class PiecewiseMapParser :
+class EvaluatorMapParser :
     public NodeParser
 {
 private:
-    const FmlObjectHandle object;
+    const xmlChar * const elementAttrib;
     
 public:
-    PiecewiseMapParser( FmlObjectHandle _object ) :
-        object( _object ) {}
+    vector<FmlEnsembleValue> elements;
+    vector<FmlObjectHandle> evaluators;
+    
+    EvaluatorMapParser( const xmlChar *_elementAttrib ) :
+        elementAttrib( _elementAttrib ) {}
     
     int parseNode( xmlNodePtr node, ParseState &state )
     {
-        int element = getIntAttribute( node, VALUE_ATTRIB, -1 );
-        FmlObjectHandle evaluator = getObjectAttribute( node, EVALUATOR_ATTRIB, state );
-        
-        if( Fieldml_SetEvaluator( state.session, object, element, evaluator ) != FML_ERR_NO_ERROR )
-        {
-            state.errorHandler->logError( "PiecewiseEvaluator creation failed" );
-            return 1;
-        }
+        elements.push_back( getIntAttribute( node, elementAttrib, -1 ) );
+        evaluators.push_back( getObjectAttribute( node, EVALUATOR_ATTRIB, state ) );
     
         return 0;
     }
+    
+    
+    FmlErrorNumber apply( FmlObjectHandle object, ParseState &state )
+    {
+        if( elements.size() == 0 )
+        {
+            return FML_ERR_NO_ERROR;
+        }
+        
+        return Fieldml_SetEvaluators( state.session, object, elements.size(), &elements.front(), &evaluators.front() );
+    }
 };
     
 
@@ -1103,13 +1390,19 @@ public:
             }
         }
         
-        PiecewiseMapParser piecewiseMapParser( evaluator );
+        EvaluatorMapParser piecewiseMapParser( VALUE_ATTRIB );
         int err = processChildren( evaluatorsNode, EVALUATOR_MAP_ENTRY_TAG, state, piecewiseMapParser );
         if( err != 0 )
         {
 						xmlFree(const_cast<char *>(name));
             return err;
         }
+        if( piecewiseMapParser.apply( evaluator, state ) != FML_ERR_NO_ERROR )
+        {
+            state.errorHandler->logError( "PiecewiseEvaluator creation failed", name );
+            xmlFree(const_cast<char *>(name));
+            return 1;
+        }
     
         BindParser bindParser( evaluator );
         err = processChildren( getFirstChild( objectNode, BINDINGS_TAG ), BIND_TAG, state, bindParser );
@@ -1132,32 +1425,6 @@ public:
 };
 
 
-class AggregateMapParser :
-    public NodeParser
-{
-private:
-    const FmlObjectHandle object;
-    
-public:
-    AggregateMapParser( FmlObjectHandle _object ) :
-        object( _object ) {}
-        
-    int parseNode( xmlNodePtr node, ParseState &state )
-    {
-        int element = getIntAttribute( node, COMPONENT_ATTRIB, -1 );
-        FmlObjectHandle evaluator = getObjectAttribute( node, EVALUATOR_ATTRIB, state );
-        
-        if( Fieldml_SetEvaluator( state.session, object, element, evaluator ) != FML_ERR_NO_ERROR )
-        {
-            state.errorHandler->logError( "Invalid component evaluator" );
-            return 1;
-        }
-    
-        return 0;
-    }
-};
-
-
 class AggregateEvaluatorParser :
     public NodeParser
 {
@@ -1196,13 +1463,19 @@ public:
             }
         }
         
-        AggregateMapParser aggregateMapParser( evaluator );
+        EvaluatorMapParser aggregateMapParser( COMPONENT_ATTRIB );
         int err = processChildren( evaluatorsNode, COMPONENT_EVALUATOR_TAG, state, aggregateMapParser );
         if( err != 0 )
         {
 						xmlFree(const_cast<char *>(name));
             return err;
         }
+        if( aggregateMapParser.apply( evaluator, state ) != FML_ERR_NO_ERROR )
+        {
+            state.errorHandler->logError( "Invalid component evaluator", name );
+            xmlFree(const_cast<char *>(name));
+            return 1;
+        }
     
         BindParser bindParser( evaluator );
         err = processChildren( getFirstChild( objectNode, BINDINGS_TAG ), BIND_TAG, state, bindParser );
@@ -1363,9 +1636,36 @@ public:
 };
     
     
-static int parseObjectNode( xmlNodePtr objectNode, ParseState &state )
+static void addObjectNode( xmlNodePtr objectNode, ParseState &state )
+{
+    int index = state.objectNodes.size();
+    state.objectNodes.push_back( ObjectNode( objectNode ) );
+    
+    const char *name = getStringAttribute( objectNode, NAME_ATTRIB );
+    if( name == NULL )
+    {
+        return;
+    }
+    
+    //NOTE: Names are interned in order, so ids are dense. If a name is duplicated, the later object is the one found.
+    int nameId = state.objectNames.intern( name ).id;
+    if( nameId == (int)state.objectNodesByName.size() )
+    {
+        state.objectNodesByName.push_back( index );
+    }
+    else
+    {
+        state.objectNodesByName[nameId] = index;
+    }
+    xmlFree(const_cast<char *>(name));
+}
+
+
+static int parseObjectNode( int index, ParseState &state )
 {
-    if( FmlUtil::contains( state.parseStack, objectNode ) )
+    xmlNodePtr objectNode = state.objectNodes[index].node;
+    
+    if( state.objectNodes[index].state == OBJECT_NODE_PARSING )
     {
         const char *name = getStringAttribute( objectNode, NAME_ATTRIB );
         state.errorHandler->logError( "Recursive object definition", name );
@@ -1373,10 +1673,14 @@ static int parseObjectNode( xmlNodePtr objectNode, ParseState &state )
         return 1;
     }
     
-    state.parseStack.push_back( objectNode );
+    state.objectNodes[index].state = OBJECT_NODE_PARSING;
 
     int err = 0;
-    if( checkName( objectNode, DATA_RESOURCE_TAG ) )
+    if( state.checkStructure && ( checkStructure( objectNode, state ) != 0 ) )
+    {
+        err = 1;
+    }
+    else if( checkName( objectNode, DATA_RESOURCE_TAG ) )
     {
         err = DataResourceParser().parseNode( objectNode, state );
     }
@@ -1425,80 +1729,23 @@ static int parseObjectNode( xmlNodePtr objectNode, ParseState &state )
         err = ParameterEvaluatorParser().parseNode( objectNode, state );
     }
     
-    state.parseStack.pop_back();
-    
-    vector<xmlNodePtr>::iterator loc = find( state.unparsedNodes.begin(), state.unparsedNodes.end(), objectNode );
-
-    state.unparsedNodes.erase( loc );
+    state.objectNodes[index].state = OBJECT_NODE_PARSED;
 
     return err;
 }
 
 
-static int parseDoc( xmlDocPtr doc, ParseState &state )
-{
-    xmlNodePtr fieldmlNode = xmlDocGetRootElement( doc );
-    
-    xmlNodePtr regionNode = xmlFirstElementChild( fieldmlNode );
-    
-    if( !checkName( regionNode, REGION_TAG ) )
-    {
-        return 1;
-    }
-
-    ImportParser importParser;
-    xmlNodePtr cur = xmlFirstElementChild( regionNode );
-    while( cur != NULL )
-    {
-        if( checkName( cur, IMPORT_TAG ) )
-        {
-            importParser.parseNode( cur, state );
-        }
-        else
-        {
-            state.unparsedNodes.insert( state.unparsedNodes.begin(), cur );
-        }
-        cur = xmlNextElementSibling( cur );
-    }
-
-    while( state.unparsedNodes.size() != 0 )
-    {
-        parseObjectNode( state.unparsedNodes.back(), state );
-    }
-    
-    for( vector<pair<FmlObjectHandle,string> >::const_iterator i = state.shapesHACK.begin(); i != state.shapesHACK.end(); i++ )
-    {
-        FmlObjectHandle shapesEvaluator = Fieldml_GetObjectByName( state.session, i->second.c_str() );
-        if( Fieldml_SetMeshShapes( state.session, i->first, shapesEvaluator ) != FML_ERR_NO_ERROR )
-        {
-            state.errorHandler->logError( "MeshType must have valid shape evaluator" );
-            return 1;
-        }
-    }
-    
-    return 0;
-}
-
-
-int FieldmlDOM::parseFieldmlFile( const char *filename, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+/**
+ * Reads the given file, and validates it against the schema unless only its structure is to be checked.
+ * 
+ * \return The document, or NULL if it could not be read or is invalid.
+ */
+static xmlDocPtr readDocument( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler )
 {
     LIBXML_TEST_VERSION
 
     xmlSubstituteEntitiesDefault( 1 );
 
-    xmlParserInputBufferPtr buffer = xmlParserInputBufferCreateFilename( filename, XML_CHAR_ENCODING_NONE );
-    if( buffer == NULL )
-    {
-        errorHandler->logError( "Failed to create XML buffer", filename );
-        return 1;
-    }
-    
-    int err = validate( errorHandler, buffer, filename );
-    if( err != 0 )
-    {
-        return err;
-    }
-
     xmlParserCtxtPtr ctxt; /* the parser context */
     xmlDocPtr doc; /* the resulting document tree */
 
@@ -1507,49 +1754,937 @@ int FieldmlDOM::parseFieldmlFile( const char *filename, FieldmlErrorHandler *err
     if( ctxt == NULL )
     {
         errorHandler->logError( "Failed to allocate XML parser context" );
-        return 1;
+        return NULL;
     }
-    /* parse the file, activating the DTD validation option */
-    doc = xmlCtxtReadFile( ctxt, filename, NULL, 0 );
+    /* parse the file, reporting any errors via the error handler rather than libxml's */
+    doc = xmlCtxtReadFile( ctxt, filename, NULL, XML_PARSE_NOERROR );
     /* check if parsing suceeded */
     if (doc == NULL)
     {
-        errorHandler->logError( "Failed to parse XML file", filename );
+        logParseError( errorHandler, ctxt, "Failed to parse XML file", filename );
+        xmlFreeParserCtxt( ctxt );
+        return NULL;
     }
-    else
+    /* free up the parser context */
+    xmlFreeParserCtxt( ctxt );
+    
+    if( ( validationLevel != FML_VALIDATION_STRUCTURAL ) && ( validate( errorHandler, doc, filename ) != 0 ) )
     {
-        ParseState state;
+        xmlFreeDoc( doc );
+        return NULL;
+    }
+    
+    return doc;
+}
+
+
+/**
+ * Holds the errors logged while a document is read on another thread, so that they can be passed on in order once
+ * the document is used.
+ */
+class BufferedErrorHandler :
+    public FieldmlErrorHandler
+{
+private:
+    //NOTE: Each overload is replayed as itself, as error handlers may treat them differently.
+    enum BufferedErrorKind
+    {
+        MESSAGE_ERROR,
+        NAMED_ERROR,
+        OBJECT_ERROR
+    };
+    
+    struct BufferedError
+    {
+        BufferedErrorKind kind;
+        string error;
+        string name1;
+        string name2;
+        int nameCount;
+        FmlObjectHandle object;
+    };
+    
+    vector<BufferedError> errors;
+    
+    void addError( BufferedErrorKind kind, const string &error )
+    {
+        BufferedError entry;
+        entry.kind = kind;
+        entry.error = error;
+        entry.nameCount = 0;
+        entry.object = FML_INVALID_HANDLE;
+        errors.push_back( entry );
+    }
+    
+public:
+    void logError( const string error )
+    {
+        addError( MESSAGE_ERROR, error );
+    }
+    
+    
+    void logError( const char *error, const FmlObjectHandle object )
+    {
+        addError( OBJECT_ERROR, error );
+        errors.back().object = object;
+    }
+    
+    
+    void logError( const char *error, const char *name1 = NULL, const char *name2 = NULL )
+    {
+        addError( NAMED_ERROR, error );
+        if( name1 != NULL )
+        {
+            errors.back().name1 = name1;
+            errors.back().nameCount = 1;
+        }
+        if( name2 != NULL )
+        {
+            errors.back().name2 = name2;
+            errors.back().nameCount = 2;
+        }
+    }
+    
+    
+    void replay( FieldmlErrorHandler *errorHandler )
+    {
+        for( vector<BufferedError>::const_iterator i = errors.begin(); i != errors.end(); i++ )
+        {
+            if( i->kind == MESSAGE_ERROR )
+            {
+                errorHandler->logError( i->error );
+            }
+            else if( i->kind == OBJECT_ERROR )
+            {
+                errorHandler->logError( i->error.c_str(), i->object );
+            }
+            else
+            {
+                errorHandler->logError( i->error.c_str(), ( i->nameCount > 0 ) ? i->name1.c_str() : NULL, ( i->nameCount > 1 ) ? i->name2.c_str() : NULL );
+            }
+        }
+        errors.clear();
+    }
+};
+
+
+/**
+ * An imported document that is read and validated on another thread while the importing document is parsed. Its
+ * objects are still created in document order, once its import is reached, so handles do not depend on timing.
+ */
+struct PrefetchedDocument
+{
+    const ParseState *owner;
+    FmlSessionHandle session;
+    string filename;
+    FieldmlValidationLevel validationLevel;
+    xmlDocPtr doc;
+    BufferedErrorHandler errors;
+    Thread *thread;
+};
+
+
+static const int MAX_PREFETCHED_IMPORTS = 8;
+
+//NOTE: Shared by all sessions. A document is only used by the session, and at the validation level, it was read for.
+static Mutex prefetchLock;
+static vector<PrefetchedDocument*> prefetchedDocuments;
+
+
+static void readPrefetchedDocument( void *argument )
+{
+    PrefetchedDocument *document = (PrefetchedDocument*)argument;
+    document->doc = readDocument( document->filename.c_str(), document->validationLevel, &document->errors );
+}
+
+
+static void freePrefetchedDocument( PrefetchedDocument *document )
+{
+    delete document->thread;
+    if( document->doc != NULL )
+    {
+        xmlFreeDoc( document->doc );
+    }
+    delete document;
+}
+
+
+/**
+ * Starts reading the documents imported by the given region on other threads. The first is left to be read as
+ * usual, as it is needed straight away.
+ */
+static void prefetchImports( xmlNodePtr regionNode, ParseState &state )
+{
+    //NOTE: With only one processor, reading ahead would only add overhead.
+    if( Thread::getConcurrency() < 2 )
+    {
+        return;
+    }
+    
+    //NOTE: Keyed by the same filename the import is resolved to when it is reached.
+    const char *regionRoot = Fieldml_PeekRegionRoot( state.session );
+    const string root = ( regionRoot != NULL ) ? regionRoot : "";
+    
+    vector<string> filenames;
+    for( xmlNodePtr cur = xmlFirstElementChild( regionNode ); cur != NULL; cur = xmlNextElementSibling( cur ) )
+    {
+        if( !checkName( cur, IMPORT_TAG ) )
+        {
+            continue;
+        }
+        
+        const char *href = getStringAttribute( cur, HREF_ATTRIB, XLINK_NAMESPACE_STRING );
+        if( ( href != NULL ) && ( strcmp( href, FML_INTERNAL_LIBRARY_NAME ) != 0 ) )
+        {
+            const string filename = makeFilename( root, href );
+            if( !FmlUtil::contains( filenames, filename ) )
+            {
+                filenames.push_back( filename );
+            }
+        }
+        xmlFree(const_cast<char *>(href));
+    }
+    
+    for( int i = 1; ( i < (int)filenames.size() ) && ( i <= MAX_PREFETCHED_IMPORTS ); i++ )
+    {
+        PrefetchedDocument *document = new PrefetchedDocument();
+        document->owner = &state;
+        document->session = state.session;
+        document->filename = filenames[i];
+        document->validationLevel = state.checkStructure ? FML_VALIDATION_STRUCTURAL : FML_VALIDATION_SCHEMA;
+        document->doc = NULL;
+        document->thread = new Thread( readPrefetchedDocument, document );
+        
+        MutexGuard guard( prefetchLock );
+        prefetchedDocuments.push_back( document );
+    }
+}
+
+
+/**
+ * \return The prefetched copy of the given document, or NULL if there is none. The caller must free it.
+ */
+static PrefetchedDocument *takePrefetchedDocument( FmlSessionHandle session, const char *filename, FieldmlValidationLevel validationLevel )
+{
+    MutexGuard guard( prefetchLock );
+    
+    for( vector<PrefetchedDocument*>::iterator i = prefetchedDocuments.begin(); i != prefetchedDocuments.end(); i++ )
+    {
+        PrefetchedDocument *document = *i;
+        if( ( document->session == session ) && ( document->filename == filename ) && ( document->validationLevel == validationLevel ) )
+        {
+            prefetchedDocuments.erase( i );
+            return document;
+        }
+    }
+    
+    return NULL;
+}
+
+
+/**
+ * Frees the documents prefetched for the given parse that were never used, such as those of recursive or
+ * repeated imports.
+ */
+static void discardPrefetchedDocuments( const ParseState &state )
+{
+    vector<PrefetchedDocument*> unused;
+    {
+        MutexGuard guard( prefetchLock );
+        
+        vector<PrefetchedDocument*>::iterator i = prefetchedDocuments.begin();
+        while( i != prefetchedDocuments.end() )
+        {
+            if( (*i)->owner == &state )
+            {
+                unused.push_back( *i );
+                i = prefetchedDocuments.erase( i );
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+    
+    for( vector<PrefetchedDocument*>::iterator i = unused.begin(); i != unused.end(); i++ )
+    {
+        freePrefetchedDocument( *i );
+    }
+}
+
+
+/**
+ * Sets the shapes of the mesh types parsed so far, parsing the shape evaluators if necessary.
+ */
+static int resolveShapes( ParseState &state )
+{
+    //NOTE: Parsing a shape evaluator may parse further mesh types, so the list can grow as it is processed.
+    for( size_t i = 0; i < state.shapesHACK.size(); i++ )
+    {
+        pair<FmlObjectHandle,string> shapes = state.shapesHACK[i];
+        resolveObject( shapes.second.c_str(), state );
+        
+        FmlObjectHandle shapesEvaluator = Fieldml_GetObjectByName( state.session, shapes.second.c_str() );
+        if( Fieldml_SetMeshShapes( state.session, shapes.first, shapesEvaluator ) != FML_ERR_NO_ERROR )
+        {
+            state.errorHandler->logError( "MeshType must have valid shape evaluator" );
+            state.shapesHACK.clear();
+            return 1;
+        }
+    }
+    
+    state.shapesHACK.clear();
+    
+    return 0;
+}
+
+
+/**
+ * Parses the remaining unparsed object nodes in document order, parsing any they refer to first.
+ */
+static int parseObjects( ParseState &state )
+{
+    for( int i = 0; i < (int)state.objectNodes.size(); i++ )
+    {
+        if( state.objectNodes[i].state == OBJECT_NODE_UNPARSED )
+        {
+            parseObjectNode( i, state );
+        }
+    }
+    
+    return resolveShapes( state );
+}
+
+
+/**
+ * Checks the document's structure, processes its imports, and indexes its other objects without parsing them.
+ */
+static int readRegion( xmlDocPtr doc, ParseState &state )
+{
+    xmlNodePtr fieldmlNode = xmlDocGetRootElement( doc );
+    
+    if( state.checkStructure && ( ( fieldmlNode == NULL ) || !checkName( fieldmlNode, FIELDML_TAG ) ) )
+    {
+        state.errorHandler->logError( "Document must have a Fieldml root element" );
+        return 1;
+    }
+    
+    xmlNodePtr regionNode = xmlFirstElementChild( fieldmlNode );
+    
+    if( ( regionNode == NULL ) || !checkName( regionNode, REGION_TAG ) )
+    {
+        if( state.checkStructure )
+        {
+            state.errorHandler->logError( "Fieldml element must contain a Region" );
+        }
+        return 1;
+    }
+    
+    if( state.checkStructure && ( xmlHasProp( regionNode, NAME_ATTRIB ) == NULL ) )
+    {
+        state.errorHandler->logError( "Missing required attribute", (const char*)NAME_ATTRIB, (const char*)REGION_TAG );
+        return 1;
+    }
+
+    prefetchImports( regionNode, state );
+
+    ImportParser importParser;
+    xmlNodePtr cur = xmlFirstElementChild( regionNode );
+    while( cur != NULL )
+    {
+        if( checkName( cur, IMPORT_TAG ) )
+        {
+            if( !state.checkStructure || ( checkStructure( cur, state ) == 0 ) )
+            {
+                importParser.parseNode( cur, state );
+            }
+        }
+        else if( state.checkStructure && ( getElementRule( cur ) == NULL ) )
+        {
+            state.errorHandler->logError( "Unexpected element", (const char*)cur->name, (const char*)REGION_TAG );
+        }
+        else
+        {
+            addObjectNode( cur, state );
+        }
+        cur = xmlNextElementSibling( cur );
+    }
+    
+    discardPrefetchedDocuments( state );
+
+    return 0;
+}
+
+
+static int parseDoc( xmlDocPtr doc, ParseState &state )
+{
+    int err = readRegion( doc, state );
+    if( err != 0 )
+    {
+        return err;
+    }
+    
+    return parseObjects( state );
+}
+
+
+/**
+ * Reads the given file, using the copy prefetched by an enclosing parse if there is one.
+ * 
+ * \return The document, or NULL if it could not be read or is invalid.
+ */
+static xmlDocPtr loadDocument( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+{
+    PrefetchedDocument *prefetched = takePrefetchedDocument( session, filename, validationLevel );
+    if( prefetched == NULL )
+    {
+        return readDocument( filename, validationLevel, errorHandler );
+    }
+    
+    prefetched->thread->join();
+    prefetched->errors.replay( errorHandler );
+    xmlDocPtr doc = prefetched->doc;
+    prefetched->doc = NULL;
+    freePrefetchedDocument( prefetched );
+    
+    return doc;
+}
+
+
+struct FieldmlDOM::LazyDocument
+{
+    xmlDocPtr doc;
+    
+    //NOTE: Records which of the document's objects have been parsed, so it is only used for a single region.
+    ParseState state;
+};
+
+
+/**
+ * A data resource that has been read by a streaming parse, but not yet added to the session.
+ */
+struct PendingResource
+{
+    string name;
+    
+    bool hasName;
+    
+    /**
+     * The resource's href element, if it refers to external data.
+     */
+    xmlNodePtr href;
+    
+    bool isInline;
+    
+    string inlineData;
+    
+    /**
+     * The resource's array data source elements.
+     */
+    vector<xmlNodePtr> sources;
+    
+    PendingResource() :
+        hasName( false ), href( NULL ), isInline( false ) {}
+    
+    ~PendingResource()
+    {
+        xmlFreeNode( href );
+        for( vector<xmlNodePtr>::iterator i = sources.begin(); i != sources.end(); i++ )
+        {
+            xmlFreeNode( *i );
+        }
+    }
+    
+    bool isDescribed() const
+    {
+        return isInline || ( href != NULL );
+    }
+};
+
+
+/**
+ * The state of a streaming parse. Each top-level object is built into a small tree of its own, except for data
+ * resources, whose inline data is collected as a plain string as it arrives. Nothing is added to the session until
+ * the whole document has been read and validated, so an invalid document leaves the session unchanged.
+ */
+struct StreamState
+{
+    ParseState state;
+    
+    xmlParserCtxtPtr context;
+    
+    /**
+     * Holds the trees of the objects that have been read but not yet parsed, under Fieldml and Region elements.
+     */
+    xmlDocPtr doc;
+    
+    xmlNodePtr regionNode;
+    
+    xmlNsPtr xlinkNs;
+    
+    /**
+     * The depth of the current element, with the Fieldml element at depth zero.
+     */
+    int depth;
+    
+    /**
+     * The number of elements being skipped, if the current element is being ignored.
+     */
+    int skipping;
+    
+    bool regionFound;
+    
+    /**
+     * The tree currently being built, and the element within it that is currently being read.
+     */
+    xmlNodePtr tree;
+    
+    xmlNodePtr current;
+    
+    bool inDataResource;
+    
+    /**
+     * The data resource currently being read. Owned by resources.
+     */
+    PendingResource *resource;
+    
+    vector<PendingResource*> resources;
+    
+    /**
+     * The Import elements read so far, which are kept under the Region element.
+     */
+    vector<xmlNodePtr> imports;
+    
+    bool inInlineData;
+    
+    int err;
+};
+
+
+static void stopStream( StreamState *stream )
+{
+    stream->err = 1;
+    xmlStopParser( stream->context );
+}
+
+
+static const char *getStreamAttribute( const xmlChar **attributes, int attributeCount, const xmlChar *name, string &value )
+{
+    for( int i = 0; i < attributeCount; i++ )
+    {
+        const xmlChar **attribute = attributes + ( i * 5 );
+        if( ( attribute[2] == NULL ) && xmlStrEqual( attribute[0], name ) )
+        {
+            value.assign( (const char*)attribute[3], attribute[4] - attribute[3] );
+            return value.c_str();
+        }
+    }
+    
+    return NULL;
+}
+
+
+static xmlNodePtr newStreamElement( StreamState *stream, const xmlChar *name, int attributeCount, const xmlChar **attributes )
+{
+    xmlNodePtr node = xmlNewDocNode( stream->doc, NULL, name, NULL );
+    for( int i = 0; i < attributeCount; i++ )
+    {
+        const xmlChar **attribute = attributes + ( i * 5 );
+        string value( (const char*)attribute[3], attribute[4] - attribute[3] );
+        if( ( attribute[2] != NULL ) && xmlStrEqual( attribute[2], XLINK_NAMESPACE_STRING ) )
+        {
+            xmlNewNsProp( node, stream->xlinkNs, attribute[0], (const xmlChar*)value.c_str() );
+        }
+        else
+        {
+            xmlNewProp( node, attribute[0], (const xmlChar*)value.c_str() );
+        }
+    }
+    
+    return node;
+}
+
+
+/**
+ * Handles the elements of a DataResource, which are read without building a tree for the resource as a whole.
+ */
+static void startDataResourceElement( StreamState *stream, const xmlChar *name, int attributeCount, const xmlChar **attributes )
+{
+    ParseState &state = stream->state;
+    
+    if( stream->tree != NULL )
+    {
+        stream->current = xmlAddChild( stream->current, newStreamElement( stream, name, attributeCount, attributes ) );
+    }
+    else if( ( stream->depth == 3 ) && xmlStrEqual( name, DATA_RESOURCE_DESCRIPTION_TAG ) )
+    {
+    }
+    else if( ( stream->depth == 3 ) && xmlStrEqual( name, ARRAY_DATA_SOURCE_TAG ) && stream->resource->isDescribed() )
+    {
+        stream->tree = stream->current = newStreamElement( stream, name, attributeCount, attributes );
+    }
+    else if( ( stream->depth == 4 ) && xmlStrEqual( name, DATA_RESOURCE_HREF_TAG ) && !stream->resource->isDescribed() )
+    {
+        stream->tree = stream->current = newStreamElement( stream, name, attributeCount, attributes );
+    }
+    else if( ( stream->depth == 4 ) && xmlStrEqual( name, DATA_RESOURCE_STRING_TAG ) && !stream->resource->isDescribed() )
+    {
+        stream->resource->isInline = true;
+        stream->inInlineData = true;
+    }
+    else if( state.checkStructure )
+    {
+        state.errorHandler->logError( "Unexpected element", (const char*)name, (const char*)DATA_RESOURCE_TAG );
+        stopStream( stream );
+    }
+    else
+    {
+        stream->skipping = 1;
+    }
+}
+
+
+static void endDataResourceElement( StreamState *stream )
+{
+    ParseState &state = stream->state;
+    
+    if( stream->inInlineData )
+    {
+        stream->inInlineData = false;
+        return;
+    }
+    
+    if( stream->current != stream->tree )
+    {
+        stream->current = stream->current->parent;
+        return;
+    }
+    
+    if( stream->tree == NULL )
+    {
+        return;
+    }
+    
+    xmlNodePtr node = stream->tree;
+    stream->tree = stream->current = NULL;
+    
+    if( state.checkStructure && ( checkStructure( node, state ) != 0 ) )
+    {
+        xmlFreeNode( node );
+        stopStream( stream );
+    }
+    else if( checkName( node, DATA_RESOURCE_HREF_TAG ) )
+    {
+        stream->resource->href = node;
+    }
+    else
+    {
+        stream->resource->sources.push_back( node );
+    }
+}
+
+
+static void startStreamElement( void *context, const xmlChar *name, const xmlChar * /*prefix*/, const xmlChar * /*uri*/, int /*namespaceCount*/,
+    const xmlChar ** /*namespaces*/, int attributeCount, int /*defaultedCount*/, const xmlChar **attributes )
+{
+    StreamState *stream = (StreamState*)context;
+    ParseState &state = stream->state;
+    
+    stream->depth++;
+    if( stream->skipping > 0 )
+    {
+        stream->skipping++;
+        return;
+    }
+    
+    string value;
+    if( stream->depth == 0 )
+    {
+        if( state.checkStructure && !xmlStrEqual( name, FIELDML_TAG ) )
+        {
+            state.errorHandler->logError( "Document must have a Fieldml root element" );
+            stopStream( stream );
+        }
+    }
+    else if( stream->depth == 1 )
+    {
+        //NOTE: As with the DOM parser, only the first element within the Fieldml element is read.
+        if( stream->regionFound )
+        {
+            stream->skipping = 1;
+        }
+        else if( !xmlStrEqual( name, REGION_TAG ) )
+        {
+            if( state.checkStructure )
+            {
+                state.errorHandler->logError( "Fieldml element must contain a Region" );
+            }
+            stopStream( stream );
+        }
+        else if( state.checkStructure && ( getStreamAttribute( attributes, attributeCount, NAME_ATTRIB, value ) == NULL ) )
+        {
+            state.errorHandler->logError( "Missing required attribute", (const char*)NAME_ATTRIB, (const char*)REGION_TAG );
+            stopStream( stream );
+        }
+        stream->regionFound = true;
+    }
+    else if( stream->depth == 2 )
+    {
+        if( xmlStrEqual( name, DATA_RESOURCE_TAG ) )
+        {
+            stream->inDataResource = true;
+            stream->resource = new PendingResource();
+            stream->resources.push_back( stream->resource );
+            stream->resource->hasName = ( getStreamAttribute( attributes, attributeCount, NAME_ATTRIB, stream->resource->name ) != NULL );
+            if( !stream->resource->hasName && state.checkStructure )
+            {
+                state.errorHandler->logError( "Missing required attribute", (const char*)NAME_ATTRIB, (const char*)DATA_RESOURCE_TAG );
+                stopStream( stream );
+            }
+        }
+        else
+        {
+            stream->tree = stream->current = xmlAddChild( stream->regionNode, newStreamElement( stream, name, attributeCount, attributes ) );
+        }
+    }
+    else if( stream->inDataResource )
+    {
+        startDataResourceElement( stream, name, attributeCount, attributes );
+    }
+    else
+    {
+        stream->current = xmlAddChild( stream->current, newStreamElement( stream, name, attributeCount, attributes ) );
+    }
+}
+
+
+static void endStreamElement( void *context, const xmlChar * /*name*/, const xmlChar * /*prefix*/, const xmlChar * /*uri*/ )
+{
+    StreamState *stream = (StreamState*)context;
+    ParseState &state = stream->state;
+    
+    int depth = stream->depth--;
+    if( stream->skipping > 0 )
+    {
+        stream->skipping--;
+        return;
+    }
+    
+    if( depth < 2 )
+    {
+        return;
+    }
+    
+    if( stream->inDataResource )
+    {
+        if( depth > 2 )
+        {
+            endDataResourceElement( stream );
+        }
+        else
+        {
+            stream->inDataResource = false;
+            if( !stream->resource->isDescribed() )
+            {
+                state.errorHandler->logError( "Invalid array data resource specification", stream->resource->name.c_str() );
+                stopStream( stream );
+            }
+        }
+        return;
+    }
+    
+    if( depth > 2 )
+    {
+        stream->current = stream->current->parent;
+        return;
+    }
+    
+    //NOTE: Objects may refer to objects defined later in the document, so their trees are kept, and parsed once the
+    //whole document has been read. Imports are kept too, so that nothing is imported from an invalid document.
+    xmlNodePtr node = stream->tree;
+    stream->tree = stream->current = NULL;
+    
+    bool keep = false;
+    if( checkName( node, IMPORT_TAG ) )
+    {
+        if( !state.checkStructure || ( checkStructure( node, state ) == 0 ) )
+        {
+            keep = true;
+            stream->imports.push_back( node );
+        }
+    }
+    else if( state.checkStructure && ( getElementRule( node ) == NULL ) )
+    {
+        state.errorHandler->logError( "Unexpected element", (const char*)node->name, (const char*)REGION_TAG );
+    }
+    else
+    {
+        keep = true;
+        addObjectNode( node, state );
+    }
+    
+    if( !keep )
+    {
+        xmlUnlinkNode( node );
+        xmlFreeNode( node );
+    }
+}
+
+
+static void streamCharacters( void *context, const xmlChar *characters, int length )
+{
+    StreamState *stream = (StreamState*)context;
+    
+    if( stream->skipping > 0 )
+    {
+        return;
+    }
+    
+    if( stream->inInlineData )
+    {
+        stream->resource->inlineData.append( (const char*)characters, length );
+    }
+    else if( stream->current != NULL )
+    {
+        xmlNodeAddContentLen( stream->current, characters, length );
+    }
+}
+
+
+/**
+ * Adds the imports and data resources read by a streaming parse to the session, in the same order as the DOM parser.
+ */
+static int addStreamedObjects( StreamState &stream )
+{
+    ParseState &state = stream.state;
+    
+    ImportParser importParser;
+    for( vector<xmlNodePtr>::iterator i = stream.imports.begin(); i != stream.imports.end(); i++ )
+    {
+        importParser.parseNode( *i, state );
+    }
+    
+    for( vector<PendingResource*>::iterator i = stream.resources.begin(); i != stream.resources.end(); i++ )
+    {
+        PendingResource *pending = *i;
+        const char *name = pending->hasName ? pending->name.c_str() : NULL;
         
-        state.errorHandler = errorHandler;
-        state.session = session;
-        parseDoc( doc, state );
-        xmlFreeDoc( doc );
+        FmlObjectHandle resource;
+        if( pending->href != NULL )
+        {
+            const char *href = getStringAttribute( pending->href, HREF_ATTRIB, XLINK_NAMESPACE_STRING );
+            const char *format = getStringAttribute( pending->href, FORMAT_ATTRIB );
+            resource = Fieldml_CreateHrefDataResource( state.session, name, format, href );
+            xmlFree(const_cast<char *>(href));
+            xmlFree(const_cast<char *>(format));
+        }
+        else
+        {
+            resource = Fieldml_CreateInlineDataResource( state.session, name );
+        }
+        if( resource == FML_INVALID_HANDLE )
+        {
+            state.errorHandler->logError( "Invalid array data resource specification", pending->name.c_str() );
+            return 1;
+        }
+        
+        //NOTE: Each resource's data is released once copied, so the data is only ever held twice for one resource.
+        const string &data = pending->inlineData;
+        for( size_t offset = 0; offset < data.length(); offset += INT_MAX )
+        {
+            int length = (int)( ( data.length() - offset < (size_t)INT_MAX ) ? data.length() - offset : INT_MAX );
+            if( Fieldml_AddInlineData( state.session, resource, data.data() + offset, length ) != FML_ERR_NO_ERROR )
+            {
+                state.errorHandler->logError( "Error adding text to text inline data resource" );
+                return 1;
+            }
+        }
+        string().swap( pending->inlineData );
+        
+        for( vector<xmlNodePtr>::iterator j = pending->sources.begin(); j != pending->sources.end(); j++ )
+        {
+            int err = ArrayDataSourceParser( resource ).parseNode( *j, state );
+            if( err != 0 )
+            {
+                return err;
+            }
+        }
     }
-    /* free up the parser context */
-    xmlFreeParserCtxt( ctxt );
     
     return 0;
 }
 
 
-int FieldmlDOM::parseFieldmlString( const char *string, const char *stringDescription, const char *url, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+int FieldmlDOM::parseFieldmlFile( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
 {
-    LIBXML_TEST_VERSION
+    xmlDocPtr doc = loadDocument( filename, validationLevel, errorHandler, session );
+    if( doc == NULL )
+    {
+        return 1;
+    }
+    
+    ParseState state;
+    
+    state.errorHandler = errorHandler;
+    state.session = session;
+    state.checkStructure = ( validationLevel == FML_VALIDATION_STRUCTURAL );
+    parseDoc( doc, state );
+    xmlFreeDoc( doc );
+    
+    return 0;
+}
 
-    xmlSubstituteEntitiesDefault( 1 );
 
-    xmlParserInputBufferPtr buffer = xmlParserInputBufferCreateMem( string, strlen( string ), XML_CHAR_ENCODING_NONE );
-    if( buffer == NULL )
+FieldmlDOM::LazyDocument *FieldmlDOM::openLazyDocument( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+{
+    xmlDocPtr doc = loadDocument( filename, validationLevel, errorHandler, session );
+    if( doc == NULL )
     {
-        errorHandler->logError( "Failed to create XML buffer", stringDescription );
-        return 1;
+        return NULL;
     }
     
-    int err = validate( errorHandler, buffer, stringDescription );
-    if( err != 0 )
+    LazyDocument *document = new LazyDocument();
+    
+    document->doc = doc;
+    document->state.errorHandler = errorHandler;
+    document->state.session = session;
+    document->state.checkStructure = ( validationLevel == FML_VALIDATION_STRUCTURAL );
+    if( readRegion( doc, document->state ) != 0 )
     {
-        return err;
+        closeLazyDocument( document );
+        return NULL;
+    }
+    
+    return document;
+}
+
+
+int FieldmlDOM::instantiateLazyObject( LazyDocument *document, const char *name )
+{
+    ParseState &state = document->state;
+    
+    if( !resolveObject( name, state ) )
+    {
+        return 1;
     }
+    
+    return resolveShapes( state );
+}
+
+
+void FieldmlDOM::closeLazyDocument( LazyDocument *document )
+{
+    xmlFreeDoc( document->doc );
+    delete document;
+}
+
+
+int FieldmlDOM::parseFieldmlString( const char *string, const char *stringDescription, const char *url, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+{
+    LIBXML_TEST_VERSION
+
+    xmlSubstituteEntitiesDefault( 1 );
 
     xmlParserCtxtPtr ctxt = xmlNewParserCtxt();
     if( ctxt == NULL )
@@ -1558,22 +2693,165 @@ int FieldmlDOM::parseFieldmlString( const char *string, const char *stringDescri
         return 1;
     }
 
-    xmlDocPtr doc = xmlCtxtReadMemory( ctxt, string, strlen( string ), url, NULL, 0 );
+    xmlDocPtr doc = xmlCtxtReadMemory( ctxt, string, strlen( string ), url, NULL, XML_PARSE_NOERROR );
     if( doc == NULL )
     {
-        errorHandler->logError( "Failed to parse XML", stringDescription );
+        logParseError( errorHandler, ctxt, "Failed to parse XML", stringDescription );
+        xmlFreeParserCtxt( ctxt );
+        return 1;
     }
-    else
+    xmlFreeParserCtxt( ctxt );
+    
+    int err = 0;
+    if( validationLevel != FML_VALIDATION_STRUCTURAL )
+    {
+        err = validate( errorHandler, doc, stringDescription );
+    }
+    if( err == 0 )
     {
         ParseState state;
         
         state.errorHandler = errorHandler;
         state.session = session;
+        state.checkStructure = ( validationLevel == FML_VALIDATION_STRUCTURAL );
         parseDoc( doc, state );
-        xmlFreeDoc( doc );
     }
+    xmlFreeDoc( doc );
+    
+    return err;
+}
 
-    xmlFreeParserCtxt( ctxt );
+
+int FieldmlDOM::parseFieldmlStream( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+{
+    LIBXML_TEST_VERSION
+
+    xmlSubstituteEntitiesDefault( 1 );
+
+    FILE *file = fopen( filename, "rb" );
+    if( file == NULL )
+    {
+        errorHandler->logError( "Failed to open XML file", filename );
+        return 1;
+    }
     
-    return 0;
+    xmlSchemaValidCtxtPtr vctxt = NULL;
+    if( validationLevel != FML_VALIDATION_STRUCTURAL )
+    {
+        xmlSchemaPtr schema = getSchema( errorHandler );
+        if( schema == NULL )
+        {
+            errorHandler->logError( "Cannot validate against the FieldML schema", filename );
+            fclose( file );
+            return 1;
+        }
+        vctxt = xmlSchemaNewValidCtxt( schema );
+        xmlSchemaSetValidErrors( vctxt, (xmlSchemaValidityErrorFunc)addContextError, (xmlSchemaValidityWarningFunc)addContextError, errorHandler );
+    }
+    
+    StreamState stream;
+    
+    stream.state.errorHandler = errorHandler;
+    stream.state.session = session;
+    stream.state.checkStructure = ( validationLevel == FML_VALIDATION_STRUCTURAL );
+    stream.doc = xmlNewDoc( (const xmlChar*)"1.0" );
+    xmlNodePtr fieldmlNode = xmlNewDocNode( stream.doc, NULL, FIELDML_TAG, NULL );
+    xmlDocSetRootElement( stream.doc, fieldmlNode );
+    stream.xlinkNs = xmlNewNs( fieldmlNode, XLINK_NAMESPACE_STRING, (const xmlChar*)"xlink" );
+    stream.regionNode = xmlNewChild( fieldmlNode, NULL, REGION_TAG, NULL );
+    stream.depth = -1;
+    stream.skipping = 0;
+    stream.regionFound = false;
+    stream.tree = NULL;
+    stream.current = NULL;
+    stream.inDataResource = false;
+    stream.resource = NULL;
+    stream.inInlineData = false;
+    stream.err = 0;
+    
+    xmlSAXHandler handler;
+    memset( &handler, 0, sizeof( handler ) );
+    handler.initialized = XML_SAX2_MAGIC;
+    handler.startElementNs = startStreamElement;
+    handler.endElementNs = endStreamElement;
+    handler.characters = streamCharacters;
+    handler.cdataBlock = streamCharacters;
+    handler.ignorableWhitespace = streamCharacters;
+    
+    //NOTE: The schema validator wraps the handler, and passes the events on once it has checked them.
+    xmlSAXHandlerPtr saxHandler = &handler;
+    void *userData = &stream;
+    xmlSchemaSAXPlugPtr plug = NULL;
+    if( vctxt != NULL )
+    {
+        plug = xmlSchemaSAXPlug( vctxt, &saxHandler, &userData );
+    }
+    
+    //NOTE: The inline data in very large documents can exceed libxml's default limit on the size of a text node.
+    stream.context = xmlCreatePushParserCtxt( saxHandler, userData, NULL, 0, filename );
+    xmlCtxtUseOptions( stream.context, XML_PARSE_NOENT | XML_PARSE_NOERROR | XML_PARSE_NOWARNING | XML_PARSE_HUGE );
+    
+    char buffer[65536];
+    size_t count;
+    int result = 0;
+    xmlResetLastError();
+    while( ( result == 0 ) && ( ( count = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 ) )
+    {
+        result = xmlParseChunk( stream.context, buffer, (int)count, 0 );
+    }
+    if( result == 0 )
+    {
+        result = xmlParseChunk( stream.context, NULL, 0, 1 );
+    }
+    fclose( file );
+    
+    int err = stream.err;
+    if( ( err == 0 ) && ( ( result != 0 ) || !stream.context->wellFormed ) )
+    {
+        logParseError( errorHandler, stream.context, "Failed to parse XML file", filename );
+        err = 1;
+    }
+    if( ( err == 0 ) && ( vctxt != NULL ) && ( xmlSchemaIsValid( vctxt ) != 1 ) )
+    {
+        xmlErrorPtr lastError = xmlGetLastError();
+        if( ( lastError != NULL ) && ( lastError->message != NULL ) )
+        {
+            string errorMessage = "Validation error in ";
+            errorMessage += filename;
+            errorMessage += ": ";
+            errorMessage += lastError->message;
+            errorHandler->logError( errorMessage );
+        }
+        err = 1;
+    }
+    
+    if( err == 0 )
+    {
+        err = addStreamedObjects( stream );
+    }
+    if( err == 0 )
+    {
+        err = parseObjects( stream.state );
+    }
+    
+    if( ( stream.tree != NULL ) && ( stream.tree->parent == NULL ) )
+    {
+        xmlFreeNode( stream.tree );
+    }
+    for( vector<PendingResource*>::iterator i = stream.resources.begin(); i != stream.resources.end(); i++ )
+    {
+        delete *i;
+    }
+    xmlFreeParserCtxt( stream.context );
+    if( plug != NULL )
+    {
+        xmlSchemaSAXUnplug( plug );
+    }
+    if( vctxt != NULL )
+    {
+        xmlSchemaFreeValidCtxt( vctxt );
+    }
+    xmlFreeDoc( stream.doc );
+    
+    return err;
 }
@@ -48,9 +48,39 @@
 
 namespace FieldmlDOM
 {
-    int parseFieldmlFile( const char *filename, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+    int parseFieldmlFile( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
 
-    int parseFieldmlString( const char *string, const char *stringDescription, const char *url, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+    int parseFieldmlString( const char *string, const char *stringDescription, const char *url, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+
+    /**
+     * Parses the given file without first building a tree for the whole document. Inline data is collected as plain
+     * strings rather than as text nodes, and each resource's copy is released as soon as it has been added to the
+     * session. Nothing is added to the session unless the whole document is well-formed and valid.
+     */
+    int parseFieldmlStream( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+
+    /**
+     * A document whose objects are only parsed as they are needed.
+     */
+    struct LazyDocument;
+
+    /**
+     * Reads and checks the given file, and processes its imports into the session's current region, but only indexes
+     * the document's other objects by name. They are created by instantiateLazyObject.
+     * 
+     * \return The document, or NULL if it could not be read. The document must be closed with closeLazyDocument.
+     */
+    LazyDocument *openLazyDocument( const char *filename, FieldmlValidationLevel validationLevel, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+
+    /**
+     * Creates the document's object with the given name, and the objects it refers to, unless they have already been
+     * created. Objects are created in the session's current region, which must be the one the document was opened in.
+     * 
+     * \return Non-zero if the document has no such object.
+     */
+    int instantiateLazyObject( LazyDocument *document, const char *name );
+
+    void closeLazyDocument( LazyDocument *document );
 }
 
 #endif // H_FIELDMLDOM
@@ -54,6 +54,9 @@ using namespace std;
 //
 //========================================================================
 
+static const string emptyName;
+
+
 FieldmlRegion::FieldmlRegion( const string _href, const string _name, const string _root, ObjectStore &_store ) :
     href( _href ),
     name( _name ),
@@ -63,6 +66,23 @@ FieldmlRegion::FieldmlRegion( const string _href, const string _name, const stri
 }
 
 
+FieldmlRegion::FieldmlRegion( const FieldmlRegion &other, ObjectStore &_store ) :
+    href( other.href ),
+    name( other.name ),
+    root( other.root ),
+    localObjects( other.localObjects ),
+    localObjectsByName( other.localObjectsByName ),
+    store( _store )
+{
+    imports.reserve( other.imports.size() );
+    for( vector<ImportInfo*>::const_iterator i = other.imports.begin(); i != other.imports.end(); i++ )
+    {
+        ImportInfo *import = *i;
+        imports.push_back( ( import == NULL ) ? NULL : new( store.getArena() ) ImportInfo( *import, store ) );
+    }
+}
+
+
 FieldmlRegion::~FieldmlRegion()
 {
     for_each( imports.begin(), imports.end(), FmlUtil::delete_object() );
@@ -97,42 +117,65 @@ void FieldmlRegion::setRoot( const string newRoot )
 }
 
 
-const string FieldmlRegion::getRoot()
+const string &FieldmlRegion::getRoot()
 {
     return root;
 }
 
 
-const string FieldmlRegion::getHref()
+const string &FieldmlRegion::getHref()
 {
     return href;
 }
 
 
-const string FieldmlRegion::getName()
+const string &FieldmlRegion::getName()
 {
     return name;
 }
 
 
+FmlObjectHandle FieldmlRegion::getLocalObjectByNameId( int nameId )
+{
+    if( ( nameId < 0 ) || ( nameId >= (int)localObjectsByName.size() ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    
+    return localObjectsByName[nameId];
+}
+
+
 void FieldmlRegion::addLocalObject( FmlObjectHandle handle )
 {
     localObjects.push_back( handle );
+    
+    FieldmlObject *object = store.getObject( handle );
+    if( object == NULL )
+    {
+        return;
+    }
+    
+    if( object->nameId >= (int)localObjectsByName.size() )
+    {
+        localObjectsByName.resize( object->nameId + 1, FML_INVALID_HANDLE );
+    }
+    if( localObjectsByName[object->nameId] == FML_INVALID_HANDLE )
+    {
+        localObjectsByName[object->nameId] = handle;
+    }
 }
 
 
 const bool FieldmlRegion::hasLocalObject( FmlObjectHandle handle, bool allowVirtual, bool allowImport )
 {
-    if( !allowVirtual )
+    FieldmlObject *object = store.getObject( handle );
+    if( ( !allowVirtual ) && ( object != NULL ) && ( object->isVirtual ) )
     {
-        FieldmlObject *object = store.getObject( handle );
-        if( ( object != NULL ) && ( object->isVirtual ) )
-        {
-            return false;
-        }
+        return false;
     }
     
-    if( FmlUtil::contains( localObjects, handle ) )
+    if( ( object != NULL ) && ( getLocalObjectByNameId( object->nameId ) == handle ) )
     {
         return true;
     }
@@ -161,13 +204,17 @@ const bool FieldmlRegion::hasLocalObject( FmlObjectHandle handle, bool allowVirt
 
 const FmlObjectHandle FieldmlRegion::getNamedObject( const string name )
 {
-    for( vector<FmlObjectHandle>::iterator i = localObjects.begin(); i != localObjects.end(); i++ )
+    int nameId = store.findName( name );
+    if( nameId == -1 )
     {
-        FieldmlObject *object = store.getObject( *i );
-        if( object->name == name )
-        {
-            return *i;
-        }
+        //Nothing has ever been given this name, locally or via an import.
+        return FML_INVALID_HANDLE;
+    }
+    
+    FmlObjectHandle handle = getLocalObjectByNameId( nameId );
+    if( handle != FML_INVALID_HANDLE )
+    {
+        return handle;
     }
     
     for( vector<ImportInfo*>::iterator i = imports.begin(); i != imports.end(); i++ )
@@ -179,7 +226,7 @@ const FmlObjectHandle FieldmlRegion::getNamedObject( const string name )
             continue;
         }
         
-        FmlObjectHandle object = info->getObject( name );
+        FmlObjectHandle object = info->getObject( nameId );
         if( object != FML_INVALID_HANDLE )
         {
             return object;
@@ -190,11 +237,11 @@ const FmlObjectHandle FieldmlRegion::getNamedObject( const string name )
 }
 
 
-const string FieldmlRegion::getObjectName( FmlObjectHandle handle )
+const string &FieldmlRegion::getObjectName( FmlObjectHandle handle )
 {
-    if( FmlUtil::contains( localObjects, handle ) )
+    FieldmlObject *object = store.getObject( handle );
+    if( ( object != NULL ) && ( getLocalObjectByNameId( object->nameId ) == handle ) )
     {
-        FieldmlObject *object = store.getObject( handle );
         return object->name;
     }
 
@@ -208,14 +255,14 @@ const string FieldmlRegion::getObjectName( FmlObjectHandle handle )
             continue;
         }
         
-        string name = info->getLocalName( handle );
+        const string &name = info->getLocalName( handle );
         if( name != "" )
         {
             return name;
         }
     }
     
-    return "";
+    return emptyName;
 }
 
 
@@ -228,7 +275,7 @@ void FieldmlRegion::addImportSource( int importSourceIndex, string href, string
     
     if( imports[importSourceIndex] == NULL )
     {
-        imports[importSourceIndex] = new ImportInfo( href, name );
+        imports[importSourceIndex] = new( store.getArena() ) ImportInfo( href, name, store );
     }
 }
 
@@ -322,3 +369,9 @@ FmlObjectHandle FieldmlRegion::getImportObject( int importSourceIndex, int impor
     
     return import->getObjectByIndex( importIndex );
 }
+
+
+size_t FieldmlRegion::getMemoryUsage() const
+{
+    return FmlUtil::memoryUsage( localObjects ) + FmlUtil::memoryUsage( localObjectsByName ) + FmlUtil::memoryUsage( imports );
+}
@@ -59,6 +59,13 @@ private:
     
     std::vector<FmlObjectHandle> localObjects;
     
+    /**
+     * Local objects, indexed by the id of their interned name.
+     */
+    std::vector<FmlObjectHandle> localObjectsByName;
+    
+    FmlObjectHandle getLocalObjectByNameId( int nameId );
+    
     std::vector<ImportInfo*> imports;
     
     ObjectStore &store;
@@ -67,6 +74,11 @@ private:
     
 public:
     FieldmlRegion( const std::string href, const std::string name, const std::string root, ObjectStore &_store );
+    
+    /**
+     * Copies the given region, including its imports, into the given store.
+     */
+    FieldmlRegion( const FieldmlRegion &other, ObjectStore &_store );
 
     virtual ~FieldmlRegion();
     
@@ -76,17 +88,21 @@ public:
 
     const FmlObjectHandle getNamedObject( const std::string name );
     
-    const std::string getObjectName( FmlObjectHandle handle );
+    /**
+     * \return The object's name in this region, or an empty string if it is neither local nor imported. The
+     * returned reference remains valid for the lifetime of the region's store.
+     */
+    const std::string &getObjectName( FmlObjectHandle handle );
     
     void setName( const std::string newName );
 
     void setRoot( const std::string newRoot );
 
-    const std::string getRoot();
+    const std::string &getRoot();
     
-    const std::string getHref();
+    const std::string &getHref();
 
-    const std::string getName();
+    const std::string &getName();
     
     const std::string getLibraryName();
 
@@ -109,6 +125,11 @@ public:
     const std::string getImportRemoteName( int importSourceIndex, int importIndex );
     
     FmlObjectHandle getImportObject( int importSourceIndex, int importIndex );
+    
+    /**
+     * The number of bytes allocated for the region's object lists.
+     */
+    size_t getMemoryUsage() const;
 };
 
 #endif //H_FIELDML_REGION
@@ -40,6 +40,8 @@
  */
 
 #include <algorithm>
+#include <cassert>
+#include <map>
 
 #include "string_const.h"
 #include "Util.h"
@@ -47,57 +49,304 @@
 #include "Evaluators.h"
 #include "FieldmlDOM.h"
 #include "FieldmlSession.h"
+#include "Image_InternalLibrary.h"
 #include "String_InternalLibrary.h"
 
 using namespace std;
 
 static vector<FieldmlSession *> sessions;
 
-FieldmlSession *FieldmlSession::handleToSession( FmlSessionHandle handle )
+static ReadWriteLock sessionsLock;
+
+
+/**
+ * The smallest number of entries a thread state table can grow to before it is pruned.
+ */
+static const size_t MIN_THREAD_STATE_PRUNE_SIZE = 16;
+
+
+/**
+ * A thread's states, which it owns, keyed by session handle. Session handles are never re-used, so the states of
+ * destroyed sessions are only ever pruned, never looked at.
+ */
+struct FieldmlSession::ThreadStateTable
 {
-    if( ( handle < 0 ) || ( (unsigned int)handle >= sessions.size() ) )
+    map<FmlSessionHandle, ThreadState*> states;
+    
+    /**
+     * The size at which the table is next pruned.
+     */
+    size_t pruneSize;
+    
+    ThreadStateTable() :
+        pruneSize( MIN_THREAD_STATE_PRUNE_SIZE )
     {
-        return NULL;
     }
     
-    return sessions.at( handle );
+    ~ThreadStateTable()
+    {
+        for( map<FmlSessionHandle, ThreadState*>::iterator i = states.begin(); i != states.end(); i++ )
+        {
+            delete i->second;
+        }
+    }
+};
+
+
+ThreadLocalPointer FieldmlSession::threadStateTables( FieldmlSession::deleteThreadStateTable );
+
+
+void FieldmlSession::deleteThreadStateTable( void *table )
+{
+    delete (ThreadStateTable*)table;
+}
+
+
+void FieldmlSession::pruneThreadStates( ThreadStateTable *table )
+{
+    //NOTE: A destroyed session can still be in use by the thread (e.g. by its own destructor), so only idle states go.
+    sessionsLock.lockShared();
+    
+    map<FmlSessionHandle, ThreadState*>::iterator i = table->states.begin();
+    while( i != table->states.end() )
+    {
+        ThreadState *state = i->second;
+        if( ( sessions[i->first] == NULL ) && ( state->lockDepth == 0 ) && ( state->contextDepth == 0 ) )
+        {
+            delete state;
+            table->states.erase( i++ );
+        }
+        else
+        {
+            i++;
+        }
+    }
+    
+    sessionsLock.unlockShared();
+    
+    table->pruneSize = max( MIN_THREAD_STATE_PRUNE_SIZE, 2 * table->states.size() );
+}
+
+
+FieldmlSession *FieldmlSession::acquireSession( FmlSessionHandle handle )
+{
+    //NOTE: The reference must be added before the registry lock is released, or the session could be deleted first.
+    sessionsLock.lockShared();
+    
+    FieldmlSession *session = NULL;
+    if( ( handle >= 0 ) && ( (unsigned int)handle < sessions.size() ) )
+    {
+        session = sessions[handle];
+    }
+    if( session != NULL )
+    {
+        session->references.increment();
+    }
+    
+    sessionsLock.unlockShared();
+    
+    return session;
 }
 
 
 FmlSessionHandle FieldmlSession::addSession( FieldmlSession *session )
 {
+    sessionsLock.lockExclusive();
+    
     sessions.push_back( session );
-    return sessions.size() - 1;
+    FmlSessionHandle handle = sessions.size() - 1;
+    
+    sessionsLock.unlockExclusive();
+    
+    return handle;
 }
 
 
 void FieldmlSession::removeSession( FmlSessionHandle handle )
 {
-    if( ( handle < 0 ) || ( (unsigned int)handle >= sessions.size() ) )
+    sessionsLock.lockExclusive();
+    
+    FieldmlSession *session = NULL;
+    if( ( handle >= 0 ) && ( (unsigned int)handle < sessions.size() ) )
     {
-        return;
+        session = sessions[handle];
+        sessions[handle] = NULL;
     }
     
-    delete sessions[handle];
-    sessions[handle] = NULL;
+    sessionsLock.unlockExclusive();
+    
+    if( session != NULL )
+    {
+        releaseSession( session );
+    }
 }
 
 
-FieldmlSession::FieldmlSession()
+void FieldmlSession::releaseSession( FieldmlSession *session )
+{
+    if( session->references.decrement() == 0 )
+    {
+        delete session;
+    }
+}
+
+
+FieldmlSession::ThreadState::ThreadState() :
+    lastError( FML_ERR_NO_ERROR ),
+    contextDepth( 0 ),
+    lockDepth( 0 ),
+    lockExclusive( false ),
+    lockHeld( false )
+{
+}
+
+
+FieldmlSession::FieldmlSession() :
+    lazyDocuments( NULL ),
+    frozen( 0 ),
+    references( 1 )
 {
     handle = addSession( this );
-    lastError = FML_ERR_NO_ERROR;
-    lastDescription = "";
+    debug = 0;
+    source = NULL;
+    cacheBytes = 0;
+    memberCacheBytes = 0;
+    validationLevel = FML_VALIDATION_SCHEMA;
+    lazyImports = false;
+    
+    region = NULL;
+}
+
+
+FieldmlSession::FieldmlSession( FieldmlSession *_source ) :
+    lazyDocuments( NULL ),
+    frozen( 0 ),
+    references( 1 ),
+    objects( &_source->objects )
+{
+    debug = _source->debug;
+    validationLevel = _source->validationLevel;
+    lazyImports = _source->lazyImports;
+    source = _source;
+    cacheBytes = 0;
+    memberCacheBytes = 0;
     
+    //NOTE: Region order must be preserved, as import source indexes are region indexes.
     region = NULL;
+    for( vector<FieldmlRegion*>::iterator i = source->regions.begin(); i != source->regions.end(); i++ )
+    {
+        FieldmlRegion *sourceRegion = *i;
+        if( sourceRegion == source->region )
+        {
+            region = new FieldmlRegion( *sourceRegion, objects );
+            regions.push_back( region );
+        }
+        else
+        {
+            regions.push_back( sourceRegion );
+            sharedRegions.push_back( sourceRegion );
+        }
+    }
+    
+    source->references.increment();
+    
+    handle = addSession( this );
 }
 
 
 FieldmlSession::~FieldmlSession()
 {
-    for_each( regions.begin(), regions.end(), FmlUtil::delete_object() );
+    closeLazyDocuments();
+    for( vector<FieldmlRegion*>::iterator i = regions.begin(); i != regions.end(); i++ )
+    {
+        if( !FmlUtil::contains( sharedRegions, *i ) )
+        {
+            delete *i;
+        }
+    }
+    for_each( dependencyCache.begin(), dependencyCache.end(), FmlUtil::delete_object() );
+    for_each( memberCache.begin(), memberCache.end(), FmlUtil::delete_object() );
+    
+    if( source != NULL )
+    {
+        releaseSession( source );
+    }
+}
+
+
+FieldmlSession::ThreadState *FieldmlSession::getThreadState()
+{
+    ThreadStateTable *table = (ThreadStateTable*)threadStateTables.get();
+    if( table == NULL )
+    {
+        table = new ThreadStateTable();
+        threadStateTables.set( table );
+    }
+    
+    map<FmlSessionHandle, ThreadState*>::iterator i = table->states.find( handle );
+    if( i != table->states.end() )
+    {
+        return i->second;
+    }
+    
+    if( table->states.size() >= table->pruneSize )
+    {
+        pruneThreadStates( table );
+    }
     
-    sessions[handle] = NULL;
+    ThreadState *state = new ThreadState();
+    table->states[handle] = state;
+    
+    return state;
+}
+
+
+void FieldmlSession::lock( bool exclusive )
+{
+    ThreadState *state = getThreadState();
+    if( state->lockDepth++ > 0 )
+    {
+        //NOTE: A shared lock cannot be upgraded, so a nested call that modifies the session must not be made from a
+        //call that only reads it.
+        assert( !exclusive || state->lockExclusive || !state->lockHeld );
+        return;
+    }
+    
+    state->lockExclusive = exclusive;
+    state->lockHeld = !isFrozen();
+    if( !state->lockHeld )
+    {
+        return;
+    }
+    
+    if( exclusive )
+    {
+        sessionLock.lockExclusive();
+    }
+    else
+    {
+        sessionLock.lockShared();
+    }
+}
+
+
+void FieldmlSession::unlock()
+{
+    ThreadState *state = getThreadState();
+    if( ( --state->lockDepth > 0 ) || !state->lockHeld )
+    {
+        return;
+    }
+    
+    if( state->lockExclusive )
+    {
+        objects.updateMemoryUsage();
+        sessionLock.unlockExclusive();
+    }
+    else
+    {
+        sessionLock.unlockShared();
+    }
 }
 
 
@@ -151,7 +400,13 @@ FieldmlRegion *FieldmlSession::getRegion( int index )
 }
 
 
-FieldmlRegion *FieldmlSession::addResourceRegion( string href, string name )
+int FieldmlSession::getRegionCount()
+{
+    return regions.size();
+}
+
+
+FieldmlRegion *FieldmlSession::addResourceRegion( string href, string name, bool streaming )
 {
     if( href.length() == 0 )
     {
@@ -167,20 +422,37 @@ FieldmlRegion *FieldmlSession::addResourceRegion( string href, string name )
     
     importHrefStack.push_back( href );
 
-    FieldmlRegion *resourceRegion = new FieldmlRegion( href, name, "", objects );
+    //NOTE: Imports are relative to the importing document, whose region's root is its directory.
     FieldmlRegion *currentRegion = region;
+    const string filename = makeFilename( ( currentRegion != NULL ) ? currentRegion->getRoot() : "", href );
+    const string root = ( href == FML_INTERNAL_LIBRARY_NAME ) ? "" : getDirectory( filename );
+    FieldmlRegion *resourceRegion = new FieldmlRegion( href, name, root, objects );
     region = resourceRegion;
     
     int result = 0;
+    FieldmlDOM::LazyDocument *lazyDocument = NULL;
     //TODO Go and fetch the actual document if possible.
     if( href == FML_INTERNAL_LIBRARY_NAME )
     {
-        result = FieldmlDOM::parseFieldmlString( FML_STRING_INTERNAL_LIBRARY, "Internal library", FML_INTERNAL_LIBRARY_NAME, this, getSessionHandle() );
+        //NOTE: The library is created from its precompiled image rather than by parsing FML_STRING_INTERNAL_LIBRARY.
+        result = LibraryImage::instantiate( FML_IMAGE_INTERNAL_LIBRARY, FML_IMAGE_INTERNAL_LIBRARY_LENGTH, this, getSessionHandle() );
     }
     else
     {
-        string filename = makeFilename( region->getRoot(), href );
-        result = FieldmlDOM::parseFieldmlFile( filename.c_str(), this, getSessionHandle() );
+        //NOTE: Only imported documents are read lazily. A session's own document is always read in full.
+        if( lazyImports && !streaming && ( currentRegion != NULL ) )
+        {
+            lazyDocument = FieldmlDOM::openLazyDocument( filename.c_str(), validationLevel, this, getSessionHandle() );
+            result = ( lazyDocument == NULL ) ? 1 : 0;
+        }
+        else if( streaming )
+        {
+            result = FieldmlDOM::parseFieldmlStream( filename.c_str(), validationLevel, this, getSessionHandle() );
+        }
+        else
+        {
+            result = FieldmlDOM::parseFieldmlFile( filename.c_str(), validationLevel, this, getSessionHandle() );
+        }
     }
     
     importHrefStack.pop_back();
@@ -189,43 +461,93 @@ FieldmlRegion *FieldmlSession::addResourceRegion( string href, string name )
 
     if( ( result != 0 ) || ( getErrorCount() != 0 ) )
     {
+        if( lazyDocument != NULL )
+        {
+            FieldmlDOM::closeLazyDocument( lazyDocument );
+        }
         delete resourceRegion;
         resourceRegion = NULL;
     }
     else
     {
         regions.push_back( resourceRegion );
+        if( lazyDocument != NULL )
+        {
+            lazyDocuments.set( resourceRegion, lazyDocument );
+        }
     }
     
     return resourceRegion;
 }
 
 
-void FieldmlSession::pushErrorContext( const char *file, const int line, const char *function )
+FmlObjectHandle FieldmlSession::getRegionObject( FieldmlRegion *importRegion, const string name )
+{
+    FmlObjectHandle object = importRegion->getNamedObject( name );
+    if( object != FML_INVALID_HANDLE )
+    {
+        return object;
+    }
+    
+    FieldmlDOM::LazyDocument *lazyDocument = lazyDocuments.get( importRegion, false );
+    if( lazyDocument == NULL )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    
+    //NOTE: The document's objects refer to each other by name, so they must be created in its own region.
+    FieldmlRegion *currentRegion = region;
+    region = importRegion;
+    FieldmlDOM::instantiateLazyObject( lazyDocument, name.c_str() );
+    region = currentRegion;
+    
+    return importRegion->getNamedObject( name );
+}
+
+
+void FieldmlSession::closeLazyDocuments()
 {
-    contextStack.push_back( pair<string, int>( string( function ) + string( ":" ) + string( file ), line ) );
+    while( lazyDocuments.size() > 0 )
+    {
+        FieldmlDOM::closeLazyDocument( lazyDocuments.getValue( 0 ) );
+        lazyDocuments.set( lazyDocuments.getKey( 0 ), NULL );
+    }
 }
 
 
-void FieldmlSession::popErrorContext()
+const string FieldmlSession::formatErrorContext( ThreadState *state, int index )
 {
-    contextStack.pop_back();
+    if( ( index < 0 ) || ( index >= state->contextDepth ) )
+    {
+        return "(unknown)";
+    }
+    if( index >= FML_ERROR_CONTEXT_DEPTH )
+    {
+        return "(untracked)";
+    }
+    
+    char line[32];
+    const ErrorContext &context = state->contextStack[index];
+    sprintf( line, ":%d", context.line );
+    
+    return string( context.function ) + ":" + context.file + line;
 }
 
 
 FmlErrorNumber FieldmlSession::setError( const FmlErrorNumber error, const string description )
 {
-    lastError = error;
-    lastDescription = description;
+    ThreadState *state = getThreadState();
+    state->lastError = error;
+    state->lastDescription = description;
     
     if( error != FML_ERR_NO_ERROR )
     {
         if( debug )
         {
             fprintf( stderr, "FIELDML %s (%s): Error %d: %s\n", FML_VERSION_STRING, __DATE__, error, description.c_str() );
-            for( unsigned int i = 0; i < contextStack.size(); i++ )
+            for( int i = 0; ( i < state->contextDepth ) && ( i < FML_ERROR_CONTEXT_DEPTH ); i++ )
             {
-                printf( "   at %s:%d\n", contextStack[i].first.c_str(), contextStack[i].second );
+                printf( "   at %s\n", formatErrorContext( state, i ).c_str() );
             }
         }
     }
@@ -236,9 +558,6 @@ FmlErrorNumber FieldmlSession::setError( const FmlErrorNumber error, const strin
 
 FmlErrorNumber FieldmlSession::setError( const FmlErrorNumber error, const FmlObjectHandle handle, const string description )
 {
-    lastError = error;
-    lastDescription = description;
-    
     FieldmlObject *object = getObject( handle );
     
     const string objectName = ( object != NULL ) ? object->name : "UNKNOWN";
@@ -249,24 +568,27 @@ FmlErrorNumber FieldmlSession::setError( const FmlErrorNumber error, const FmlOb
 
 void FieldmlSession::addError( const string string )
 {
+    MutexGuard guard( errorsLock );
     errors.push_back( string );
 }
 
 
 const FmlErrorNumber FieldmlSession::getLastError()
 {
-    return lastError;
+    return getThreadState()->lastError;
 }
 
 
 const int FieldmlSession::getErrorCount()
 {
+    MutexGuard guard( errorsLock );
     return errors.size();
 }
 
 
 const string FieldmlSession::getError( const int index )
 {
+    MutexGuard guard( errorsLock );
     if( ( index < 0 ) || ( (unsigned int)index >= errors.size() ) )
     {
         return NULL;
@@ -278,6 +600,7 @@ const string FieldmlSession::getError( const int index )
 
 void FieldmlSession::clearErrors()
 {
+    MutexGuard guard( errorsLock );
     errors.clear();
 }
 
@@ -299,7 +622,8 @@ void FieldmlSession::logError( const string error )
     addError( error );
     if( debug )
     {
-			fprintf( stderr, "FIELDML %s (%s): Error %s at %s:%d\n", FML_VERSION_STRING, __DATE__, error.c_str(), contextStack.back().first.c_str(), contextStack.back().second );
+        ThreadState *state = getThreadState();
+			fprintf( stderr, "FIELDML %s (%s): Error %s at %s\n", FML_VERSION_STRING, __DATE__, error.c_str(), formatErrorContext( state, state->contextDepth - 1 ).c_str() );
     }
         
 }
@@ -343,61 +667,208 @@ FieldmlObject *FieldmlSession::getObject( const FmlObjectHandle handle )
 }
 
 
-bool FieldmlSession::getDelegateEvaluators( const set<FmlObjectHandle> &evaluators, vector<FmlObjectHandle> &stack, set<FmlObjectHandle> &delegates )
+DependencyInfo::DependencyInfo() :
+    hasDelegates( false ),
+    computingDelegates( false ),
+    delegatesAcyclic( true ),
+    hasArguments( false ),
+    computingArguments( false )
+{
+}
+
+
+DependencyInfo *FieldmlSession::getDependencyInfo( FmlObjectHandle handle )
 {
-    for( set<FmlObjectHandle>::const_iterator i = evaluators.begin(); i != evaluators.end(); i++ )
+    if( handle >= (int)dependencyCache.size() )
     {
-        if( !getDelegateEvaluators( *i, stack, delegates ) )
-        {
-            return false;
-        }
-        delegates.insert( *i );
+        cacheBytes -= FmlUtil::memoryUsage( dependencyCache );
+        dependencyCache.resize( handle + 1, NULL );
+        cacheBytes += FmlUtil::memoryUsage( dependencyCache );
     }
-    return true;
+    
+    if( dependencyCache[handle] == NULL )
+    {
+        dependencyCache[handle] = new DependencyInfo();
+        cacheBytes += sizeof( DependencyInfo );
+    }
+    
+    return dependencyCache[handle];
 }
 
+
+void FieldmlSession::addDependent( DependencyInfo *info, FmlObjectHandle dependent )
+{
+    cacheBytes -= FmlUtil::memoryUsage( info->dependents );
+    info->dependents.insert( dependent );
+    cacheBytes += FmlUtil::memoryUsage( info->dependents );
+}
+
+
+/**
+ * Gets the evaluators that the given object directly delegates to, and records the
+ * given object as a dependent of each of them.
+ */
+bool FieldmlSession::getDirectDelegates( FmlObjectHandle handle, set<FmlObjectHandle> &delegates )
+{
+    Evaluator *evaluator = Evaluator::checkedCast( this, handle );
+    
+    if( ( evaluator == NULL ) || !evaluator->addDelegates( delegates ) )
+    {
+        return false;
+    }
+    
+    delegates.erase( FML_INVALID_HANDLE );
     
-bool FieldmlSession::getDelegateEvaluators( FmlObjectHandle handle, vector<FmlObjectHandle> &stack, set<FmlObjectHandle> &delegates )
+    for( set<FmlObjectHandle>::const_iterator i = delegates.begin(); i != delegates.end(); i++ )
+    {
+        addDependent( getDependencyInfo( *i ), handle );
+    }
+    
+    return true;
+}
+
+
+DependencyInfo *FieldmlSession::getDelegateInfo( FmlObjectHandle handle )
 {
-    set<FmlObjectHandle> evaluators;
+    DependencyInfo *info = getDependencyInfo( handle );
+    if( info->hasDelegates )
+    {
+        return info;
+    }
+    
+    info->computingDelegates = true;
+    info->delegatesAcyclic = true;
+    cacheBytes -= FmlUtil::memoryUsage( info->delegates );
+    info->delegates.clear();
+    
+    set<FmlObjectHandle> directDelegates;
+    getDirectDelegates( handle, directDelegates );
     
+    for( set<FmlObjectHandle>::const_iterator i = directDelegates.begin(); i != directDelegates.end(); i++ )
+    {
+        info->delegates.insert( *i );
+        
+        DependencyInfo *delegateInfo = getDependencyInfo( *i );
+        if( delegateInfo->computingDelegates )
+        {
+            //Recursive dependency!
+            info->delegatesAcyclic = false;
+            continue;
+        }
+        
+        delegateInfo = getDelegateInfo( *i );
+        info->delegates.insert( delegateInfo->delegates.begin(), delegateInfo->delegates.end() );
+        if( !delegateInfo->delegatesAcyclic )
+        {
+            info->delegatesAcyclic = false;
+        }
+    }
+    
+    info->computingDelegates = false;
+    info->hasDelegates = true;
+    cacheBytes += FmlUtil::memoryUsage( info->delegates );
+    
+    return info;
+}
+
+
+bool FieldmlSession::getDelegateEvaluators( FmlObjectHandle handle, set<FmlObjectHandle> &delegates )
+{
     if( handle == FML_INVALID_HANDLE )
     {
         //Convenience so that callers don't have to check
         return true;
     }
     
-    if( FmlUtil::contains( stack, handle ) )
+    if( isFrozen() )
     {
-        //Recursive dependency!
-        return false;
+        if( ( handle < 0 ) || ( handle >= (int)dependencyCache.size() ) )
+        {
+            return true;
+        }
+        
+        DependencyInfo *info = getDelegateInfo( handle );
+        delegates.insert( info->delegates.begin(), info->delegates.end() );
+        return info->delegatesAcyclic;
     }
     
-    //TODO: Figure out why this works even though there's no popping happening.
-    stack.push_back( handle );
+    MutexGuard guard( dependencyCacheLock );
     
-    Evaluator *evaluator = Evaluator::checkedCast( this, handle );
+    DependencyInfo *info = getDelegateInfo( handle );
+    
+    delegates.insert( info->delegates.begin(), info->delegates.end() );
+    
+    return info->delegatesAcyclic;
+}
+
+
+void FieldmlSession::invalidateDependencies( FmlObjectHandle handle )
+{
+    MutexGuard guard( dependencyCacheLock );
     
-    if( evaluator != NULL )
+    vector<FmlObjectHandle> pending;
+    pending.push_back( handle );
+    
+    while( !pending.empty() )
     {
-        if( evaluator->addDelegates( evaluators ) )
+        FmlObjectHandle current = pending.back();
+        pending.pop_back();
+        
+        if( ( current < 0 ) || ( current >= (int)dependencyCache.size() ) || ( dependencyCache[current] == NULL ) )
         {
-            if( !getDelegateEvaluators( evaluators, stack, delegates ) )
-            {
-                return false;
-            }
+            continue;
+        }
+        
+        DependencyInfo *info = dependencyCache[current];
+        info->hasDelegates = false;
+        info->hasArguments = false;
+        
+        //Dependents will re-register themselves when they are next recomputed.
+        pending.insert( pending.end(), info->dependents.begin(), info->dependents.end() );
+        cacheBytes -= FmlUtil::memoryUsage( info->dependents );
+        info->dependents.clear();
+    }
+}
+
+
+const EnsembleMembers *FieldmlSession::getEnsembleMembers( FmlObjectHandle handle, bool withIndex )
+{
+    MutexGuard guard( memberCacheLock );
+    
+    if( handle >= (int)memberCache.size() )
+    {
+        memberCacheBytes -= FmlUtil::memoryUsage( memberCache );
+        memberCache.resize( handle + 1, NULL );
+        memberCacheBytes += FmlUtil::memoryUsage( memberCache );
+    }
+    
+    if( memberCache[handle] == NULL )
+    {
+        memberCache[handle] = EnsembleMembers::create( this, handle );
+        if( memberCache[handle] != NULL )
+        {
+            memberCacheBytes += memberCache[handle]->getMemoryUsage();
         }
     }
     
-    return true;
+    if( withIndex && ( memberCache[handle] != NULL ) && !memberCache[handle]->isIndexed() )
+    {
+        memberCacheBytes -= memberCache[handle]->getMemoryUsage();
+        memberCache[handle]->buildIndex();
+        memberCacheBytes += memberCache[handle]->getMemoryUsage();
+    }
+    
+    return memberCache[handle];
 }
 
 
-bool FieldmlSession::getDelegateEvaluators( FmlObjectHandle handle, set<FmlObjectHandle> &delegates )
+void FieldmlSession::invalidateMembers()
 {
-    vector<FmlObjectHandle> stack;
+    MutexGuard guard( memberCacheLock );
     
-    return getDelegateEvaluators( handle, stack, delegates );
+    for_each( memberCache.begin(), memberCache.end(), FmlUtil::delete_object() );
+    memberCache.clear();
+    memberCacheBytes = 0;
 }
 
 
@@ -408,7 +879,7 @@ void FieldmlSession::mergeArguments( const SimpleMap<FmlObjectHandle, FmlObjectH
     {
         if( FmlUtil::contains( delegateUsed, i->first ) )
         {
-            getArguments( i->second, tmpUnbound, delegateUsed, true );
+            collectArguments( i->second, tmpUnbound, delegateUsed, true );
 
             ArgumentEvaluator *arg = (ArgumentEvaluator*)getObject( i->first );
             for( set<FmlObjectHandle>::const_iterator i = arg->arguments.begin(); i != arg->arguments.end(); i++ )
@@ -433,26 +904,44 @@ void FieldmlSession::mergeArguments( const SimpleMap<FmlObjectHandle, FmlObjectH
 }
 
 
-void FieldmlSession::getArguments( const set<FmlObjectHandle> &handles, set<FmlObjectHandle> &unbound, set<FmlObjectHandle> &used )
+void FieldmlSession::collectArguments( const set<FmlObjectHandle> &handles, set<FmlObjectHandle> &unbound, set<FmlObjectHandle> &used )
 {
     for( set<FmlObjectHandle>::const_iterator i = handles.begin(); i != handles.end(); i++ )
     {
-        getArguments( *i, unbound, used, true );
+        collectArguments( *i, unbound, used, true );
     }
 }
 
 
 void FieldmlSession::getArguments( FmlObjectHandle handle, set<FmlObjectHandle> &unbound, set<FmlObjectHandle> &used, bool addSelf )
 {
-    FieldmlObject *object = getObject( handle );
-    set<FmlObjectHandle> tmpUnbound, tmpUsed;
+    if( isFrozen() )
+    {
+        //All the information is already cached, so this is read-only.
+        collectArguments( handle, unbound, used, addSelf );
+        return;
+    }
+    
+    MutexGuard guard( dependencyCacheLock );
     
+    collectArguments( handle, unbound, used, addSelf );
+}
+
+
+void FieldmlSession::collectArguments( FmlObjectHandle handle, set<FmlObjectHandle> &unbound, set<FmlObjectHandle> &used, bool addSelf )
+{
     if( handle == FML_INVALID_HANDLE )
     {
         //Convenience so that callers don't have to check
         return;
     }
     
+    FieldmlObject *object = getObject( handle );
+    if( object == NULL )
+    {
+        return;
+    }
+    
     if( object->objectType == FHT_ARGUMENT_EVALUATOR )
     {
         if( addSelf )
@@ -470,26 +959,94 @@ void FieldmlSession::getArguments( FmlObjectHandle handle, set<FmlObjectHandle>
         used.insert( evaluator->arguments.begin(), evaluator->arguments.end() );
         unbound.insert( evaluator->arguments.begin(), evaluator->arguments.end() );
     }
-    else if( object->objectType == FHT_REFERENCE_EVALUATOR )
+    else if( ( object->objectType == FHT_REFERENCE_EVALUATOR ) ||
+        ( object->objectType == FHT_AGGREGATE_EVALUATOR ) ||
+        ( object->objectType == FHT_PIECEWISE_EVALUATOR ) ||
+        ( object->objectType == FHT_PARAMETER_EVALUATOR ) )
+    {
+        DependencyInfo *info = getArgumentInfo( handle );
+        
+        for( set<FmlObjectHandle>::const_iterator i = info->unboundRemoved.begin(); i != info->unboundRemoved.end(); i++ )
+        {
+            unbound.erase( *i );
+        }
+        unbound.insert( info->unbound.begin(), info->unbound.end() );
+        used.insert( info->used.begin(), info->used.end() );
+    }
+}
+
+
+/**
+ * Bound arguments are not delegates, but their own arguments affect the merged result.
+ */
+void FieldmlSession::addBindDependents( FmlObjectHandle handle, const SimpleMap<FmlObjectHandle, FmlObjectHandle> &binds )
+{
+    for( SimpleMap<FmlObjectHandle, FmlObjectHandle>::ConstIterator i = binds.begin(); i != binds.end(); i++ )
+    {
+        addDependent( getDependencyInfo( i->first ), handle );
+    }
+}
+
+
+DependencyInfo *FieldmlSession::getArgumentInfo( FmlObjectHandle handle )
+{
+    DependencyInfo *info = getDependencyInfo( handle );
+    if( info->hasArguments || info->computingArguments )
+    {
+        //NOTE: If we're already computing, there's a cycle, and the partial result will have to do.
+        return info;
+    }
+    
+    info->computingArguments = true;
+    cacheBytes -= FmlUtil::memoryUsage( info->unbound ) + FmlUtil::memoryUsage( info->unboundRemoved ) + FmlUtil::memoryUsage( info->used );
+    computeArguments( handle, info );
+    cacheBytes += FmlUtil::memoryUsage( info->unbound ) + FmlUtil::memoryUsage( info->unboundRemoved ) + FmlUtil::memoryUsage( info->used );
+    info->computingArguments = false;
+    info->hasArguments = true;
+    
+    return info;
+}
+
+
+void FieldmlSession::computeArguments( FmlObjectHandle handle, DependencyInfo *info )
+{
+    FieldmlObject *object = getObject( handle );
+    set<FmlObjectHandle> tmpUnbound, tmpUsed;
+    
+    set<FmlObjectHandle> &unbound = info->unbound;
+    set<FmlObjectHandle> &used = info->used;
+    
+    unbound.clear();
+    used.clear();
+    info->unboundRemoved.clear();
+    
+    set<FmlObjectHandle> directDelegates;
+    getDirectDelegates( handle, directDelegates );
+    
+    if( object->objectType == FHT_REFERENCE_EVALUATOR )
     {
         ReferenceEvaluator *evaluator = (ReferenceEvaluator*)object;
-        getArguments( evaluator->sourceEvaluator, tmpUnbound, tmpUsed, true );
+        addBindDependents( handle, evaluator->binds );
+        collectArguments( evaluator->sourceEvaluator, tmpUnbound, tmpUsed, true );
         mergeArguments( evaluator->binds, tmpUnbound, tmpUsed, unbound, used );
     }
     else if( object->objectType == FHT_AGGREGATE_EVALUATOR )
     {
         AggregateEvaluator *evaluator = (AggregateEvaluator*)object;
-        getArguments( evaluator->evaluators.getValues(), tmpUnbound, tmpUsed );
-        getArguments( evaluator->indexEvaluator, tmpUnbound, tmpUsed, true );
+        addBindDependents( handle, evaluator->binds );
+        collectArguments( evaluator->evaluators.getValues(), tmpUnbound, tmpUsed );
+        collectArguments( evaluator->indexEvaluator, tmpUnbound, tmpUsed, true );
         mergeArguments( evaluator->binds, tmpUnbound, tmpUsed, unbound, used );
         unbound.erase( evaluator->indexEvaluator );
         used.insert( evaluator->indexEvaluator );
+        info->unboundRemoved.insert( evaluator->indexEvaluator );
     }
     else if( object->objectType == FHT_PIECEWISE_EVALUATOR )
     {
         PiecewiseEvaluator *evaluator = (PiecewiseEvaluator*)object;
-        getArguments( evaluator->evaluators.getValues(), tmpUnbound, tmpUsed );
-        getArguments( evaluator->indexEvaluator, tmpUnbound, tmpUsed, true );
+        addBindDependents( handle, evaluator->binds );
+        collectArguments( evaluator->evaluators.getValues(), tmpUnbound, tmpUsed );
+        collectArguments( evaluator->indexEvaluator, tmpUnbound, tmpUsed, true );
         mergeArguments( evaluator->binds, tmpUnbound, tmpUsed, unbound, used );
     }
     else if( object->objectType == FHT_PARAMETER_EVALUATOR )
@@ -498,6 +1055,134 @@ void FieldmlSession::getArguments( FmlObjectHandle handle, set<FmlObjectHandle>
         set<FmlObjectHandle> indexEvaluators;
         evaluator->addDelegates( indexEvaluators );
         
-        getArguments( indexEvaluators, unbound, used );
+        collectArguments( indexEvaluators, unbound, used );
+        
+        //Index evaluators are applied directly to the caller's sets, so their removals are ours too.
+        for( set<FmlObjectHandle>::const_iterator i = indexEvaluators.begin(); i != indexEvaluators.end(); i++ )
+        {
+            FieldmlObject *indexObject = getObject( *i );
+            if( ( indexObject == NULL ) ||
+                ( indexObject->objectType == FHT_ARGUMENT_EVALUATOR ) ||
+                ( indexObject->objectType == FHT_EXTERNAL_EVALUATOR ) )
+            {
+                continue;
+            }
+            
+            DependencyInfo *indexInfo = getArgumentInfo( *i );
+            info->unboundRemoved.insert( indexInfo->unboundRemoved.begin(), indexInfo->unboundRemoved.end() );
+        }
+    }
+}
+
+
+void FieldmlSession::freeze()
+{
+    //NOTE: Objects can no longer be imported once the session is frozen, so uncreated objects are never needed.
+    closeLazyDocuments();
+    
+    MutexGuard guard( dependencyCacheLock );
+    
+    int count = objects.getCount();
+    dependencyCache.resize( count, NULL );
+    
+    for( FmlObjectHandle handle = 0; handle < count; handle++ )
+    {
+        FieldmlObject *object = getObject( handle );
+        DependencyInfo *info = getDependencyInfo( handle );
+        
+        //NOTE: Objects shared with a source session were compacted when it was frozen, and may be in use by other threads.
+        switch( objects.isShared( handle ) ? FHT_UNKNOWN : object->objectType )
+        {
+        case FHT_REFERENCE_EVALUATOR:
+            ( (ReferenceEvaluator*)object )->binds.compact();
+            objects.markChanged( handle );
+            break;
+        case FHT_PIECEWISE_EVALUATOR:
+            ( (PiecewiseEvaluator*)object )->binds.compact();
+            ( (PiecewiseEvaluator*)object )->evaluators.compact();
+            objects.markChanged( handle );
+            break;
+        case FHT_AGGREGATE_EVALUATOR:
+            ( (AggregateEvaluator*)object )->binds.compact();
+            ( (AggregateEvaluator*)object )->evaluators.compact();
+            objects.markChanged( handle );
+            break;
+        default:
+            break;
+        }
+        
+        switch( object->objectType )
+        {
+        case FHT_REFERENCE_EVALUATOR:
+        case FHT_PIECEWISE_EVALUATOR:
+        case FHT_AGGREGATE_EVALUATOR:
+        case FHT_PARAMETER_EVALUATOR:
+            getArgumentInfo( handle );
+            //Fall through
+        case FHT_CONSTANT_EVALUATOR:
+        case FHT_ARGUMENT_EVALUATOR:
+        case FHT_EXTERNAL_EVALUATOR:
+            getDelegateInfo( handle );
+            break;
+        default:
+            //Never consulted, but must not be computed lazily once frozen.
+            info->hasDelegates = true;
+            info->hasArguments = true;
+            break;
+        }
+    }
+    
+    //Nothing can be invalidated once frozen.
+    for( vector<DependencyInfo*>::iterator i = dependencyCache.begin(); i != dependencyCache.end(); i++ )
+    {
+        cacheBytes -= FmlUtil::memoryUsage( ( *i )->dependents );
+        ( *i )->dependents.clear();
+    }
+    
+    objects.compact();
+    
+    frozen.set( 1 );
+}
+
+
+bool FieldmlSession::isFrozen()
+{
+    return frozen.get() != 0;
+}
+
+
+size_t FieldmlSession::getMemoryUsage( FieldmlMemoryCategory category )
+{
+    switch( category )
+    {
+    case FML_MEMORY_TOTAL:
+        return getMemoryUsage( FML_MEMORY_OBJECTS ) + getMemoryUsage( FML_MEMORY_NAMES ) + getMemoryUsage( FML_MEMORY_MAPS ) +
+            getMemoryUsage( FML_MEMORY_BITSETS ) + getMemoryUsage( FML_MEMORY_INLINE_DATA ) + getMemoryUsage( FML_MEMORY_CACHES );
+    case FML_MEMORY_OBJECTS:
+    {
+        size_t usage = objects.getMemoryUsage( category );
+        for( vector<FieldmlRegion*>::const_iterator i = regions.begin(); i != regions.end(); i++ )
+        {
+            if( !FmlUtil::contains( sharedRegions, *i ) )
+            {
+                usage += ( *i )->getMemoryUsage();
+            }
+        }
+        return usage;
+    }
+    case FML_MEMORY_CACHES:
+    {
+        if( isFrozen() )
+        {
+            MutexGuard memberGuard( memberCacheLock );
+            return cacheBytes + memberCacheBytes;
+        }
+        
+        MutexGuard guard( dependencyCacheLock );
+        MutexGuard memberGuard( memberCacheLock );
+        return cacheBytes + memberCacheBytes;
+    }
+    default:
+        return objects.getMemoryUsage( category );
     }
 }
@@ -43,40 +43,202 @@
 #define H_FIELDML_SESSION
 
 #include <vector>
-#include <deque>
 #include <set>
 #include <utility>
 
+#include "EnsembleMembers.h"
+#include "FieldmlDOM.h"
 #include "FieldmlErrorHandler.h"
 #include "FieldmlRegion.h"
+#include "ThreadSupport.h"
+
+/**
+ * The maximum number of nested API call contexts recorded for error reports. Deeper calls are
+ * still tracked, but not reported.
+ */
+#define FML_ERROR_CONTEXT_DEPTH 32
+
+
+/**
+ * Memoized dependency information for a single object.
+ */
+class DependencyInfo
+{
+public:
+    bool hasDelegates;
+    bool computingDelegates;
+    bool delegatesAcyclic;
+    
+    /**
+     * The transitive closure of the evaluators this object delegates to.
+     */
+    std::set<FmlObjectHandle> delegates;
+    
+    bool hasArguments;
+    bool computingArguments;
+    
+    /**
+     * Applying this object's arguments to an (unbound, used) pair has the effect
+     * unbound = ( unbound - unboundRemoved ) + unbound, used = used + used.
+     */
+    std::set<FmlObjectHandle> unbound;
+    std::set<FmlObjectHandle> unboundRemoved;
+    std::set<FmlObjectHandle> used;
+    
+    /**
+     * The objects whose cached information was derived from this object's.
+     */
+    std::set<FmlObjectHandle> dependents;
+    
+    DependencyInfo();
+};
+
 
 class FieldmlSession :
     public FieldmlErrorHandler
 {
 private:
-    FmlErrorNumber lastError;
+    struct ErrorContext
+    {
+        const char *file;
+        int line;
+        const char *function;
+    };
     
-    std::string lastDescription;
+    /**
+     * The state of a single thread's use of the session. Each thread only ever sees its own.
+     */
+    struct ThreadState
+    {
+        FmlErrorNumber lastError;
+        
+        std::string lastDescription;
+        
+        //NOTE: Only static strings (i.e. __FILE__ and __FUNCTION__) are stored, so pushing is just a few assignments.
+        ErrorContext contextStack[FML_ERROR_CONTEXT_DEPTH];
+        
+        int contextDepth;
+        
+        /**
+         * The number of nested API calls holding the session lock. Only the outermost call actually
+         * acquires it.
+         */
+        int lockDepth;
+        
+        bool lockExclusive;
+        
+        /**
+         * False if the outermost call found the session frozen, and so did not acquire the lock.
+         */
+        bool lockHeld;
+        
+        ThreadState();
+    };
     
-    std::deque<std::pair<const std::string, const int> > contextStack;
+    struct ThreadStateTable;
+    
+    /**
+     * For each thread, a table of that thread's state for each session it has used.
+     */
+    static ThreadLocalPointer threadStateTables;
+    
+    static void deleteThreadStateTable( void *table );
+    
+    static void pruneThreadStates( ThreadStateTable *table );
+    
+    ThreadState *getThreadState();
+    
+    ReadWriteLock sessionLock;
+    
+    /**
+     * Guards the dependency cache, which is filled in by read-only queries.
+     */
+    Mutex dependencyCacheLock;
+    
+    /**
+     * Guards the member cache, which is filled in by read-only queries, even once the session is frozen.
+     */
+    Mutex memberCacheLock;
+    
+    Mutex errorsLock;
     
     int debug;
     
+    const std::string formatErrorContext( ThreadState *state, int index );
+    
     std::vector<std::string> errors;
     
     std::vector<FieldmlRegion*> regions;
     
+    /**
+     * Regions belonging to the source session, which this session refers to but does not own.
+     */
+    std::vector<FieldmlRegion*> sharedRegions;
+    
     std::vector<std::string> importHrefStack;
     
+    /**
+     * The documents of lazily imported regions, whose objects have not all been created yet. Discarded when the
+     * session is frozen.
+     */
+    SimpleMap<FieldmlRegion*, FieldmlDOM::LazyDocument*> lazyDocuments;
+    
+    void closeLazyDocuments();
+    
     FmlSessionHandle handle;
     
-    bool getDelegateEvaluators(  const std::set<FmlObjectHandle> &evaluators, std::vector<FmlObjectHandle> &stack, std::set<FmlObjectHandle> &set );
+    std::vector<DependencyInfo*> dependencyCache;
+    
+    /**
+     * The number of bytes held by the dependency cache. Guarded by the dependency cache lock.
+     */
+    size_t cacheBytes;
     
-    bool getDelegateEvaluators( FmlObjectHandle handle, std::vector<FmlObjectHandle> &stack, std::set<FmlObjectHandle> &set );
+    /**
+     * Decoded ensemble members, indexed by ensemble type handle.
+     */
+    std::vector<EnsembleMembers*> memberCache;
+    
+    /**
+     * The number of bytes held by the member cache. Guarded by the member cache lock.
+     */
+    size_t memberCacheBytes;
+    
+    /**
+     * Non-zero once frozen. Read by lock() before any lock is held, so setting it must publish everything the
+     * freeze wrote.
+     */
+    AtomicInt frozen;
+    
+    /**
+     * The frozen session this session was cloned from, if any.
+     */
+    FieldmlSession *source;
+    
+    /**
+     * The number of handles, API calls and clones keeping this session alive.
+     */
+    AtomicInt references;
+    
+    DependencyInfo *getDependencyInfo( FmlObjectHandle handle );
+    
+    void addDependent( DependencyInfo *info, FmlObjectHandle dependent );
+    
+    bool getDirectDelegates( FmlObjectHandle handle, std::set<FmlObjectHandle> &delegates );
+    
+    DependencyInfo *getDelegateInfo( FmlObjectHandle handle );
+    
+    DependencyInfo *getArgumentInfo( FmlObjectHandle handle );
+    
+    void computeArguments( FmlObjectHandle handle, DependencyInfo *info );
+    
+    void addBindDependents( FmlObjectHandle handle, const SimpleMap<FmlObjectHandle, FmlObjectHandle> &binds );
 
     void mergeArguments( const SimpleMap<FmlObjectHandle, FmlObjectHandle> &binds, std::set<FmlObjectHandle> &delegateUnbound, std::set<FmlObjectHandle> &delegateUsed, std::set<FmlObjectHandle> &unbound, std::set<FmlObjectHandle> &used );
     
-    void getArguments( const std::set<FmlObjectHandle> &handles, std::set<FmlObjectHandle> &unbound, std::set<FmlObjectHandle> &used );
+    void collectArguments( const std::set<FmlObjectHandle> &handles, std::set<FmlObjectHandle> &unbound, std::set<FmlObjectHandle> &used );
+    
+    void collectArguments( FmlObjectHandle handle, std::set<FmlObjectHandle> &unbound, std::set<FmlObjectHandle> &used, bool addSelf );
 
     static FmlSessionHandle addSession( FieldmlSession *session );
 
@@ -87,9 +249,40 @@ private:
 public:
     FieldmlSession();
     
-    void pushErrorContext( const char *file, const int line, const char *function );
+    /**
+     * Creates a session that shares the given frozen session's objects and imported regions. Shared
+     * objects are copied into the new session the first time they are modified.
+     */
+    FieldmlSession( FieldmlSession *_source );
+    
+    void pushErrorContext( const char *file, const int line, const char *function )
+    {
+        ThreadState *state = getThreadState();
+        if( state->contextDepth < FML_ERROR_CONTEXT_DEPTH )
+        {
+            ErrorContext &context = state->contextStack[state->contextDepth];
+            context.file = file;
+            context.line = line;
+            context.function = function;
+        }
+        state->contextDepth++;
+    }
+
 
-    void popErrorContext();
+    void popErrorContext()
+    {
+        getThreadState()->contextDepth--;
+    }
+    
+    /**
+     * Acquires the session lock for the calling thread, unless it already holds it. Any number of
+     * threads may hold the lock for reading at once.
+     * 
+     * \note A thread holding the lock for reading cannot upgrade it to writing.
+     */
+    void lock( bool exclusive );
+    
+    void unlock();
     
     FmlErrorNumber setError( const FmlErrorNumber error, const std::string errorDescription );
 
@@ -115,7 +308,11 @@ public:
     
     FieldmlObject *getObject( const FmlObjectHandle handle );
     
-    FieldmlRegion *addResourceRegion( std::string location, std::string name );
+    /**
+     * Reads the given document into a new region. If streaming is true, the document is read with
+     * FieldmlDOM::parseFieldmlStream rather than being parsed into a tree first.
+     */
+    FieldmlRegion *addResourceRegion( std::string location, std::string name, bool streaming = false );
     
     FieldmlRegion *addNewRegion( std::string location, std::string name );
     
@@ -125,15 +322,83 @@ public:
     
     FieldmlRegion *getRegion( int index );
     
+    int getRegionCount();
+    
+    /**
+     * \return The named object in the given region. If the region was imported lazily, the object is created first,
+     * along with the objects it refers to, if it has not yet been.
+     */
+    FmlObjectHandle getRegionObject( FieldmlRegion *importRegion, const std::string name );
+    
     FieldmlRegion *region;
+    
+    /**
+     * The level to which documents read into this session are checked.
+     */
+    FieldmlValidationLevel validationLevel;
+    
+    /**
+     * If true, documents imported into this session are only indexed when read, and each object is created when it is
+     * first imported.
+     */
+    bool lazyImports;
 
     ObjectStore objects;
 
     bool getDelegateEvaluators( FmlObjectHandle handle, std::set<FmlObjectHandle> &set );
     
+    /**
+     * Discards the memoized delegate and argument information for the given object, and for every
+     * object whose information was derived from it. Must be called whenever an object's delegates
+     * or arguments are changed.
+     */
+    void invalidateDependencies( FmlObjectHandle handle );
+    
     void getArguments( FmlObjectHandle handle, std::set<FmlObjectHandle> &unbound, std::set<FmlObjectHandle> &used, bool addSelf );
+    
+    /**
+     * \return The decoded members of the given ensemble type, decoding them if they are not already cached, or NULL
+     * (with the error set) if they cannot be decoded. The result remains valid until the session is next modified.
+     * If withIndex is true, the members' value-to-position index is also built.
+     */
+    const EnsembleMembers *getEnsembleMembers( FmlObjectHandle handle, bool withIndex = false );
+    
+    /**
+     * Discards all decoded ensemble members. Must be called whenever an ensemble type, or any data source or resource
+     * that member data could be read from, is changed.
+     */
+    void invalidateMembers();
+    
+    /**
+     * Precomputes all dependency information, compacts the session's containers and marks the session
+     * as frozen. The caller must hold the session lock exclusively, and must have validated the session.
+     */
+    void freeze();
+    
+    /**
+     * A frozen session is never modified, so it can be queried without locking.
+     */
+    bool isFrozen();
+    
+    /**
+     * \return The number of bytes held by the session in the given category.
+     * 
+     * \see Fieldml_GetMemoryUsage
+     */
+    size_t getMemoryUsage( FieldmlMemoryCategory category );
 
-    static FieldmlSession *handleToSession( FmlSessionHandle handle );
+    /**
+     * \return The session with the given handle, with a reference added so that it is not deleted until
+     * releaseSession is called, even if the handle is destroyed by another thread. NULL if the handle is invalid.
+     * 
+     * \see SessionReference
+     */
+    static FieldmlSession *acquireSession( FmlSessionHandle handle );
+    
+    /**
+     * Removes a reference added by acquireSession or by cloning, deleting the session if it was the last.
+     */
+    static void releaseSession( FieldmlSession *session );
     
     static void removeSession( FmlSessionHandle handle );
 };
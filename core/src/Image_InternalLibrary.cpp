@@ -0,0 +1,316 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <cstddef>
+
+#include "Image_InternalLibrary.h"
+
+const LibraryImageRecord FML_IMAGE_INTERNAL_LIBRARY[] =
+{
+    { LIBRARY_BOOLEAN_TYPE, "boolean", NULL, { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "boolean.argument", "boolean", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "real.1d", NULL, { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "real.1d.argument", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "real.2d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "real.2d.component", NULL, { 2, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "real.2d.component.argument", "real.2d.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "real.2d.argument", "real.2d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "real.3d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "real.3d.component", NULL, { 3, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "real.3d.component.argument", "real.3d.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "real.3d.argument", "real.3d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "chart.1d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "chart.1d.component", NULL, { 1, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.1d.component.argument", "chart.1d.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.1d.argument", "chart.1d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "chart.2d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "chart.2d.component", NULL, { 2, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.2d.component.argument", "chart.2d.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.2d.argument", "chart.2d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "chart.3d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "chart.3d.component", NULL, { 3, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.3d.component.argument", "chart.3d.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "chart.3d.argument", "chart.3d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "coordinates.rc.1d", NULL, { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "coordinates.rc.1d.argument", "coordinates.rc.1d", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "coordinates.rc.2d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "coordinates.rc.2d.component", NULL, { 2, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "coordinates.rc.2d.argument", "coordinates.rc.2d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "coordinates.rc.2d.component.argument", "coordinates.rc.2d.component", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "coordinates.rc.3d", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "coordinates.rc.3d.component", NULL, { 3, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "coordinates.rc.3d.argument", "coordinates.rc.3d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "coordinates.rc.3d.component.argument", "coordinates.rc.3d.component", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.1d.line2", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 2, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.1d.line2.argument", "localNodes.1d.line2", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.1d.unit.linearLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.1d.unit.linearLagrange.component", NULL, { 2, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.linearLagrange.component.argument", "parameters.1d.unit.linearLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.linearLagrange.argument", "parameters.1d.unit.linearLagrange", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.1d.unit.linearLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.linearLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.1d.line3", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 3, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.1d.line3.argument", "localNodes.1d.line3", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.1d.unit.quadraticLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.1d.unit.quadraticLagrange.component", NULL, { 3, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.quadraticLagrange.component.argument", "parameters.1d.unit.quadraticLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.quadraticLagrange.argument", "parameters.1d.unit.quadraticLagrange", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.1d.unit.quadraticLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.quadraticLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.1d.line4", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 4, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.1d.line4.argument", "localNodes.1d.line4", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.1d.unit.cubicLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.1d.unit.cubicLagrange.component", NULL, { 4, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.cubicLagrange.component.argument", "parameters.1d.unit.cubicLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.cubicLagrange.argument", "parameters.1d.unit.cubicLagrange", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.1d.unit.cubicLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.cubicLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.square2x2", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 4, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.square2x2.argument", "localNodes.2d.square2x2", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.bilinearLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.bilinearLagrange.component", NULL, { 4, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bilinearLagrange.argument", "parameters.2d.unit.bilinearLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bilinearLagrange.component.argument", "parameters.2d.unit.bilinearLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.bilinearLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bilinearLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.square3x3", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 9, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.square3x3.argument", "localNodes.2d.square3x3", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.biquadraticLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.biquadraticLagrange.component", NULL, { 9, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticLagrange.argument", "parameters.2d.unit.biquadraticLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticLagrange.component.argument", "parameters.2d.unit.biquadraticLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.biquadraticLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.biquadraticLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.square4x4", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 16, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.square4x4.argument", "localNodes.2d.square4x4", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.bicubicLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.bicubicLagrange.component", NULL, { 16, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bicubicLagrange.argument", "parameters.2d.unit.bicubicLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bicubicLagrange.component.argument", "parameters.2d.unit.bicubicLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.bicubicLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bicubicLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.cube2x2x2", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 8, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.cube2x2x2.argument", "localNodes.3d.cube2x2x2", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.trilinearLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.trilinearLagrange.component", NULL, { 8, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearLagrange.argument", "parameters.3d.unit.trilinearLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearLagrange.component.argument", "parameters.3d.unit.trilinearLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.trilinearLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.trilinearLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.cube3x3x3", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 27, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.cube3x3x3.argument", "localNodes.3d.cube3x3x3", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.triquadraticLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.triquadraticLagrange.component", NULL, { 27, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticLagrange.argument", "parameters.3d.unit.triquadraticLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticLagrange.component.argument", "parameters.3d.unit.triquadraticLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.triquadraticLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.triquadraticLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.cube4x4x4", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 64, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.cube4x4x4.argument", "localNodes.3d.cube4x4x4", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.tricubicLagrange", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.tricubicLagrange.component", NULL, { 64, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.tricubicLagrange.argument", "parameters.3d.unit.tricubicLagrange", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.tricubicLagrange.component.argument", "parameters.3d.unit.tricubicLagrange.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.tricubicLagrange", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.tricubicLagrange.argument", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.1d.unit.cubicHermite", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.1d.unit.cubicHermite.component", NULL, { 4, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.cubicHermite.argument", "parameters.1d.unit.cubicHermite", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.cubicHermite.component.argument", "parameters.1d.unit.cubicHermite.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.1d.unit.cubicHermiteScaling.argument", "parameters.1d.unit.cubicHermite", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.1d.unit.cubicHermite", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.cubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.1d.unit.cubicHermiteScaled", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.cubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.1d.unit.cubicHermiteScaling.argument", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.bicubicHermite", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.bicubicHermite.component", NULL, { 16, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bicubicHermite.argument", "parameters.2d.unit.bicubicHermite", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bicubicHermite.component.argument", "parameters.2d.unit.bicubicHermite.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bicubicHermiteScaling.argument", "parameters.2d.unit.bicubicHermite", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.bicubicHermite", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bicubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.bicubicHermiteScaled", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bicubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bicubicHermiteScaling.argument", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.tricubicHermite", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.tricubicHermite.component", NULL, { 64, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.tricubicHermite.argument", "parameters.3d.unit.tricubicHermite", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.tricubicHermite.component.argument", "parameters.3d.unit.tricubicHermite.component", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.tricubicHermiteScaling.argument", "parameters.3d.unit.tricubicHermite", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.tricubicHermite", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.tricubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.tricubicHermiteScaled", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.tricubicHermite.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.tricubicHermiteScaling.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.triangle3", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 3, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.triangle3.argument", "localNodes.2d.triangle3", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.bilinearSimplex", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.bilinearSimplex.component", NULL, { 3, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bilinearSimplex.argument", "parameters.2d.unit.bilinearSimplex", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.bilinearSimplex.component.argument", "parameters.2d.unit.bilinearSimplex.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.bilinearSimplex", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.bilinearSimplex.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.triangle6", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 6, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.triangle6.argument", "localNodes.2d.triangle6", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.biquadraticSimplex", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.biquadraticSimplex.component", NULL, { 6, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticSimplex.argument", "parameters.2d.unit.biquadraticSimplex", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticSimplex.component.argument", "parameters.2d.unit.biquadraticSimplex.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.biquadraticSimplex", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.biquadraticSimplex.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.2d.triangle6.vtk", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 6, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.2d.triangle6.vtk.argument", "localNodes.2d.triangle6.vtk", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.2d.unit.biquadraticSimplex.vtk", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.2d.unit.biquadraticSimplex.vtk.component", NULL, { 6, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticSimplex.vtk.argument", "parameters.2d.unit.biquadraticSimplex.vtk", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.2d.unit.biquadraticSimplex.vtk.component.argument", "parameters.2d.unit.biquadraticSimplex.vtk.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.2d.unit.biquadraticSimplex.vtk", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.2d.unit.biquadraticSimplex.vtk.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.tetrahedron4", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 4, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.tetrahedron4.argument", "localNodes.3d.tetrahedron4", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.trilinearSimplex", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.trilinearSimplex.component", NULL, { 4, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearSimplex.argument", "parameters.3d.unit.trilinearSimplex", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearSimplex.component.argument", "parameters.3d.unit.trilinearSimplex.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.trilinearSimplex", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.trilinearSimplex.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.wedge12_6", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 6, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.wedge12_6.argument", "localNodes.3d.wedge12_6", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.trilinearWedge12", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.trilinearWedge12.component", NULL, { 6, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearWedge12.argument", "parameters.3d.unit.trilinearWedge12", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.trilinearWedge12.component.argument", "parameters.3d.unit.trilinearWedge12.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.trilinearWedge12", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.trilinearWedge12.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.tetrahedron10", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 10, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.tetrahedron10.argument", "localNodes.3d.tetrahedron10", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.triquadraticSimplex", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.triquadraticSimplex.component", NULL, { 10, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.argument", "parameters.3d.unit.triquadraticSimplex", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.component.argument", "parameters.3d.unit.triquadraticSimplex.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.triquadraticSimplex", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.triquadraticSimplex.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.tetrahedron10.vtk", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 10, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.tetrahedron10.vtk.argument", "localNodes.3d.tetrahedron10.vtk", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.triquadraticSimplex.vtk", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.triquadraticSimplex.vtk.component", NULL, { 10, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.vtk.argument", "parameters.3d.unit.triquadraticSimplex.vtk", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.vtk.component.argument", "parameters.3d.unit.triquadraticSimplex.vtk.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.triquadraticSimplex.vtk", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.triquadraticSimplex.vtk.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.tetrahedron10.zienkiewicz", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 10, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.tetrahedron10.zienkiewicz.argument", "localNodes.3d.tetrahedron10.zienkiewicz", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.triquadraticSimplex.zienkiewicz", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.triquadraticSimplex.zienkiewicz.component", NULL, { 10, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.zienkiewicz.argument", "parameters.3d.unit.triquadraticSimplex.zienkiewicz", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticSimplex.zienkiewicz.component.argument", "parameters.3d.unit.triquadraticSimplex.zienkiewicz.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.triquadraticSimplex.zienkiewicz", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.triquadraticSimplex.zienkiewicz.argument", { 0, 0, 0 } },
+    { LIBRARY_ENSEMBLE_TYPE, "localNodes.3d.wedge12_18", NULL, { 0, 0, 0 } },
+    { LIBRARY_MEMBERS_RANGE, NULL, NULL, { 1, 18, 1 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "localNodes.3d.wedge12_18.argument", "localNodes.3d.wedge12_18", { 0, 0, 0 } },
+    { LIBRARY_CONTINUOUS_TYPE, "parameters.3d.unit.triquadraticWedge12", NULL, { 0, 0, 0 } },
+    { LIBRARY_TYPE_COMPONENTS, "parameters.3d.unit.triquadraticWedge12.component", NULL, { 18, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticWedge12.argument", "parameters.3d.unit.triquadraticWedge12", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT_EVALUATOR, "parameters.3d.unit.triquadraticWedge12.component.argument", "parameters.3d.unit.triquadraticWedge12.component", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "interpolator.3d.unit.triquadraticWedge12", "real.1d", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "parameters.3d.unit.triquadraticWedge12.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.line", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.1d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.square", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.triangle", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.2d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.cube", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.tetrahedron", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.wedge12", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.wedge23", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+    { LIBRARY_EXTERNAL_EVALUATOR, "shape.unit.wedge13", "boolean", { 0, 0, 0 } },
+    { LIBRARY_ARGUMENT, NULL, "chart.3d.argument", { 0, 0, 0 } },
+};
+
+const int FML_IMAGE_INTERNAL_LIBRARY_LENGTH = sizeof( FML_IMAGE_INTERNAL_LIBRARY ) / sizeof( LibraryImageRecord );
@@ -39,24 +39,15 @@
  *
  */
 
-#include "ErrorContextAutostack.h"
+#ifndef H_IMAGE_INTERNAL_LIBRARY_H
+#define H_IMAGE_INTERNAL_LIBRARY_H
 
-using namespace std;
-
-ErrorContextAutostack::ErrorContextAutostack( FieldmlSession *_errorSession, const char *file, const int line, const char *function ) :
-    errorSession( _errorSession )
-{
-    if( errorSession != NULL )
-    {
-        errorSession->pushErrorContext( file, line, function );
-    }
-}
+#include "LibraryImage.h"
 
+/**
+ * The precompiled image of FML_STRING_INTERNAL_LIBRARY, generated by LibraryToImage.py.
+ */
+extern const LibraryImageRecord FML_IMAGE_INTERNAL_LIBRARY[];
+extern const int FML_IMAGE_INTERNAL_LIBRARY_LENGTH;
 
-ErrorContextAutostack::~ErrorContextAutostack()
-{
-    if( errorSession != NULL )
-    {
-        errorSession->popErrorContext();
-    }
-}
+#endif // H_IMAGE_INTERNAL_LIBRARY_H
@@ -48,24 +48,27 @@
 
 using namespace std;
 
-class ObjectImport
+static const string emptyName;
+
+class ObjectImport :
+    public ArenaObject
 {
 public:
-    const string localName;
+    const string &localName;
     
-    const string remoteName;
+    const string &remoteName;
     
     const FmlObjectHandle handle;
     
-    ObjectImport( string _localName, string _remoteName, FmlObjectHandle _handle );
+    ObjectImport( const InternedName &_localName, const InternedName &_remoteName, FmlObjectHandle _handle );
     
     virtual ~ObjectImport();
 };
 
 
-ObjectImport::ObjectImport( string _localName, string _remoteName, FmlObjectHandle _handle ) :
-    localName( _localName ),
-    remoteName( _remoteName ),
+ObjectImport::ObjectImport( const InternedName &_localName, const InternedName &_remoteName, FmlObjectHandle _handle ) :
+    localName( _localName.value ),
+    remoteName( _remoteName.value ),
     handle( _handle )
 {
 }
@@ -76,35 +79,42 @@ ObjectImport::~ObjectImport()
 }
 
 
-ImportInfo::ImportInfo( string _href, string _name ) :
+ImportInfo::ImportInfo( string _href, string _name, ObjectStore &_store ) :
+    store( _store ),
+    importsByName( FML_INVALID_HANDLE ),
     href( _href ),
     name( _name )
 {
 }
 
 
+ImportInfo::ImportInfo( const ImportInfo &other, ObjectStore &_store ) :
+    store( _store ),
+    importsByName( other.importsByName ),
+    href( other.href ),
+    name( other.name )
+{
+    imports.reserve( other.imports.size() );
+    for( vector<ObjectImport*>::const_iterator i = other.imports.begin(); i != other.imports.end(); i++ )
+    {
+        imports.push_back( new( store.getArena() ) ObjectImport( **i ) );
+    }
+}
+
+
 ImportInfo::~ImportInfo()
 {
     for_each( imports.begin(), imports.end(), FmlUtil::delete_object() );
 }
 
 
-FmlObjectHandle ImportInfo::getObject( string localName )
+FmlObjectHandle ImportInfo::getObject( int localNameId )
 {
-    for( vector<ObjectImport*>::iterator i = imports.begin(); i != imports.end(); i++ )
-    {
-        ObjectImport *import = *i;
-        if( import->localName == localName )
-        {
-            return import->handle;
-        }
-    }
-    
-    return FML_INVALID_HANDLE;
+    return importsByName.get( localNameId, false );
 }
 
 
-const string ImportInfo::getLocalName( FmlObjectHandle handle )
+const string &ImportInfo::getLocalName( FmlObjectHandle handle )
 {
     for( vector<ObjectImport*>::iterator i = imports.begin(); i != imports.end(); i++ )
     {
@@ -115,7 +125,7 @@ const string ImportInfo::getLocalName( FmlObjectHandle handle )
         }
     }
     
-    return "";
+    return emptyName;
 }
 
 
@@ -141,7 +151,13 @@ void ImportInfo::addImport( string localName, string remoteName, FmlObjectHandle
         return;
     }
     
-    imports.push_back( new ObjectImport( localName, remoteName, handle ) );
+    const InternedName internedLocalName = store.internName( localName );
+    
+    imports.push_back( new( store.getArena() ) ObjectImport( internedLocalName, store.internName( remoteName ), handle ) );
+    if( importsByName.get( internedLocalName.id, false ) == FML_INVALID_HANDLE )
+    {
+        importsByName.set( internedLocalName.id, handle );
+    }
 }
 
 
@@ -44,21 +44,42 @@
 
 #include <vector>
 
+#include "ObjectArena.h"
+#include "ObjectStore.h"
+#include "SimpleMap.h"
+
 class ObjectImport;
 
-class ImportInfo
+class ImportInfo :
+    public ArenaObject
 {
 private:
+    ObjectStore &store;
+    
     std::vector<ObjectImport*> imports;
     
+    /**
+     * Imported object handles, keyed by the id of their interned local name.
+     */
+    SimpleMap<int, FmlObjectHandle> importsByName;
+    
 public:
-    ImportInfo( std::string _href, std::string name );
+    ImportInfo( std::string _href, std::string name, ObjectStore &_store );
+    
+    /**
+     * Copies the given import info into the given store.
+     */
+    ImportInfo( const ImportInfo &other, ObjectStore &_store );
 
     virtual ~ImportInfo();
     
-    FmlObjectHandle getObject( std::string localName );
+    FmlObjectHandle getObject( int localNameId );
     
-    const std::string getLocalName( FmlObjectHandle handle );
+    /**
+     * \return The local name of the given object, or an empty string if it was not imported via this import.
+     * The returned reference remains valid for the lifetime of the store.
+     */
+    const std::string &getLocalName( FmlObjectHandle handle );
     
     void addImport( std::string localName, std::string remoteName, FmlObjectHandle handle );
     
@@ -0,0 +1,122 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include "LibraryImage.h"
+
+int LibraryImage::instantiate( const LibraryImageRecord *records, int recordCount, FieldmlErrorHandler *errorHandler, FmlSessionHandle session )
+{
+    FmlObjectHandle type = FML_INVALID_HANDLE;
+    FmlObjectHandle evaluator = FML_INVALID_HANDLE;
+    
+    for( int i = 0; i < recordCount; i++ )
+    {
+        const LibraryImageRecord &record = records[i];
+        
+        switch( record.operation )
+        {
+        case LIBRARY_BOOLEAN_TYPE:
+            if( Fieldml_CreateBooleanType( session, record.name ) == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "BooleanType creation failed", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_CONTINUOUS_TYPE:
+            type = Fieldml_CreateContinuousType( session, record.name );
+            if( type == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "ContinuousType creation failed", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_TYPE_COMPONENTS:
+            if( Fieldml_CreateContinuousTypeComponents( session, type, record.name, record.values[0] ) == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "ContinuousType has invalid component specification", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_ENSEMBLE_TYPE:
+            type = Fieldml_CreateEnsembleType( session, record.name );
+            if( type == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "EnsembleType creation failed", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_MEMBERS_RANGE:
+            if( Fieldml_SetEnsembleMembersRange( session, type, record.values[0], record.values[1], record.values[2] ) != FML_ERR_NO_ERROR )
+            {
+                errorHandler->logError( "EnsembleType has invalid range specification", type );
+                return 1;
+            }
+            break;
+        case LIBRARY_ARGUMENT_EVALUATOR:
+            evaluator = Fieldml_CreateArgumentEvaluator( session, record.name, Fieldml_GetObjectByName( session, record.reference ) );
+            if( evaluator == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "Cannot create ArgumentEvaluator with given type", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_EXTERNAL_EVALUATOR:
+            evaluator = Fieldml_CreateExternalEvaluator( session, record.name, Fieldml_GetObjectByName( session, record.reference ) );
+            if( evaluator == FML_INVALID_HANDLE )
+            {
+                errorHandler->logError( "ExternalEvaluator creation failed", record.name );
+                return 1;
+            }
+            break;
+        case LIBRARY_ARGUMENT:
+            if( Fieldml_AddArgument( session, evaluator, Fieldml_GetObjectByName( session, record.reference ) ) != FML_ERR_NO_ERROR )
+            {
+                errorHandler->logError( "Bad argument", record.reference );
+                return 1;
+            }
+            break;
+        default:
+            errorHandler->logError( "Unknown library image record" );
+            return 1;
+        }
+    }
+    
+    return 0;
+}
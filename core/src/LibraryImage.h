@@ -0,0 +1,87 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_LIBRARY_IMAGE
+#define H_LIBRARY_IMAGE
+
+#include "fieldml_api.h"
+#include "FieldmlErrorHandler.h"
+
+enum LibraryImageOperation
+{
+    LIBRARY_BOOLEAN_TYPE,           //Creates a boolean type with the given name.
+    LIBRARY_CONTINUOUS_TYPE,        //Creates a continuous type with the given name.
+    LIBRARY_TYPE_COMPONENTS,        //Gives the last continuous type values[0] components, with the given name.
+    LIBRARY_ENSEMBLE_TYPE,          //Creates an ensemble type with the given name.
+    LIBRARY_MEMBERS_RANGE,          //Sets the members of the last ensemble type to the range values[0..2].
+    LIBRARY_ARGUMENT_EVALUATOR,     //Creates an argument evaluator with the given name, and the referenced value type.
+    LIBRARY_EXTERNAL_EVALUATOR,     //Creates an external evaluator with the given name, and the referenced value type.
+    LIBRARY_ARGUMENT                //Adds the referenced argument to the last evaluator.
+};
+
+
+/**
+ * One step in creating the objects of a precompiled library. Records are generated from the library's document by
+ * LibraryToImage.py.
+ */
+struct LibraryImageRecord
+{
+    LibraryImageOperation operation;
+    
+    const char *name;
+    
+    const char *reference;
+    
+    int values[3];
+};
+
+
+namespace LibraryImage
+{
+    /**
+     * Creates the objects described by the given records in the session's current region. The records make the same
+     * API calls, in the same order, as FieldmlDOM would when parsing the library's document, so the objects and
+     * their handles are the same. The image is not validated, as its document was valid when it was generated.
+     */
+    int instantiate( const LibraryImageRecord *records, int recordCount, FieldmlErrorHandler *errorHandler, FmlSessionHandle session );
+}
+
+#endif //H_LIBRARY_IMAGE
@@ -0,0 +1,136 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "ObjectArena.h"
+
+using namespace std;
+
+static const size_t BLOCK_SIZE = 32 * 1024;
+
+//Allocations larger than this get a block to themselves.
+static const size_t LARGE_ALLOCATION_SIZE = BLOCK_SIZE / 4;
+
+static const size_t ALIGNMENT = 2 * sizeof( double );
+
+
+ObjectArena::ObjectArena() :
+    current( NULL ),
+    remaining( 0 ),
+    allocatedBytes( 0 ),
+    reservedBytes( 0 ),
+    allocationCount( 0 )
+{
+}
+
+
+ObjectArena::~ObjectArena()
+{
+    for( vector<char *>::iterator i = blocks.begin(); i != blocks.end(); i++ )
+    {
+        free( *i );
+    }
+}
+
+
+char *ObjectArena::newBlock( size_t size )
+{
+    char *block = (char *)malloc( size );
+    if( block == NULL )
+    {
+        throw bad_alloc();
+    }
+    
+    blocks.push_back( block );
+    reservedBytes += size;
+    
+    return block;
+}
+
+
+void *ObjectArena::allocate( size_t size )
+{
+    size = ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+    if( size == 0 )
+    {
+        size = ALIGNMENT;
+    }
+    
+    allocatedBytes += size;
+    allocationCount++;
+    
+    if( size > LARGE_ALLOCATION_SIZE )
+    {
+        return newBlock( size );
+    }
+    
+    if( size > remaining )
+    {
+        current = newBlock( BLOCK_SIZE );
+        remaining = BLOCK_SIZE;
+    }
+    
+    void *ptr = current;
+    current += size;
+    remaining -= size;
+    
+    return ptr;
+}
+
+
+size_t ObjectArena::getAllocatedBytes() const
+{
+    return allocatedBytes;
+}
+
+
+size_t ObjectArena::getReservedBytes() const
+{
+    return reservedBytes;
+}
+
+
+int ObjectArena::getAllocationCount() const
+{
+    return allocationCount;
+}
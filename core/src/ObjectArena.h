@@ -0,0 +1,123 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_OBJECT_ARENA
+#define H_OBJECT_ARENA
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A simple bump allocator. Memory is handed out from large blocks, and is only released
+ * (all at once) when the arena itself is destroyed.
+ */
+class ObjectArena
+{
+private:
+    std::vector<char *> blocks;
+    
+    char *current;
+    
+    size_t remaining;
+    
+    size_t allocatedBytes;
+    
+    size_t reservedBytes;
+    
+    int allocationCount;
+    
+    ObjectArena( const ObjectArena & );
+    
+    ObjectArena &operator=( const ObjectArena & );
+    
+    char *newBlock( size_t size );
+
+public:
+    ObjectArena();
+    
+    virtual ~ObjectArena();
+    
+    void *allocate( size_t size );
+    
+    /**
+     * The number of bytes handed out by the arena.
+     */
+    size_t getAllocatedBytes() const;
+    
+    /**
+     * The number of bytes the arena has obtained from the system.
+     */
+    size_t getReservedBytes() const;
+    
+    int getAllocationCount() const;
+};
+
+
+/**
+ * Base class for objects that live in an ObjectArena. They must be created with
+ * new( arena ) T(...). Deleting them runs their destructor as usual, but their
+ * memory is only reclaimed when the arena is destroyed.
+ * 
+ * \note There is no free list, so the memory of an object that is deleted early (e.g. a
+ * replaced data description, or an object discarded after a failed read) stays allocated
+ * until its session is destroyed. Code that repeatedly replaces arena objects in a
+ * long-lived session should reuse them instead.
+ */
+class ArenaObject
+{
+public:
+    static void *operator new( size_t size, ObjectArena &arena )
+    {
+        return arena.allocate( size );
+    }
+    
+    
+    static void operator delete( void * /*ptr*/, ObjectArena & /*arena*/ )
+    {
+    }
+    
+    
+    static void operator delete( void * /*ptr*/ )
+    {
+    }
+};
+
+#endif //H_OBJECT_ARENA
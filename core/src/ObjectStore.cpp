@@ -48,23 +48,156 @@
 
 using namespace std;
 
-ObjectStore::ObjectStore()
+static const size_t CHANGED_CAPACITY_LIMIT = 1024;
+
+
+ObjectStore::ObjectStore() :
+    base( NULL ),
+    baseCount( 0 ),
+    copies( NULL )
 {
+    fill( contentUsage, contentUsage + FML_MEMORY_CACHES + 1, 0 );
 }
 
+
+ObjectStore::ObjectStore( ObjectStore *_base ) :
+    base( _base ),
+    baseCount( _base->getCount() ),
+    names( &_base->names ),
+    copies( NULL )
+{
+    fill( contentUsage, contentUsage + FML_MEMORY_CACHES + 1, 0 );
+}
+
+
 ObjectStore::~ObjectStore()
 {
     for_each( objects.begin(), objects.end(), FmlUtil::delete_object() );
+    
+    for( SimpleMap<FmlObjectHandle, FieldmlObject *>::ConstIterator i = copies.begin(); i != copies.end(); i++ )
+    {
+        delete i->second;
+    }
 }
 
+ObjectArena &ObjectStore::getArena()
+{
+    return arena;
+}
+
+
+const InternedName ObjectStore::internName( const string &name )
+{
+    return names.intern( name );
+}
+
+
+int ObjectStore::findName( const string &name )
+{
+    return names.find( name );
+}
+
+
 FieldmlObject *ObjectStore::getObject( FmlObjectHandle handle )
 {
-    if( ( handle < 0 ) || ( handle >= (int)objects.size() ) )
+    if( handle >= baseCount )
+    {
+        if( handle - baseCount >= (int)objects.size() )
+        {
+            return NULL;
+        }
+        
+        return objects[handle - baseCount];
+    }
+    
+    if( handle < 0 )
     {
         return NULL;
     }
     
-    return objects[handle];
+    if( copies.size() > 0 )
+    {
+        FieldmlObject *copy = copies.get( handle, false );
+        if( copy != NULL )
+        {
+            return copy;
+        }
+    }
+    
+    return base->getObject( handle );
+}
+
+
+FieldmlObject *ObjectStore::getWritableObject( FmlObjectHandle handle )
+{
+    if( ( handle < 0 ) || ( handle >= baseCount ) )
+    {
+        FieldmlObject *object = getObject( handle );
+        if( object != NULL )
+        {
+            markChanged( handle );
+        }
+        
+        return object;
+    }
+    
+    FieldmlObject *copy = copies.get( handle, false );
+    if( copy == NULL )
+    {
+        copy = base->getObject( handle )->clone( arena );
+        copy->accountedSize = 0;
+        copies.set( handle, copy );
+        
+        if( copy->objectType == FHT_DATA_RESOURCE )
+        {
+            copyDataSources( (DataResource*)copy );
+        }
+    }
+    markChanged( handle );
+    
+    return copy;
+}
+
+
+void ObjectStore::copyDataSources( DataResource *resource )
+{
+    for( vector<FmlObjectHandle>::const_iterator i = resource->dataSources.begin(); i != resource->dataSources.end(); i++ )
+    {
+        //NOTE: Data sources created in this store already refer to the copied resource.
+        if( ( *i < 0 ) || ( *i >= baseCount ) )
+        {
+            continue;
+        }
+        
+        //NOTE: An existing copy keeps any changes made to it, and its memory is already accounted here.
+        FieldmlObject *previous = copies.get( *i, false );
+        FieldmlObject *object = ( previous != NULL ) ? previous : base->getObject( *i );
+        if( ( object == NULL ) || ( object->objectType != FHT_DATA_SOURCE ) )
+        {
+            continue;
+        }
+        
+        DataSource *copy = ( (DataSource*)object )->cloneForResource( arena, resource );
+        if( previous == NULL )
+        {
+            copy->accountedSize = 0;
+        }
+        
+        copies.set( *i, copy );
+        delete previous;
+        markChanged( *i );
+    }
+}
+
+
+bool ObjectStore::isShared( FmlObjectHandle handle )
+{
+    if( ( handle < 0 ) || ( handle >= baseCount ) )
+    {
+        return false;
+    }
+    
+    return copies.get( handle, false ) == NULL;
 }
 
 
@@ -72,24 +205,97 @@ FmlObjectHandle ObjectStore::addObject( FieldmlObject *object )
 {
     //TODO Uniqueness check
     objects.push_back( object );
-    return objects.size() - 1;
+    
+    FmlObjectHandle handle = baseCount + objects.size() - 1;
+    markChanged( handle );
+    
+    if( object->nameId >= (int)objectsByName.size() )
+    {
+        objectsByName.resize( object->nameId + 1, FML_INVALID_HANDLE );
+    }
+    if( ( object->nameId >= 0 ) && ( objectsByName[object->nameId] == FML_INVALID_HANDLE ) )
+    {
+        objectsByName[object->nameId] = handle;
+    }
+    
+    return handle;
 }
 
 
 int ObjectStore::getCount()
 {
-    return objects.size();
+    return baseCount + objects.size();
+}
+
+
+void ObjectStore::compact()
+{
+    vector<FieldmlObject *>( objects ).swap( objects );
+    vector<FmlObjectHandle>( objectsByName ).swap( objectsByName );
+}
+
+
+void ObjectStore::markChanged( FmlObjectHandle handle )
+{
+    //NOTE: Setters usually touch the same object repeatedly, so only consecutive duplicates are worth skipping.
+    if( changed.empty() || ( changed.back() != handle ) )
+    {
+        changed.push_back( handle );
+    }
+}
+
+
+void ObjectStore::updateMemoryUsage()
+{
+    for( vector<FmlObjectHandle>::const_iterator i = changed.begin(); i != changed.end(); i++ )
+    {
+        FieldmlObject *object = getObject( *i );
+        size_t size = object->getContentSize();
+        size_t &usage = contentUsage[object->getContentCategory()];
+        
+        usage = usage - object->accountedSize + size;
+        object->accountedSize = size;
+    }
+    
+    //NOTE: Bulk loads can touch many objects under a single lock, so don't hang on to a large list.
+    if( changed.capacity() > CHANGED_CAPACITY_LIMIT )
+    {
+        vector<FmlObjectHandle>().swap( changed );
+    }
+    else
+    {
+        changed.clear();
+    }
+}
+
+
+size_t ObjectStore::getMemoryUsage( FieldmlMemoryCategory category )
+{
+    switch( category )
+    {
+    case FML_MEMORY_OBJECTS:
+        return arena.getReservedBytes() + FmlUtil::memoryUsage( objects ) + copies.getMemoryUsage() + FmlUtil::memoryUsage( changed ) +
+            FmlUtil::memoryUsage( objectsByName );
+    case FML_MEMORY_NAMES:
+        return names.getMemoryUsage();
+    case FML_MEMORY_MAPS:
+    case FML_MEMORY_BITSETS:
+    case FML_MEMORY_INLINE_DATA:
+        return contentUsage[category];
+    default:
+        return 0;
+    }
 }
 
 
 int ObjectStore::getCount( FieldmlHandleType type )
 {
     int count = 0;
+    int total = getCount();
     
-    for( vector<FieldmlObject*>::iterator i = objects.begin(); i != objects.end(); i++ )
+    for( int i = 0; i < total; i++ )
     {
-        FieldmlObject *object = *i;
-        if( object->objectType == type )
+        if( getObject( i )->objectType == type )
         {
             count++;
         }
@@ -101,7 +307,7 @@ int ObjectStore::getCount( FieldmlHandleType type )
 
 FmlObjectHandle ObjectStore::getObjectByIndex( int index )
 {
-    if( ( index <= 0 ) || ( (unsigned int)index > objects.size() ) )
+    if( ( index <= 0 ) || ( index > getCount() ) )
     {
         return FML_INVALID_HANDLE;
     }
@@ -118,11 +324,11 @@ FmlObjectHandle ObjectStore::getObjectByIndex( int index, FieldmlHandleType type
     }
     
     int count = 0;
+    int total = getCount();
     
-    for( unsigned int i = 0; i < objects.size(); i++ )
+    for( int i = 0; i < total; i++ )
     {
-        FieldmlObject *object = objects[i];
-        if( object->objectType == type )
+        if( getObject( i )->objectType == type )
         {
             count++;
             if( count == index )
@@ -138,14 +344,26 @@ FmlObjectHandle ObjectStore::getObjectByIndex( int index, FieldmlHandleType type
 
 FmlObjectHandle ObjectStore::getObjectByName( const string name )
 {
-    for( unsigned int i = 0; i < objects.size(); i++ )
+    return getObjectByNameId( names.find( name ) );
+}
+
+
+FmlObjectHandle ObjectStore::getObjectByNameId( int nameId )
+{
+    //NOTE: Base objects have lower handles, so they take precedence. Copies of them keep their names.
+    if( base != NULL )
     {
-        FieldmlObject *object = objects[i];
-        if( object->name == name )
+        FmlObjectHandle handle = base->getObjectByNameId( nameId );
+        if( handle != FML_INVALID_HANDLE )
         {
-            return i;
+            return handle;
         }
     }
     
-    return FML_INVALID_HANDLE;
+    if( ( nameId < 0 ) || ( nameId >= (int)objectsByName.size() ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    
+    return objectsByName[nameId];
 }
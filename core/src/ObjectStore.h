@@ -45,19 +45,86 @@
 #include <vector>
 
 #include "fieldml_structs.h"
+#include "ObjectArena.h"
+#include "SimpleMap.h"
+#include "StringTable.h"
 
+/**
+ * Owns a session's objects. A store may be layered over the store of a frozen session,
+ * in which case the base store's objects are shared (and keep their handles) until they
+ * are modified, at which point they are copied into this store.
+ */
 class ObjectStore
 {
 private:
+    ObjectArena arena;
+    
+    ObjectStore * const base;
+    
+    const int baseCount;
+    
+    StringTable names;
+    
+    //NOTE: Only holds objects created in this store. They are indexed by handle - baseCount.
     std::vector<FieldmlObject *> objects;
     
+    //This store's private copies of base objects, keyed by handle.
+    SimpleMap<FmlObjectHandle, FieldmlObject *> copies;
+    
+    /**
+     * The first object created in this store with each name, indexed by the id of its interned name.
+     */
+    std::vector<FmlObjectHandle> objectsByName;
+    
+    //Objects whose contents may have changed size since they were last accounted.
+    std::vector<FmlObjectHandle> changed;
+    
+    //NOTE: Indexed by FieldmlMemoryCategory. Only the object content categories are used.
+    size_t contentUsage[FML_MEMORY_CACHES + 1];
+    
+    void copyDataSources( DataResource *resource );
+    
+    FmlObjectHandle getObjectByNameId( int nameId );
+    
 public:
     ObjectStore();
     
+    /**
+     * Creates a store layered over the given base, which must outlive it and must not change.
+     */
+    ObjectStore( ObjectStore *_base );
+    
     virtual ~ObjectStore();
     
+    /**
+     * The arena from which this store's objects (and their owned sub-objects) should be allocated.
+     */
+    ObjectArena &getArena();
+    
+    /**
+     * Interns the given object name in this store's string table.
+     */
+    const InternedName internName( const std::string &name );
+    
+    /**
+     * \return The id of the given name, or -1 if no object or import has ever used it.
+     */
+    int findName( const std::string &name );
+    
     FieldmlObject *getObject( FmlObjectHandle handle );
     
+    /**
+     * As getObject, but if the object is shared with the base store, it is first replaced
+     * by a private copy. Copying a data resource also copies its data sources, as they
+     * refer to it directly.
+     */
+    FieldmlObject *getWritableObject( FmlObjectHandle handle );
+    
+    /**
+     * \return True if the given object belongs to the base store, and has not been copied.
+     */
+    bool isShared( FmlObjectHandle handle );
+    
     FmlObjectHandle addObject( FieldmlObject *object );
     
     int getCount();
@@ -69,6 +136,29 @@ public:
     FmlObjectHandle getObjectByIndex( int index, FieldmlHandleType type );
     
     FmlObjectHandle getObjectByName( const std::string name );
+    
+    /**
+     * Releases any spare capacity in the store's own containers.
+     */
+    void compact();
+    
+    /**
+     * Notes that the given object's contents may have changed size. Objects that are added to the
+     * store or fetched via getWritableObject are noted automatically.
+     */
+    void markChanged( FmlObjectHandle handle );
+    
+    /**
+     * Re-accounts the contents of any objects that have changed since the last update. The caller
+     * must hold the session lock exclusively.
+     */
+    void updateMemoryUsage();
+    
+    /**
+     * \return The number of bytes held by this store in the given category, as of the last update.
+     * Objects and names shared with the base store are not included.
+     */
+    size_t getMemoryUsage( FieldmlMemoryCategory category );
 };
 
 #endif //H_OBJECT_STORE
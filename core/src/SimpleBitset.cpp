@@ -45,285 +45,238 @@
 
 using namespace std;
 
-static const int BITS_PER_CHUNK = 256;
-
 static const int BITS_PER_INT = 32;
 
-static const int INTS_PER_CHUNK = BITS_PER_CHUNK / BITS_PER_INT; 
-
-/**
- * BitChunk - A helper class we don't want to expose to the outside world.
- */
-class BitChunk
-{
-public:
-    int bitCount;
-    
-    BitChunk( int _firstBit );
-    
-    void set( int bitNumber, bool state );
-    
-    bool get( int bitNumber );
-    
-    void clear();
-    
-    const int firstBit;
-    
-    unsigned int bits[INTS_PER_CHUNK];
-};
-
+static const int BITS_PER_BLOCK = 256;
 
-BitChunk::BitChunk( int _firstBit ) :
-    firstBit( _firstBit )
-{
-    clear();
-}
+static const int INTS_PER_BLOCK = BITS_PER_BLOCK / BITS_PER_INT; 
 
 
-void BitChunk::set( int bitNumber, bool state )
+static int countBits( unsigned int word )
 {
-    int chunkBit = bitNumber & (BITS_PER_CHUNK-1);
-    
-    int chunkInt = chunkBit / BITS_PER_INT;
-    
-    int intBit = chunkBit & (BITS_PER_INT-1);
-    
-    bool oldState = ( bits[chunkInt] & ( 1 << intBit ) ) != 0;
-    
-    if( state && !oldState )
-    {
-        bits[chunkInt] |= ( 1 << intBit );
-        bitCount++;
-    }
-    else if( oldState && !state )
-    {
-        bits[chunkInt] &= ~( 1 << intBit );
-        bitCount--;
-    }
+#if defined( __GNUC__ )
+    return __builtin_popcount( word );
+#else
+    word = word - ( ( word >> 1 ) & 0x55555555 );
+    word = ( word & 0x33333333 ) + ( ( word >> 2 ) & 0x33333333 );
+    word = ( word + ( word >> 4 ) ) & 0x0F0F0F0F;
+    return ( word * 0x01010101 ) >> 24;
+#endif
 }
 
 
-bool BitChunk::get( int bitNumber )
-{
-    int chunkBit = bitNumber & (BITS_PER_CHUNK-1);
-    
-    int chunkInt = chunkBit / BITS_PER_INT;
-    
-    int intBit = chunkBit & (BITS_PER_INT-1);
-    
-    return ( bits[chunkInt] & ( 1 << intBit ) ) != 0;
-}
-
-
-void BitChunk::clear()
+/**
+ * Returns the index of the lowest set bit. The word must be non-zero.
+ */
+static int lowestBit( unsigned int word )
 {
-    bitCount = 0;
-
-    for( int i = 0; i < INTS_PER_CHUNK; i++ )
+#if defined( __GNUC__ )
+    return __builtin_ctz( word );
+#else
+    int bit = 0;
+    while( ( word & 1 ) == 0 )
     {
-        bits[i] = 0;
+        word >>= 1;
+        bit++;
     }
+    return bit;
+#endif
 }
 
 
-SimpleBitset::SimpleBitset()
+SimpleBitset::SimpleBitset() :
+    rankIndexValid( true ),
+    trueCount( 0 )
 {
 }
 
 
 SimpleBitset::~SimpleBitset()
 {
-    BitChunk *chunk;
-    for( list<BitChunk *>::iterator i = chunks.begin(); i != chunks.end(); i++ )
-    {
-        chunk = *i;
-        delete chunk;
-    }
 }
 
 
-BitChunk *SimpleBitset::getChunk( int bitNumber, bool create )
+void SimpleBitset::updateRankIndex()
 {
-    if( bitNumber < 0 )
+    if( rankIndexValid )
     {
-        return NULL;
+        return;
     }
     
-    BitChunk *chunk = NULL;
-    list<BitChunk *>::iterator i;
-    for( i = chunks.begin(); i != chunks.end(); i++ )
-    {
-        chunk = *i;
-        if( ( bitNumber >= chunk->firstBit ) && ( bitNumber < chunk->firstBit + BITS_PER_CHUNK ) )
-        {
-            return chunk;
-        }
-        if( bitNumber < chunk->firstBit )
-        {
-            break;
-        }
-    }
+    int blockCount = ( words.size() + INTS_PER_BLOCK - 1 ) / INTS_PER_BLOCK;
+    rankIndex.resize( blockCount );
     
-    if( create )
+    int count = 0;
+    for( int i = 0; i < (int)words.size(); i++ )
     {
-        int chunkFirst = bitNumber & ~(BITS_PER_CHUNK-1); 
-        chunk = new BitChunk( chunkFirst );
-        if( i == chunks.begin() )
-        {
-            chunks.push_front( chunk );
-        }
-        else
+        if( ( i % INTS_PER_BLOCK ) == 0 )
         {
-            chunks.insert( i, chunk );
+            rankIndex[i / INTS_PER_BLOCK] = count;
         }
+        count += countBits( words[i] );
     }
     
-    return chunk;
+    rankIndexValid = true;
 }
 
 
-BitChunk *SimpleBitset::getNextChunk( int bitNumber )
+void SimpleBitset::setBit( int bitNumber, bool state )
 {
     if( bitNumber < 0 )
     {
-        return NULL;
+        return;
     }
     
-    BitChunk *bestChunk = NULL;
-    BitChunk *chunk = NULL;
-    for( list<BitChunk *>::iterator i = chunks.begin(); i != chunks.end(); i++ )
+    unsigned int wordIndex = bitNumber / BITS_PER_INT;
+    unsigned int mask = 1u << ( bitNumber & ( BITS_PER_INT - 1 ) );
+    
+    if( wordIndex >= words.size() )
     {
-        chunk = *i;
-        if( chunk->firstBit + BITS_PER_CHUNK - 1 < bitNumber )
+        if( !state )
         {
-            continue;
-        }
-        else if( ( bestChunk == NULL ) || ( chunk->firstBit < bestChunk->firstBit ) )
-        {
-            bestChunk = chunk;
+            //Asked to set a non-existant bit to 'false'. That's easy.
+            return;
         }
+        
+        //Grow in whole blocks so that the rank index stays aligned.
+        words.resize( ( wordIndex / INTS_PER_BLOCK + 1 ) * INTS_PER_BLOCK, 0 );
     }
     
-    return bestChunk;
-}
-
-
-void SimpleBitset::setBit( int bitNumber, bool state )
-{
-    BitChunk *chunk = getChunk( bitNumber, state );
-    if( chunk == NULL )
+    bool oldState = ( words[wordIndex] & mask ) != 0;
+    if( state == oldState )
     {
-        //Asked to set a non-existant bit to 'false'. That's easy.
         return;
     }
     
-    chunk->set( bitNumber, state );
+    if( state )
+    {
+        words[wordIndex] |= mask;
+        trueCount++;
+    }
+    else
+    {
+        words[wordIndex] &= ~mask;
+        trueCount--;
+    }
+    
+    rankIndexValid = false;
 }
 
 
 bool SimpleBitset::getBit( int bitNumber )
 {
-    BitChunk *chunk = getChunk( bitNumber, false );
-    if( chunk == NULL )
+    if( bitNumber < 0 )
     {
         return false;
     }
     
-    return chunk->get( bitNumber );
+    unsigned int wordIndex = bitNumber / BITS_PER_INT;
+    if( wordIndex >= words.size() )
+    {
+        return false;
+    }
+    
+    return ( words[wordIndex] & ( 1u << ( bitNumber & ( BITS_PER_INT - 1 ) ) ) ) != 0;
 }
 
 
 int SimpleBitset::getCount()
 {
-    int count = 0;
-    BitChunk *chunk;
-    for( list<BitChunk *>::iterator i = chunks.begin(); i != chunks.end(); i++ )
-    {
-        chunk = *i;
-        count += chunk->bitCount;
-    }
-    
-    return count;
+    return trueCount;
 }
 
 
 void SimpleBitset::clear()
 {
-    BitChunk *chunk;
-    for( list<BitChunk *>::iterator i = chunks.begin(); i != chunks.end(); i++ )
-    {
-        chunk = *i;
-        chunk->clear();
-    }
-    
+    words.clear();
+    rankIndex.clear();
+    rankIndexValid = true;
+    trueCount = 0;
 }
 
 
 int SimpleBitset::getNextTrueBit( int bitNumber )
 {
-    BitChunk *chunk;
+    if( bitNumber < 0 )
+    {
+        return -1;
+    }
+    
+    unsigned int wordIndex = bitNumber / BITS_PER_INT;
+    if( wordIndex >= words.size() )
+    {
+        return -1;
+    }
+    
+    //Mask off the bits below bitNumber in the first word.
+    unsigned int word = words[wordIndex] & ( ~0u << ( bitNumber & ( BITS_PER_INT - 1 ) ) );
     
     while( true )
     {
-        chunk = getNextChunk( bitNumber );
-        
-        if( chunk == NULL )
+        if( word != 0 )
         {
-            return -1;
-        }
-        
-        if( chunk->bitCount == 0 )
-        {
-            continue;
+            return ( wordIndex * BITS_PER_INT ) + lowestBit( word );
         }
         
-        for( ; bitNumber < chunk->firstBit + BITS_PER_CHUNK; bitNumber++ )
+        wordIndex++;
+        if( wordIndex >= words.size() )
         {
-            if( chunk->get( bitNumber ) )
-            {
-                return bitNumber;
-            }
+            return -1;
         }
+        word = words[wordIndex];
     }
 }
 
 
 int SimpleBitset::getTrueBit( int bitCount )
 {
-    //This code is a little inefficient, but should do for now.
-    int bitCounter = 0;
-    BitChunk *chunk = NULL;
-    BitChunk *goodChunk = NULL;
-    for( list<BitChunk *>::iterator i = chunks.begin(); i != chunks.end(); i++ )
+    if( ( bitCount <= 0 ) || ( bitCount > trueCount ) )
     {
-        chunk = *i;
-        if( ( bitCounter < bitCount ) && ( chunk->bitCount + bitCounter >= bitCount ) )
-        {
-            goodChunk = chunk;
-            break;
-        }
-        bitCounter += chunk->bitCount;
+        return -1;
     }
     
-    if( goodChunk == NULL )
+    updateRankIndex();
+    
+    //Find the last block that has fewer than bitCount bits preceding it.
+    int low = 0;
+    int high = rankIndex.size() - 1;
+    while( low < high )
     {
-        return -1;
+        int middle = ( low + high + 1 ) / 2;
+        if( rankIndex[middle] < bitCount )
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
     }
     
-    bitCount -= bitCounter;
-    int bitNumber = chunk->firstBit;
-    
-    for( ; bitNumber < chunk->firstBit + BITS_PER_CHUNK; bitNumber++ )
+    int remaining = bitCount - rankIndex[low];
+    for( int wordIndex = low * INTS_PER_BLOCK; wordIndex < (int)words.size(); wordIndex++ )
     {
-        if( chunk->get( bitNumber ) )
+        unsigned int word = words[wordIndex];
+        int wordCount = countBits( word );
+        if( wordCount < remaining )
         {
-            bitCount--;
-            if( bitCount == 0 )
-            {
-                return bitNumber;
-            }
+            remaining -= wordCount;
+            continue;
         }
+        
+        //Drop the lowest remaining-1 set bits, then the next set bit is the one we want.
+        for( ; remaining > 1; remaining-- )
+        {
+            word &= word - 1;
+        }
+        return ( wordIndex * BITS_PER_INT ) + lowestBit( word );
     }
     
     return -1;
 }
+
+
+size_t SimpleBitset::getMemoryUsage() const
+{
+    return ( words.capacity() * sizeof( unsigned int ) ) + ( rankIndex.capacity() * sizeof( int ) );
+}
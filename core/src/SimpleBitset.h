@@ -42,18 +42,29 @@
 #ifndef H_SIMPLE_BITSET
 #define H_SIMPLE_BITSET
 
-#include <list>
-
-class BitChunk;
+#include <cstddef>
+#include <vector>
 
+/**
+ * A growable bitset stored as a contiguous array of words. Set bits are counted as they change,
+ * and a per-block rank index is (lazily) maintained so that getTrueBit does not have to scan
+ * the whole array.
+ */
 class SimpleBitset
 {
 private:
-    std::list<BitChunk *> chunks;
+    std::vector<unsigned int> words;
+    
+    /**
+     * rankIndex[i] is the number of set bits preceding block i. Only valid if rankIndexValid.
+     */
+    std::vector<int> rankIndex;
     
-    BitChunk *getChunk( int bitNumber, bool create );
+    bool rankIndexValid;
     
-    BitChunk *getNextChunk( int bitNumber );
+    int trueCount;
+    
+    void updateRankIndex();
     
 public:
     SimpleBitset();
@@ -71,6 +82,11 @@ public:
     virtual int getNextTrueBit( int bitNumber );
     
     virtual int getTrueBit( int bitCount );
+    
+    /**
+     * The number of bytes allocated for the bitset's words and rank index.
+     */
+    size_t getMemoryUsage() const;
 };
 
 #endif //H_SIMPLE_BITSET
@@ -42,9 +42,18 @@
 #ifndef H_SIMPLE_MAP
 #define H_SIMPLE_MAP
 
+#include <cstddef>
 #include <vector>
 #include <set>
+#include <algorithm>
 
+/**
+ * An ordered map from keys to values, stored as a key-sorted vector of pairs. Lookups are
+ * a binary search, and keys that arrive in ascending order (the usual case when reading
+ * element maps) are appended without shifting. Index-based access is in key order.
+ * 
+ * Setting a key to either the invalid value or the default value removes it from the map.
+ */
 template <typename K, typename V> class SimpleMap
 {
     typedef std::pair<K,V> PairType;
@@ -57,27 +66,30 @@ private:
     
     std::vector<PairType> pairs;
     
-    typename std::vector<PairType>::const_iterator find( K key ) const
+    static bool keyLess( const PairType &a, const PairType &b )
     {
-        for( ConstIterator i = pairs.begin(); i != pairs.end(); i++ )
-        {
-            if( i->first == key )
-            {
-                return i;
-            }
-        }
-        
-        return pairs.end();
+        return a.first < b.first;
     }
-
-    typename std::vector<PairType>::iterator find( K key )
+    
+    
+    typename std::vector<PairType>::const_iterator lowerBound( K key ) const
+    {
+        return std::lower_bound( pairs.begin(), pairs.end(), PairType( key, invalidValue ), keyLess );
+    }
+    
+    
+    typename std::vector<PairType>::iterator lowerBound( K key )
+    {
+        return std::lower_bound( pairs.begin(), pairs.end(), PairType( key, invalidValue ), keyLess );
+    }
+    
+    
+    typename std::vector<PairType>::const_iterator find( K key ) const
     {
-        for( Iterator i = pairs.begin(); i != pairs.end(); i++ )
+        typename std::vector<PairType>::const_iterator i = lowerBound( key );
+        if( ( i != pairs.end() ) && ( i->first == key ) )
         {
-            if( i->first == key )
-            {
-                return i;
-            }
+            return i;
         }
         
         return pairs.end();
@@ -135,31 +147,107 @@ public:
     
     V set( K key, V value )
     {
-        Iterator iter = find( key );
+        bool isRemoval = ( value == invalidValue ) || ( value == defaultValue );
         
-        if( iter == end() )
+        if( pairs.empty() || ( pairs.back().first < key ) )
         {
-            if( ( value != invalidValue ) && ( value != defaultValue ) )
+            if( !isRemoval )
             {
                 pairs.push_back( PairType( key, value ) );
             }
             return invalidValue;
         }
+        
+        Iterator iter = lowerBound( key );
+        
+        if( iter->first != key )
+        {
+            if( !isRemoval )
+            {
+                pairs.insert( iter, PairType( key, value ) );
+            }
+            return invalidValue;
+        }
+        else if( isRemoval )
+        {
+            pairs.erase( iter );
+            return invalidValue;
+        }
         else
         {
-            if( ( value == invalidValue ) || ( value == defaultValue ) )
+            V previousValue = iter->second;
+            iter->second = value;
+            
+            return previousValue;
+        }
+    }
+    
+    
+    /**
+     * Sets all the given key/value pairs. The new pairs are sorted once and merged with the
+     * existing contents, so this is O((n + m) log m) rather than O(nm) for m individual sets.
+     * If a key is given more than once, the last occurrence wins.
+     */
+    void setAll( const std::vector<PairType> &newPairs )
+    {
+        if( newPairs.empty() )
+        {
+            return;
+        }
+        
+        std::vector<PairType> sorted( newPairs );
+        std::stable_sort( sorted.begin(), sorted.end(), keyLess );
+        
+        std::vector<PairType> merged;
+        merged.reserve( pairs.size() + sorted.size() );
+        
+        ConstIterator existing = pairs.begin();
+        for( ConstIterator i = sorted.begin(); i != sorted.end(); i++ )
+        {
+            ConstIterator next = i + 1;
+            if( ( next != sorted.end() ) && ( next->first == i->first ) )
             {
-                pairs.erase( iter );
-                return invalidValue;
+                continue;
             }
-            else
+            
+            while( ( existing != pairs.end() ) && ( existing->first < i->first ) )
             {
-                V previousValue = iter->second;
-                iter->second = value;
-                
-                return previousValue;
+                merged.push_back( *existing++ );
+            }
+            if( ( existing != pairs.end() ) && ( existing->first == i->first ) )
+            {
+                existing++;
+            }
+            
+            if( ( i->second != invalidValue ) && ( i->second != defaultValue ) )
+            {
+                merged.push_back( *i );
             }
         }
+        while( existing != pairs.end() )
+        {
+            merged.push_back( *existing++ );
+        }
+        
+        pairs.swap( merged );
+    }
+    
+    
+    /**
+     * Releases any spare capacity. Used once a map is known to be complete.
+     */
+    void compact()
+    {
+        std::vector<PairType>( pairs ).swap( pairs );
+    }
+    
+    
+    /**
+     * The number of bytes allocated for the map's pairs.
+     */
+    size_t getMemoryUsage() const
+    {
+        return pairs.capacity() * sizeof( PairType );
     }
     
     
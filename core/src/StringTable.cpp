@@ -0,0 +1,213 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <cstddef>
+
+#include "StringTable.h"
+#include "Util.h"
+
+using namespace std;
+
+static const int INITIAL_SLOT_COUNT = 64;
+
+
+static unsigned int hashString( const string &value )
+{
+    //FNV-1a
+    unsigned int hash = 2166136261u;
+    for( string::const_iterator i = value.begin(); i != value.end(); i++ )
+    {
+        hash ^= (unsigned char)*i;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
+
+
+StringTable::StringTable() :
+    base( NULL ),
+    baseCount( 0 )
+{
+    stringBytes = 0;
+    slots.resize( INITIAL_SLOT_COUNT, -1 );
+}
+
+
+StringTable::StringTable( const StringTable *_base ) :
+    base( _base ),
+    baseCount( _base->getCount() )
+{
+    stringBytes = 0;
+    slots.resize( INITIAL_SLOT_COUNT, -1 );
+}
+
+
+StringTable::~StringTable()
+{
+}
+
+
+int StringTable::findSlot( const string &value, unsigned int hash ) const
+{
+    unsigned int mask = slots.size() - 1;
+    unsigned int slot = hash & mask;
+    
+    while( true )
+    {
+        int id = slots[slot];
+        if( id == -1 )
+        {
+            return slot;
+        }
+        if( ( hashes[id] == hash ) && ( strings[id] == value ) )
+        {
+            return slot;
+        }
+        
+        slot = ( slot + 1 ) & mask;
+    }
+}
+
+
+void StringTable::rehash( int slotCount )
+{
+    slots.assign( slotCount, -1 );
+    
+    unsigned int mask = slotCount - 1;
+    for( unsigned int id = 0; id < strings.size(); id++ )
+    {
+        unsigned int slot = hashes[id] & mask;
+        while( slots[slot] != -1 )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        slots[slot] = id;
+    }
+}
+
+
+int StringTable::find( const string &value, unsigned int hash ) const
+{
+    if( base != NULL )
+    {
+        int id = base->find( value, hash );
+        if( id != -1 )
+        {
+            return id;
+        }
+    }
+    
+    int id = slots[findSlot( value, hash )];
+    if( id == -1 )
+    {
+        return -1;
+    }
+    
+    return baseCount + id;
+}
+
+
+const InternedName StringTable::intern( const string &value )
+{
+    unsigned int hash = hashString( value );
+    
+    if( base != NULL )
+    {
+        int id = base->find( value, hash );
+        if( id != -1 )
+        {
+            return InternedName( id, base->getString( id ) );
+        }
+    }
+    
+    //NOTE: Slots and hashes are indexed by local id. Only the public id is offset by the base.
+    int slot = findSlot( value, hash );
+    
+    if( slots[slot] != -1 )
+    {
+        int id = slots[slot];
+        return InternedName( baseCount + id, strings[id] );
+    }
+    
+    int id = strings.size();
+    strings.push_back( value );
+    hashes.push_back( hash );
+    slots[slot] = id;
+    stringBytes += FmlUtil::memoryUsage( strings.back() );
+    
+    //Keep the load factor at or below one half.
+    if( strings.size() * 2 > slots.size() )
+    {
+        rehash( slots.size() * 2 );
+    }
+    
+    return InternedName( baseCount + id, strings[id] );
+}
+
+
+int StringTable::find( const string &value ) const
+{
+    return find( value, hashString( value ) );
+}
+
+
+const string &StringTable::getString( int id ) const
+{
+    if( id < baseCount )
+    {
+        return base->getString( id );
+    }
+    
+    return strings[id - baseCount];
+}
+
+
+int StringTable::getCount() const
+{
+    return baseCount + strings.size();
+}
+
+
+size_t StringTable::getMemoryUsage() const
+{
+    return stringBytes + ( strings.size() * sizeof( string ) ) + FmlUtil::memoryUsage( hashes ) + FmlUtil::memoryUsage( slots );
+}
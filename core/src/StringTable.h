@@ -0,0 +1,129 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_STRING_TABLE
+#define H_STRING_TABLE
+
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * A reference to a string held in a StringTable. Two interned names are equal
+ * if and only if their ids (or equivalently, their value addresses) are equal.
+ */
+class InternedName
+{
+public:
+    const int id;
+    
+    const std::string &value;
+    
+    InternedName( int _id, const std::string &_value ) :
+        id( _id ), value( _value ) {}
+};
+
+
+/**
+ * A hashed table of unique strings. Each distinct string is stored exactly once, and
+ * assigned a small dense id. Interned strings are never moved or removed, so references
+ * to them remain valid for the lifetime of the table.
+ * 
+ * A table may be layered over a base table, which must outlive it and must not change
+ * while the layer exists. Strings already in the base keep their base ids, and new
+ * strings are numbered from the end of the base.
+ */
+class StringTable
+{
+private:
+    const StringTable * const base;
+    
+    const int baseCount;
+    
+    std::deque<std::string> strings;
+    
+    std::vector<unsigned int> hashes;
+    
+    /**
+     * Open-addressed hash table of string ids. Empty slots are -1.
+     */
+    std::vector<int> slots;
+    
+    /**
+     * The number of bytes allocated for the contents of the table's own strings.
+     */
+    size_t stringBytes;
+    
+    int findSlot( const std::string &value, unsigned int hash ) const;
+    
+    void rehash( int slotCount );
+    
+    int find( const std::string &value, unsigned int hash ) const;
+    
+public:
+    StringTable();
+    
+    StringTable( const StringTable *_base );
+    
+    virtual ~StringTable();
+    
+    /**
+     * Returns the interned copy of the given string, adding it to the table if necessary.
+     */
+    const InternedName intern( const std::string &value );
+    
+    /**
+     * \return The id of the given string, or -1 if it has not been interned.
+     */
+    int find( const std::string &value ) const;
+    
+    const std::string &getString( int id ) const;
+    
+    int getCount() const;
+    
+    /**
+     * The number of bytes allocated for the table's own strings and index. Strings held by the base
+     * table are not included.
+     */
+    size_t getMemoryUsage() const;
+};
+
+#endif //H_STRING_TABLE
@@ -0,0 +1,618 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <cstddef>
+
+#if defined FIELDML_NO_THREADS
+//Nothing required.
+#elif defined WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ThreadSupport.h"
+
+#if defined FIELDML_NO_THREADS
+
+Mutex::Mutex() :
+    native( NULL )
+{
+}
+
+
+Mutex::~Mutex()
+{
+}
+
+
+void Mutex::lock()
+{
+}
+
+
+void Mutex::unlock()
+{
+}
+
+
+ReadWriteLock::ReadWriteLock() :
+    native( NULL )
+{
+}
+
+
+ReadWriteLock::~ReadWriteLock()
+{
+}
+
+
+void ReadWriteLock::lockShared()
+{
+}
+
+
+void ReadWriteLock::unlockShared()
+{
+}
+
+
+void ReadWriteLock::lockExclusive()
+{
+}
+
+
+void ReadWriteLock::unlockExclusive()
+{
+}
+
+
+AtomicInt::AtomicInt( long _value ) :
+    value( _value )
+{
+}
+
+
+long AtomicInt::get() const
+{
+    return value;
+}
+
+
+void AtomicInt::set( long _value )
+{
+    value = _value;
+}
+
+
+long AtomicInt::increment()
+{
+    return ++value;
+}
+
+
+long AtomicInt::decrement()
+{
+    return --value;
+}
+
+
+ThreadLocalPointer::ThreadLocalPointer( void (*destructor)( void * ) ) :
+    native( NULL )
+{
+}
+
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+}
+
+
+void *ThreadLocalPointer::get()
+{
+    return native;
+}
+
+
+void ThreadLocalPointer::set( void *value )
+{
+    native = value;
+}
+
+
+Thread::Thread( void (*function)( void * ), void *argument ) :
+    native( NULL )
+{
+    function( argument );
+}
+
+
+Thread::~Thread()
+{
+}
+
+
+void Thread::join()
+{
+}
+
+
+static int getProcessorCount()
+{
+    return 1;
+}
+
+#elif defined WIN32
+
+Mutex::Mutex()
+{
+    CRITICAL_SECTION *section = new CRITICAL_SECTION;
+    InitializeCriticalSection( section );
+    native = section;
+}
+
+
+Mutex::~Mutex()
+{
+    CRITICAL_SECTION *section = (CRITICAL_SECTION*)native;
+    DeleteCriticalSection( section );
+    delete section;
+}
+
+
+void Mutex::lock()
+{
+    EnterCriticalSection( (CRITICAL_SECTION*)native );
+}
+
+
+void Mutex::unlock()
+{
+    LeaveCriticalSection( (CRITICAL_SECTION*)native );
+}
+
+
+ReadWriteLock::ReadWriteLock()
+{
+    SRWLOCK *lock = new SRWLOCK;
+    InitializeSRWLock( lock );
+    native = lock;
+}
+
+
+ReadWriteLock::~ReadWriteLock()
+{
+    delete (SRWLOCK*)native;
+}
+
+
+void ReadWriteLock::lockShared()
+{
+    AcquireSRWLockShared( (SRWLOCK*)native );
+}
+
+
+void ReadWriteLock::unlockShared()
+{
+    ReleaseSRWLockShared( (SRWLOCK*)native );
+}
+
+
+void ReadWriteLock::lockExclusive()
+{
+    AcquireSRWLockExclusive( (SRWLOCK*)native );
+}
+
+
+void ReadWriteLock::unlockExclusive()
+{
+    ReleaseSRWLockExclusive( (SRWLOCK*)native );
+}
+
+
+AtomicInt::AtomicInt( long _value ) :
+    value( _value )
+{
+}
+
+
+long AtomicInt::get() const
+{
+    //NOTE: An interlocked operation is a full barrier, so this also orders the reads that follow it.
+    return InterlockedCompareExchange( (volatile LONG*)&value, 0, 0 );
+}
+
+
+void AtomicInt::set( long _value )
+{
+    InterlockedExchange( (volatile LONG*)&value, _value );
+}
+
+
+long AtomicInt::increment()
+{
+    return InterlockedIncrement( (volatile LONG*)&value );
+}
+
+
+long AtomicInt::decrement()
+{
+    return InterlockedDecrement( (volatile LONG*)&value );
+}
+
+
+/**
+ * The fiber-local value of a ThreadLocalPointer. The destructor is kept with the value, as the fiber-local storage
+ * callback is only given the value.
+ */
+struct ThreadLocalEntry
+{
+    void (*destructor)( void * );
+    void *value;
+};
+
+
+struct NativeThreadLocal
+{
+    DWORD index;
+    void (*destructor)( void * );
+};
+
+
+static VOID WINAPI destroyThreadLocalEntry( PVOID data )
+{
+    ThreadLocalEntry *entry = (ThreadLocalEntry*)data;
+    if( entry == NULL )
+    {
+        return;
+    }
+    
+    if( ( entry->destructor != NULL ) && ( entry->value != NULL ) )
+    {
+        entry->destructor( entry->value );
+    }
+    delete entry;
+}
+
+
+ThreadLocalPointer::ThreadLocalPointer( void (*destructor)( void * ) )
+{
+    //NOTE: Unlike thread-local storage, fiber-local storage calls back when a thread exits.
+    NativeThreadLocal *local = new NativeThreadLocal;
+    local->index = FlsAlloc( destroyThreadLocalEntry );
+    local->destructor = destructor;
+    native = local;
+}
+
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    NativeThreadLocal *local = (NativeThreadLocal*)native;
+    FlsFree( local->index );
+    delete local;
+}
+
+
+void *ThreadLocalPointer::get()
+{
+    ThreadLocalEntry *entry = (ThreadLocalEntry*)FlsGetValue( ( (NativeThreadLocal*)native )->index );
+    
+    return ( entry == NULL ) ? NULL : entry->value;
+}
+
+
+void ThreadLocalPointer::set( void *value )
+{
+    NativeThreadLocal *local = (NativeThreadLocal*)native;
+    ThreadLocalEntry *entry = (ThreadLocalEntry*)FlsGetValue( local->index );
+    if( entry == NULL )
+    {
+        entry = new ThreadLocalEntry;
+        entry->destructor = local->destructor;
+        FlsSetValue( local->index, entry );
+    }
+    entry->value = value;
+}
+
+
+struct NativeThread
+{
+    HANDLE handle;
+    void (*function)( void * );
+    void *argument;
+};
+
+
+static DWORD WINAPI runThread( LPVOID parameter )
+{
+    NativeThread *thread = (NativeThread*)parameter;
+    thread->function( thread->argument );
+    return 0;
+}
+
+
+Thread::Thread( void (*function)( void * ), void *argument )
+{
+    NativeThread *thread = new NativeThread;
+    thread->function = function;
+    thread->argument = argument;
+    thread->handle = CreateThread( NULL, 0, runThread, thread, 0, NULL );
+    if( thread->handle == NULL )
+    {
+        function( argument );
+    }
+    native = thread;
+}
+
+
+Thread::~Thread()
+{
+    join();
+    delete (NativeThread*)native;
+}
+
+
+void Thread::join()
+{
+    NativeThread *thread = (NativeThread*)native;
+    if( thread->handle != NULL )
+    {
+        WaitForSingleObject( thread->handle, INFINITE );
+        CloseHandle( thread->handle );
+        thread->handle = NULL;
+    }
+}
+
+
+static int getProcessorCount()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return ( info.dwNumberOfProcessors > 1 ) ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+Mutex::Mutex()
+{
+    pthread_mutex_t *mutex = new pthread_mutex_t;
+    pthread_mutex_init( mutex, NULL );
+    native = mutex;
+}
+
+
+Mutex::~Mutex()
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t*)native;
+    pthread_mutex_destroy( mutex );
+    delete mutex;
+}
+
+
+void Mutex::lock()
+{
+    pthread_mutex_lock( (pthread_mutex_t*)native );
+}
+
+
+void Mutex::unlock()
+{
+    pthread_mutex_unlock( (pthread_mutex_t*)native );
+}
+
+
+ReadWriteLock::ReadWriteLock()
+{
+    pthread_rwlock_t *lock = new pthread_rwlock_t;
+    pthread_rwlock_init( lock, NULL );
+    native = lock;
+}
+
+
+ReadWriteLock::~ReadWriteLock()
+{
+    pthread_rwlock_t *lock = (pthread_rwlock_t*)native;
+    pthread_rwlock_destroy( lock );
+    delete lock;
+}
+
+
+void ReadWriteLock::lockShared()
+{
+    pthread_rwlock_rdlock( (pthread_rwlock_t*)native );
+}
+
+
+void ReadWriteLock::unlockShared()
+{
+    pthread_rwlock_unlock( (pthread_rwlock_t*)native );
+}
+
+
+void ReadWriteLock::lockExclusive()
+{
+    pthread_rwlock_wrlock( (pthread_rwlock_t*)native );
+}
+
+
+void ReadWriteLock::unlockExclusive()
+{
+    pthread_rwlock_unlock( (pthread_rwlock_t*)native );
+}
+
+
+AtomicInt::AtomicInt( long _value ) :
+    value( _value )
+{
+}
+
+
+long AtomicInt::get() const
+{
+    //NOTE: The GCC atomic builtins are full barriers, so this also orders the reads that follow it.
+    return __sync_add_and_fetch( const_cast<volatile long*>( &value ), 0 );
+}
+
+
+void AtomicInt::set( long _value )
+{
+    long current = value;
+    long previous;
+    while( ( previous = __sync_val_compare_and_swap( &value, current, _value ) ) != current )
+    {
+        current = previous;
+    }
+}
+
+
+long AtomicInt::increment()
+{
+    return __sync_add_and_fetch( &value, 1 );
+}
+
+
+long AtomicInt::decrement()
+{
+    return __sync_sub_and_fetch( &value, 1 );
+}
+
+
+ThreadLocalPointer::ThreadLocalPointer( void (*destructor)( void * ) )
+{
+    pthread_key_t *key = new pthread_key_t;
+    pthread_key_create( key, destructor );
+    native = key;
+}
+
+
+ThreadLocalPointer::~ThreadLocalPointer()
+{
+    pthread_key_t *key = (pthread_key_t*)native;
+    pthread_key_delete( *key );
+    delete key;
+}
+
+
+void *ThreadLocalPointer::get()
+{
+    return pthread_getspecific( *(pthread_key_t*)native );
+}
+
+
+void ThreadLocalPointer::set( void *value )
+{
+    pthread_setspecific( *(pthread_key_t*)native, value );
+}
+
+
+struct NativeThread
+{
+    pthread_t thread;
+    bool running;
+    void (*function)( void * );
+    void *argument;
+};
+
+
+static void *runThread( void *parameter )
+{
+    NativeThread *thread = (NativeThread*)parameter;
+    thread->function( thread->argument );
+    return NULL;
+}
+
+
+Thread::Thread( void (*function)( void * ), void *argument )
+{
+    NativeThread *thread = new NativeThread;
+    thread->function = function;
+    thread->argument = argument;
+    thread->running = ( pthread_create( &thread->thread, NULL, runThread, thread ) == 0 );
+    if( !thread->running )
+    {
+        function( argument );
+    }
+    native = thread;
+}
+
+
+Thread::~Thread()
+{
+    join();
+    delete (NativeThread*)native;
+}
+
+
+void Thread::join()
+{
+    NativeThread *thread = (NativeThread*)native;
+    if( thread->running )
+    {
+        pthread_join( thread->thread, NULL );
+        thread->running = false;
+    }
+}
+
+
+static int getProcessorCount()
+{
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    return ( count > 1 ) ? (int)count : 1;
+}
+
+#endif
+
+
+AtomicInt Thread::concurrency( 0 );
+
+
+int Thread::getConcurrency()
+{
+    const int count = (int)concurrency.get();
+    return ( count > 0 ) ? count : getProcessorCount();
+}
+
+
+void Thread::setConcurrency( int newConcurrency )
+{
+    concurrency.set( ( newConcurrency > 0 ) ? newConcurrency : 0 );
+}
@@ -0,0 +1,215 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_THREAD_SUPPORT
+#define H_THREAD_SUPPORT
+
+/**
+ * Minimal portable threading primitives. The native objects are kept out of this header so that
+ * neither pthread.h nor windows.h leak into the rest of the library.
+ * 
+ * If FIELDML_NO_THREADS is defined, all locking operations are no-ops.
+ */
+class Mutex
+{
+private:
+    void *native;
+    
+    Mutex( const Mutex & );
+    
+    Mutex &operator=( const Mutex & );
+    
+public:
+    Mutex();
+    
+    virtual ~Mutex();
+    
+    void lock();
+    
+    void unlock();
+};
+
+
+/**
+ * Holds the given mutex for as long as it is in scope.
+ */
+class MutexGuard
+{
+private:
+    Mutex &mutex;
+    
+    MutexGuard( const MutexGuard & );
+    
+    MutexGuard &operator=( const MutexGuard & );
+    
+public:
+    MutexGuard( Mutex &_mutex ) :
+        mutex( _mutex )
+    {
+        mutex.lock();
+    }
+    
+    
+    ~MutexGuard()
+    {
+        mutex.unlock();
+    }
+};
+
+
+/**
+ * A lock that can be held by any number of readers, or by a single writer. It is not re-entrant.
+ */
+class ReadWriteLock
+{
+private:
+    void *native;
+    
+    ReadWriteLock( const ReadWriteLock & );
+    
+    ReadWriteLock &operator=( const ReadWriteLock & );
+    
+public:
+    ReadWriteLock();
+    
+    virtual ~ReadWriteLock();
+    
+    void lockShared();
+    
+    void unlockShared();
+    
+    void lockExclusive();
+    
+    void unlockExclusive();
+};
+
+
+/**
+ * An integer that can be read and changed from several threads without a lock. Anything a thread wrote
+ * before changing the value is visible to any thread that reads the new value.
+ */
+class AtomicInt
+{
+private:
+    volatile long value;
+    
+    AtomicInt( const AtomicInt & );
+    
+    AtomicInt &operator=( const AtomicInt & );
+    
+public:
+    AtomicInt( long _value );
+    
+    long get() const;
+    
+    void set( long _value );
+    
+    /**
+     * \return The new value.
+     */
+    long increment();
+    
+    /**
+     * \return The new value.
+     */
+    long decrement();
+};
+
+
+/**
+ * A pointer with a separate value for each thread, initially NULL. If a destructor is given, it is
+ * called with each thread's non-NULL value when that thread exits.
+ */
+class ThreadLocalPointer
+{
+private:
+    void *native;
+    
+    ThreadLocalPointer( const ThreadLocalPointer & );
+    
+    ThreadLocalPointer &operator=( const ThreadLocalPointer & );
+    
+public:
+    ThreadLocalPointer( void (*destructor)( void * ) );
+    
+    virtual ~ThreadLocalPointer();
+    
+    void *get();
+    
+    void set( void *value );
+};
+
+
+/**
+ * A thread running the given function, which is waited for by join() or the destructor. If threads are not
+ * supported, or the thread cannot be started, the function is run by the constructor instead.
+ */
+class Thread
+{
+private:
+    void *native;
+    
+    static AtomicInt concurrency;
+    
+    Thread( const Thread & );
+    
+    Thread &operator=( const Thread & );
+    
+public:
+    Thread( void (*function)( void * ), void *argument );
+    
+    virtual ~Thread();
+    
+    void join();
+    
+    /**
+     * \return The number of threads that can actually run at once, which is one if threads are not supported.
+     */
+    static int getConcurrency();
+    
+    /**
+     * Makes getConcurrency() return the given number rather than the number of processors, or restores the
+     * number of processors if zero. Lets tests exercise both the single and multiple processor code paths.
+     */
+    static void setConcurrency( int newConcurrency );
+};
+
+#endif //H_THREAD_SUPPORT
@@ -42,7 +42,10 @@
 #ifndef H_UTIL
 #define H_UTIL
 
+#include <cstddef>
 #include <vector>
+#include <set>
+#include <string>
 #include <algorithm>
 
 namespace FmlUtil
@@ -59,6 +62,33 @@ namespace FmlUtil
     {
         return std::find( v.begin(), v.end(), value ) != v.end();
     }
+
+
+    /**
+     * The number of bytes allocated by the given vector for its elements.
+     */
+    template <typename T>
+    size_t memoryUsage( const std::vector<T> &v )
+    {
+        return v.capacity() * sizeof( T );
+    }
+    
+    
+    /**
+     * An estimate of the number of bytes allocated by the given set for its nodes, assuming
+     * a red-black tree node holds three links and a colour alongside the value.
+     */
+    template <typename T>
+    size_t memoryUsage( const std::set<T> &s )
+    {
+        return s.size() * ( sizeof( T ) + 4 * sizeof( void * ) );
+    }
+    
+    
+    inline size_t memoryUsage( const std::string &s )
+    {
+        return s.capacity() + 1;
+    }
 }
 
 #endif // H_UTIL
@@ -42,15 +42,18 @@
 #include <algorithm>
 
 #include <cstring>
+#include <climits>
 
 #include "String_InternalLibrary.h"
 
 #include "fieldml_api.h"
 #include "FieldmlSession.h"
 #include "ErrorContextAutostack.h"
+#include "SessionLockGuard.h"
 #include "fieldml_structs.h"
 #include "Evaluators.h"
 #include "fieldml_write.h"
+#include "fieldml_binary.h"
 #include "string_const.h"
 #include "Util.h"
 
@@ -131,10 +134,11 @@ static FmlObjectHandle addObject( FieldmlSession *session, FieldmlObject *object
     FieldmlObject *oldObject = session->objects.getObject( handle );
     
     session->logError( "Handle collision. Cannot replace", object->name.c_str(), oldObject->name.c_str() );
-    delete object;
-    
     session->setError( FML_ERR_NAME_COLLISION, "There is already an object named " + object->name + " in this scope." );
     
+    //NOTE: The object's memory belongs to the session's arena, and is only released when the session is destroyed.
+    delete object;
+    
     return FML_INVALID_HANDLE;
 }
 
@@ -199,6 +203,31 @@ static SimpleMap<FmlObjectHandle, FmlObjectHandle> *getBindMap( FieldmlSession *
 }
 
 
+/**
+ * Copies up to capacity of the given map's entries, in key order, into the given arrays. Either array may be NULL.
+ * 
+ * \return The total number of entries in the map.
+ */
+template <typename K, typename V> static int copyMap( SimpleMap<K, V> *map, K *keys, V *values, int capacity )
+{
+    int count = 0;
+    for( typename SimpleMap<K, V>::ConstIterator i = map->begin(); ( i != map->end() ) && ( count < capacity ); i++ )
+    {
+        if( keys != NULL )
+        {
+            keys[count] = i->first;
+        }
+        if( values != NULL )
+        {
+            values[count] = i->second;
+        }
+        count++;
+    }
+    
+    return map->size();
+}
+
+
 static vector<FmlObjectHandle> getArgumentList( FieldmlSession *session, FmlObjectHandle objectHandle, bool isBound, bool isUsed )
 {
     vector<FmlObjectHandle> args;
@@ -256,6 +285,41 @@ static vector<FmlObjectHandle> getArgumentList( FieldmlSession *session, FmlObje
 }
 
 
+/**
+ * Checks that the session may be modified.
+ */
+static bool checkMutable( FieldmlSession *session )
+{
+    if( session->isFrozen() )
+    {
+        session->setError( FML_ERR_ACCESS_VIOLATION, "Cannot modify a frozen session." );
+        return false;
+    }
+    
+    return true;
+}
+
+
+/**
+ * Gets the given object in order to modify it. If the object is shared with the session's source, it is first
+ * replaced by a private copy, so this must only be called once the modification has been validated, and any
+ * pointer into the object fetched before the call must be fetched again.
+ */
+static FieldmlObject *getWritableObject( FieldmlSession *session, FmlObjectHandle objectHandle )
+{
+    FieldmlObject *object = session->objects.getWritableObject( objectHandle );
+    
+    //NOTE: Decoded members depend on ensembles' member definitions and on the data they are read from.
+    if( ( object != NULL ) && ( ( object->objectType == FHT_ENSEMBLE_TYPE ) || ( object->objectType == FHT_MESH_TYPE ) ||
+        ( object->objectType == FHT_DATA_SOURCE ) || ( object->objectType == FHT_DATA_RESOURCE ) ) )
+    {
+        session->invalidateMembers();
+    }
+    
+    return object;
+}
+
+
 static bool checkCyclicDependency( FieldmlSession *session, FmlObjectHandle objectHandle, FmlObjectHandle objectDependancy )
 {
     ERROR_AUTOSTACK( session );
@@ -272,6 +336,87 @@ static bool checkCyclicDependency( FieldmlSession *session, FmlObjectHandle obje
 }
 
 
+/**
+ * Checks that the given object is complete enough to be used.
+ */
+static bool validateObject( FieldmlSession *session, FmlObjectHandle objectHandle )
+{
+    ERROR_AUTOSTACK( session );
+
+    FieldmlObject *object = getObject( session, objectHandle );
+    if( object == NULL )
+    {
+        return false;
+    }
+    
+    if( object->objectType == FHT_REFERENCE_EVALUATOR )
+    {
+        if( ( (ReferenceEvaluator*)object )->sourceEvaluator == FML_INVALID_HANDLE )
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Reference evaluator has no source evaluator." );
+            return false;
+        }
+    }
+    else if( object->objectType == FHT_PIECEWISE_EVALUATOR )
+    {
+        if( ( (PiecewiseEvaluator*)object )->indexEvaluator == FML_INVALID_HANDLE )
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Piecewise evaluator has no index evaluator." );
+            return false;
+        }
+    }
+    else if( object->objectType == FHT_AGGREGATE_EVALUATOR )
+    {
+        if( ( (AggregateEvaluator*)object )->indexEvaluator == FML_INVALID_HANDLE )
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Aggregate evaluator has no index evaluator." );
+            return false;
+        }
+    }
+    else if( object->objectType == FHT_PARAMETER_EVALUATOR )
+    {
+        BaseDataDescription *description = ( (ParameterEvaluator*)object )->dataDescription;
+        if( description->descriptionType == FML_DATA_DESCRIPTION_DENSE_ARRAY )
+        {
+            if( ( (DenseArrayDataDescription*)description )->dataSource == FML_INVALID_HANDLE )
+            {
+                session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Parameter evaluator has no data source." );
+                return false;
+            }
+        }
+        else if( description->descriptionType == FML_DATA_DESCRIPTION_DOK_ARRAY )
+        {
+            DokArrayDataDescription *dok = (DokArrayDataDescription*)description;
+            if( ( dok->keySource == FML_INVALID_HANDLE ) || ( dok->valueSource == FML_INVALID_HANDLE ) )
+            {
+                session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Parameter evaluator has no key or value data source." );
+                return false;
+            }
+        }
+        else
+        {
+            session->setError( FML_ERR_MISCONFIGURED_OBJECT, objectHandle, "Parameter evaluator has no data description." );
+            return false;
+        }
+    }
+    
+    else
+    {
+        //Other objects have no delegates.
+        return true;
+    }
+    
+    set<FmlObjectHandle> delegates;
+    if( !session->getDelegateEvaluators( objectHandle, delegates ) || FmlUtil::contains( delegates, objectHandle ) )
+    {
+        session->setError( FML_ERR_CYCLIC_DEPENDENCY, objectHandle, "Cyclic dependancy." );
+        return false;
+    }
+    
+    return true;
+}
+
+
 static char* cstrCopy( const string &s )
 {
     return strdupS( s.c_str() );
@@ -349,6 +494,59 @@ static ArrayDataSource *getArrayDataSource( FieldmlSession *session, FmlObjectHa
 }
 
 
+/**
+ * Copies 64-bit array data source values into a 32-bit buffer, failing if any value does not fit.
+ */
+static FmlErrorNumber narrowArrayValues( FieldmlSession *session, FmlObjectHandle objectHandle, const vector<int64_t> &values, int *buffer )
+{
+    for( size_t i = 0; i < values.size(); i++ )
+    {
+        if( ( values[i] > INT_MAX ) || ( values[i] < INT_MIN ) )
+        {
+            return session->setError( FML_ERR_UNSUPPORTED, objectHandle, "Array data source value does not fit into 32 bits. Use the 64-bit variant." );
+        }
+    }
+    
+    for( size_t i = 0; i < values.size(); i++ )
+    {
+        buffer[i] = (int)values[i];
+    }
+    
+    return FML_ERR_NO_ERROR;
+}
+
+
+/**
+ * \return The decoded members of the given ensemble type, or of the given mesh type's elements.
+ */
+static const EnsembleMembers *getEnsembleMembers( FieldmlSession *session, FmlObjectHandle objectHandle, bool withIndex = false )
+{
+    FieldmlObject *object = getObject( session, objectHandle );
+    if( object == NULL )
+    {
+        return NULL;
+    }
+    
+    if( object->objectType == FHT_MESH_TYPE )
+    {
+        objectHandle = ( (MeshType*)object )->elementsType;
+        object = getObject( session, objectHandle );
+        if( object == NULL )
+        {
+            return NULL;
+        }
+    }
+    
+    if( object->objectType != FHT_ENSEMBLE_TYPE )
+    {
+        session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Must be an ensemble or mesh type." );
+        return NULL;
+    }
+    
+    return session->getEnsembleMembers( objectHandle, withIndex );
+}
+
+
 static DataResource *getDataResource( FieldmlSession *session, FmlObjectHandle objectHandle )
 {
     ERROR_AUTOSTACK( session );
@@ -488,18 +686,25 @@ static bool checkIsEvaluatorTypeCompatible( FieldmlSession *session, FmlObjectHa
 //
 //========================================================================
 
-FmlSessionHandle Fieldml_CreateFromFile( const char * filename )
+static FmlSessionHandle createFromFile( const char * filename, FieldmlValidationLevel level, bool streaming, bool lazyImports )
 {
     FieldmlSession *session = new FieldmlSession();
     ErrorContextAutostack bob( session, __FILE__, __LINE__, __ECA_FUNC__ );
+    SESSION_WRITE_LOCK( session );
     
     if( filename == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_1, "Cannot create FieldML session. Invalid filename." );
     }
+    else if( ( level != FML_VALIDATION_SCHEMA ) && ( level != FML_VALIDATION_STRUCTURAL ) )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create FieldML session. Invalid validation level." );
+    }
     else
     {
-        session->region = session->addResourceRegion( filename, "" );
+        session->validationLevel = level;
+        session->lazyImports = lazyImports;
+        session->region = session->addResourceRegion( filename, "", streaming );
         if( session->region == NULL )
         {
             session->setError( FML_ERR_READ_ERR, "Cannot create FieldML session. Invalid document or read error." );
@@ -515,10 +720,54 @@ FmlSessionHandle Fieldml_CreateFromFile( const char * filename )
 }
 
 
+FmlSessionHandle Fieldml_CreateFromFile( const char * filename )
+{
+    return createFromFile( filename, FML_VALIDATION_SCHEMA, false, false );
+}
+
+
+FmlSessionHandle Fieldml_CreateFromFileWithValidation( const char * filename, FieldmlValidationLevel level )
+{
+    return createFromFile( filename, level, false, false );
+}
+
+
+FmlSessionHandle Fieldml_CreateFromFileStreaming( const char * filename, FieldmlValidationLevel level )
+{
+    return createFromFile( filename, level, true, false );
+}
+
+
+FmlSessionHandle Fieldml_CreateFromFileWithLazyImports( const char * filename, FieldmlValidationLevel level )
+{
+    return createFromFile( filename, level, false, true );
+}
+
+
+FmlSessionHandle Fieldml_CreateFromBinary( const char * filename )
+{
+    FieldmlSession *session = new FieldmlSession();
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+    
+    if( filename == NULL )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_1, "Cannot create FieldML session. Invalid filename." );
+    }
+    else if( readFieldmlBinary( session, filename ) != 0 )
+    {
+        session->setError( FML_ERR_READ_ERR, "Cannot create FieldML session. Invalid binary file or read error." );
+    }
+    
+    return session->getSessionHandle();
+}
+
+
 FmlSessionHandle Fieldml_Create( const char * location, const char * name )
 {
     FieldmlSession *session = new FieldmlSession();
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
     
     if( location == NULL )
     {
@@ -539,13 +788,18 @@ FmlSessionHandle Fieldml_Create( const char * location, const char * name )
 
 FmlErrorNumber Fieldml_SetDebug( FmlSessionHandle handle, int debug )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
     
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
         
     session->setDebug( debug );
     
@@ -553,9 +807,56 @@ FmlErrorNumber Fieldml_SetDebug( FmlSessionHandle handle, int debug )
 }
 
 
+FmlErrorNumber Fieldml_SetValidationLevel( FmlSessionHandle handle, FieldmlValidationLevel level )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+    
+    if( session == NULL )
+    {
+        return FML_ERR_UNKNOWN_HANDLE;
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+    
+    if( ( level != FML_VALIDATION_SCHEMA ) && ( level != FML_VALIDATION_STRUCTURAL ) )
+    {
+        return session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot set validation level. Invalid level." );
+    }
+    
+    session->validationLevel = level;
+    
+    return session->setError( FML_ERR_NO_ERROR, "" );
+}
+
+
+FmlErrorNumber Fieldml_SetLazyImports( FmlSessionHandle handle, FmlBoolean lazy )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+    
+    if( session == NULL )
+    {
+        return FML_ERR_UNKNOWN_HANDLE;
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+    
+    session->lazyImports = ( lazy == 1 );
+    
+    return session->setError( FML_ERR_NO_ERROR, "" );
+}
+
+
 FmlErrorNumber Fieldml_GetLastError( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
@@ -567,8 +868,9 @@ FmlErrorNumber Fieldml_GetLastError( FmlSessionHandle handle )
 
 FmlErrorNumber Fieldml_WriteFile( FmlSessionHandle handle, const char * filename )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
     
     if( session == NULL )
     {
@@ -584,22 +886,127 @@ FmlErrorNumber Fieldml_WriteFile( FmlSessionHandle handle, const char * filename
     }
         
     session->setError( FML_ERR_NO_ERROR, "" );
-    session->region->setRoot( getDirectory( filename ) );
+    if( !session->isFrozen() )
+    {
+        //NOTE: Frozen sessions keep their original root, as other threads may be resolving data against it.
+        session->region->setRoot( getDirectory( filename ) );
+    }
 
     return writeFieldmlFile( session, handle, filename );
 }
 
 
+FmlErrorNumber Fieldml_WriteBinary( FmlSessionHandle handle, const char * filename )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+    
+    if( session == NULL )
+    {
+        return FML_ERR_UNKNOWN_HANDLE;
+    }
+    if( session->region == NULL )
+    {
+        return session->setError( FML_ERR_INVALID_REGION, "Cannot write FieldML binary file. FieldML session has no region." );
+    }
+    if( filename == NULL )
+    {
+        return session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot write FieldML binary file. Invalid filename." );
+    }
+    
+    if( writeFieldmlBinary( session, filename ) != 0 )
+    {
+        return session->setError( FML_ERR_WRITE_ERR, "Cannot write FieldML binary file." );
+    }
+    
+    return session->setError( FML_ERR_NO_ERROR, "" );
+}
+
+
 void Fieldml_Destroy( FmlSessionHandle handle )
 {
     FieldmlSession::removeSession( handle );    
 }
 
 
-char * Fieldml_GetRegionName( FmlSessionHandle handle )
+FmlErrorNumber Fieldml_FreezeSession( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return FML_ERR_UNKNOWN_HANDLE;
+    }
+    if( session->isFrozen() )
+    {
+        return session->setError( FML_ERR_NO_ERROR, "" );
+    }
+    
+    int count = session->objects.getCount();
+    for( FmlObjectHandle objectHandle = 0; objectHandle < count; objectHandle++ )
+    {
+        if( !validateObject( session, objectHandle ) )
+        {
+            return session->getLastError();
+        }
+    }
+    
+    session->freeze();
+    
+    return session->setError( FML_ERR_NO_ERROR, "" );
+}
+
+
+FmlSessionHandle Fieldml_CloneSession( FmlSessionHandle handle )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    if( Fieldml_FreezeSession( handle ) != FML_ERR_NO_ERROR )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    
+    FieldmlSession *clone = new FieldmlSession( session );
+    
+    session->setError( FML_ERR_NO_ERROR, "" );
+    return clone->getSessionHandle();
+}
+
+
+int64_t Fieldml_GetMemoryUsage( FmlSessionHandle handle, FieldmlMemoryCategory category )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+    if( ( category < FML_MEMORY_TOTAL ) || ( category > FML_MEMORY_CACHES ) )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_2, "Invalid memory usage category." );
+        return -1;
+    }
+    
+    return session->getMemoryUsage( category );
+}
+
+
+const char * Fieldml_PeekRegionName( FmlSessionHandle handle )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
     
     if( session == NULL )
     {
@@ -612,7 +1019,17 @@ char * Fieldml_GetRegionName( FmlSessionHandle handle )
     }
         
     session->setError( FML_ERR_NO_ERROR, "" );
-    return cstrCopy( session->region->getName() );
+    return session->region->getName().c_str();
+}
+
+
+char * Fieldml_GetRegionName( FmlSessionHandle handle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekRegionName( handle ) );
 }
 
 
@@ -629,14 +1046,18 @@ FmlErrorNumber Fieldml_FreeString( char * string )
 
 int Fieldml_CopyRegionName( FmlSessionHandle handle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetRegionName( handle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekRegionName( handle ), buffer, bufferLength );
 }
 
 
-char * Fieldml_GetRegionRoot( FmlSessionHandle handle )
+const char * Fieldml_PeekRegionRoot( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
     
     if( session == NULL )
     {
@@ -650,20 +1071,34 @@ char * Fieldml_GetRegionRoot( FmlSessionHandle handle )
     }
         
     session->setError( FML_ERR_NO_ERROR, "" );
-    return cstrCopy( session->region->getRoot() );
+    return session->region->getRoot().c_str();
+}
+
+
+char * Fieldml_GetRegionRoot( FmlSessionHandle handle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekRegionRoot( handle ) );
 }
 
 
 int Fieldml_CopyRegionRoot( FmlSessionHandle handle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetRegionRoot( handle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekRegionRoot( handle ), buffer, bufferLength );
 }
 
 
 int Fieldml_GetErrorCount( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -677,8 +1112,9 @@ int Fieldml_GetErrorCount( FmlSessionHandle handle )
 
 char * Fieldml_GetError( FmlSessionHandle handle, int index )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -698,13 +1134,18 @@ int Fieldml_CopyError( FmlSessionHandle handle, int errorIndex, char * buffer, i
 
 FmlErrorNumber Fieldml_ClearErrors( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
         
     session->clearErrors();
     return session->setError( FML_ERR_NO_ERROR, "" );
@@ -713,8 +1154,9 @@ FmlErrorNumber Fieldml_ClearErrors( FmlSessionHandle handle )
 
 int Fieldml_GetTotalObjectCount( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -728,8 +1170,9 @@ int Fieldml_GetTotalObjectCount( FmlSessionHandle handle )
 
 FmlObjectHandle Fieldml_GetObjectByIndex( FmlSessionHandle handle, const int objectIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -743,8 +1186,9 @@ FmlObjectHandle Fieldml_GetObjectByIndex( FmlSessionHandle handle, const int obj
 
 int Fieldml_GetObjectCount( FmlSessionHandle handle, FieldmlHandleType type )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -763,8 +1207,9 @@ int Fieldml_GetObjectCount( FmlSessionHandle handle, FieldmlHandleType type )
 
 FmlObjectHandle Fieldml_GetObject( FmlSessionHandle handle, FieldmlHandleType objectType, int objectIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -785,8 +1230,9 @@ FmlObjectHandle Fieldml_GetObject( FmlSessionHandle handle, FieldmlHandleType ob
 
 FmlObjectHandle Fieldml_GetObjectByName( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -811,8 +1257,9 @@ FmlObjectHandle Fieldml_GetObjectByName( FmlSessionHandle handle, const char * n
 
 FmlObjectHandle Fieldml_GetObjectByDeclaredName( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -832,8 +1279,9 @@ FmlObjectHandle Fieldml_GetObjectByDeclaredName( FmlSessionHandle handle, const
 
 FieldmlHandleType Fieldml_GetObjectType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -853,8 +1301,9 @@ FieldmlHandleType Fieldml_GetObjectType( FmlSessionHandle handle, FmlObjectHandl
 
 FmlObjectHandle Fieldml_GetTypeComponentEnsemble( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -874,74 +1323,160 @@ FmlObjectHandle Fieldml_GetTypeComponentEnsemble( FmlSessionHandle handle, FmlOb
         return continuousType->componentType;
     }
 
-    session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot get component ensemble. Must be a type with components." );  
-    return FML_INVALID_HANDLE;
+    session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot get component ensemble. Must be a type with components." );  
+    return FML_INVALID_HANDLE;
+}
+
+
+int Fieldml_GetTypeComponentCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+        
+    FmlObjectHandle componentTypeHandle = Fieldml_GetTypeComponentEnsemble( handle, objectHandle );
+    
+    if( componentTypeHandle == FML_INVALID_HANDLE )
+    {
+        if( session->getLastError() == FML_ERR_NO_ERROR )
+        {
+            return 1;
+        }
+        return -1;
+    }
+    
+    return Fieldml_GetMemberCount( handle, componentTypeHandle );
+}
+
+
+int Fieldml_GetMemberCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+        
+    FieldmlObject *object = getObject( session, objectHandle );
+
+    if( object == NULL ) 
+    {
+        return -1;
+    }
+
+    if( object->objectType == FHT_ENSEMBLE_TYPE )
+    {
+        EnsembleType *ensembleType = (EnsembleType*)object;
+        return ensembleType->count;
+    }
+    else if( object->objectType == FHT_MESH_TYPE )
+    {
+        MeshType *meshType = (MeshType*)object;
+        return Fieldml_GetMemberCount( handle, meshType->elementsType );
+    }
+        
+
+    session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot get member count. Must be a type with members/elements." );  
+    return -1;
 }
 
 
-int Fieldml_GetTypeComponentCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+FmlEnsembleValue Fieldml_GetEnsembleMember( FmlSessionHandle handle, FmlObjectHandle objectHandle, int memberIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
         return -1;
     }
-        
-    FmlObjectHandle componentTypeHandle = Fieldml_GetTypeComponentEnsemble( handle, objectHandle );
     
-    if( componentTypeHandle == FML_INVALID_HANDLE )
+    const EnsembleMembers *members = getEnsembleMembers( session, objectHandle );
+    if( members == NULL )
     {
-        if( session->getLastError() == FML_ERR_NO_ERROR )
-        {
-            return 1;
-        }
         return -1;
     }
     
-    return Fieldml_GetMemberCount( handle, componentTypeHandle );
+    if( ( memberIndex < 1 ) || ( memberIndex > members->getCount() ) )
+    {
+        session->setError( FML_ERR_INVALID_INDEX, objectHandle, "Cannot get ensemble member. Invalid index." );
+        return -1;
+    }
+    
+    return members->getMember( memberIndex - 1 );
 }
 
 
-int Fieldml_GetMemberCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+int Fieldml_GetEnsembleMembers( FmlSessionHandle handle, FmlObjectHandle objectHandle, int firstMemberIndex, FmlEnsembleValue *members, int capacity )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
         return -1;
     }
-        
-    FieldmlObject *object = getObject( session, objectHandle );
-
-    if( object == NULL ) 
+    
+    if( firstMemberIndex < 1 )
     {
+        session->setError( FML_ERR_INVALID_PARAMETER_3, objectHandle, "Cannot get ensemble members. Invalid index." );
         return -1;
     }
-
-    if( object->objectType == FHT_ENSEMBLE_TYPE )
+    
+    if( ( capacity < 0 ) || ( ( members == NULL ) && ( capacity > 0 ) ) )
     {
-        EnsembleType *ensembleType = (EnsembleType*)object;
-        return ensembleType->count;
+        session->setError( FML_ERR_INVALID_PARAMETER_5, objectHandle, "Cannot get ensemble members. Invalid capacity." );
+        return -1;
     }
-    else if( object->objectType == FHT_MESH_TYPE )
+    
+    const EnsembleMembers *ensembleMembers = getEnsembleMembers( session, objectHandle );
+    if( ensembleMembers == NULL )
     {
-        MeshType *meshType = (MeshType*)object;
-        return Fieldml_GetMemberCount( handle, meshType->elementsType );
+        return -1;
     }
-        
+    
+    session->setError( FML_ERR_NO_ERROR, "" );
+    return ensembleMembers->getMembers( firstMemberIndex - 1, members, capacity );
+}
 
-    session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot get member count. Must be a type with members/elements." );  
-    return -1;
+
+int Fieldml_GetEnsembleMemberIndex( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue member )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+    
+    const EnsembleMembers *members = getEnsembleMembers( session, objectHandle, true );
+    if( members == NULL )
+    {
+        return -1;
+    }
+    
+    session->setError( FML_ERR_NO_ERROR, "" );
+    return members->getPosition( member ) + 1;
 }
 
 
 FmlEnsembleValue Fieldml_GetEnsembleMembersMin( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -973,8 +1508,9 @@ FmlEnsembleValue Fieldml_GetEnsembleMembersMin( FmlSessionHandle handle, FmlObje
 
 FmlEnsembleValue Fieldml_GetEnsembleMembersMax( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1006,8 +1542,9 @@ FmlEnsembleValue Fieldml_GetEnsembleMembersMax( FmlSessionHandle handle, FmlObje
 
 int Fieldml_GetEnsembleMembersStride( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1039,8 +1576,9 @@ int Fieldml_GetEnsembleMembersStride( FmlSessionHandle handle, FmlObjectHandle o
 
 FieldmlEnsembleMembersType Fieldml_GetEnsembleMembersType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1072,13 +1610,18 @@ FieldmlEnsembleMembersType Fieldml_GetEnsembleMembersType( FmlSessionHandle hand
 
 FmlErrorNumber Fieldml_SetEnsembleMembersDataSource( FmlSessionHandle handle, FmlObjectHandle objectHandle, FieldmlEnsembleMembersType type, int count, FmlObjectHandle dataSourceHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
     
     if( !checkLocal( session, objectHandle ) )
     {
@@ -1105,6 +1648,7 @@ FmlErrorNumber Fieldml_SetEnsembleMembersDataSource( FmlSessionHandle handle, Fm
             return session->setError( FML_ERR_INVALID_PARAMETER_3, objectHandle, "Has a member type which cannot be used with a data source." );
         }
         
+        ensembleType = (EnsembleType*)getWritableObject( session, objectHandle );
         ensembleType->membersType = type;
         ensembleType->count = count;
         ensembleType->dataSource = dataSourceHandle;
@@ -1122,8 +1666,9 @@ FmlErrorNumber Fieldml_SetEnsembleMembersDataSource( FmlSessionHandle handle, Fm
 
 FmlBoolean Fieldml_IsEnsembleComponentType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1150,8 +1695,9 @@ FmlBoolean Fieldml_IsEnsembleComponentType( FmlSessionHandle handle, FmlObjectHa
 
 FmlObjectHandle Fieldml_GetMeshElementsType( FmlSessionHandle handle, FmlObjectHandle meshHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1177,8 +1723,9 @@ FmlObjectHandle Fieldml_GetMeshElementsType( FmlSessionHandle handle, FmlObjectH
 
 FmlObjectHandle Fieldml_GetMeshShapes( FmlSessionHandle handle, FmlObjectHandle meshHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1203,8 +1750,9 @@ FmlObjectHandle Fieldml_GetMeshShapes( FmlSessionHandle handle, FmlObjectHandle
 
 FmlObjectHandle Fieldml_GetMeshChartType( FmlSessionHandle handle, FmlObjectHandle meshHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1230,8 +1778,9 @@ FmlObjectHandle Fieldml_GetMeshChartType( FmlSessionHandle handle, FmlObjectHand
 
 FmlObjectHandle Fieldml_GetMeshChartComponentType( FmlSessionHandle handle, FmlObjectHandle meshHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1257,8 +1806,9 @@ FmlObjectHandle Fieldml_GetMeshChartComponentType( FmlSessionHandle handle, FmlO
 
 FmlBoolean Fieldml_IsObjectLocal( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlBoolean isDeclaredOnly )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1283,10 +1833,11 @@ FmlBoolean Fieldml_IsObjectLocal( FmlSessionHandle handle, FmlObjectHandle objec
 }
 
 
-char * Fieldml_GetObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1298,26 +1849,40 @@ char * Fieldml_GetObjectName( FmlSessionHandle handle, FmlObjectHandle objectHan
         return NULL;
     }
     
-    string name = session->region->getObjectName( objectHandle );
+    const string &name = session->region->getObjectName( objectHandle );
     if( name == "" )
     {
         return NULL;
     }
     
-    return cstrCopy( name.c_str() );
+    return name.c_str();
+}
+
+
+char * Fieldml_GetObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekObjectName( handle, objectHandle ) );
 }
 
 
 int Fieldml_CopyObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetObjectName( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekObjectName( handle, objectHandle ), buffer, bufferLength );
 }
 
 
-char * Fieldml_GetObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1330,25 +1895,43 @@ char * Fieldml_GetObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle o
         return NULL;
     }
     
-    return cstrCopy( object->name.c_str() );
+    return object->name.c_str();
+}
+
+
+char * Fieldml_GetObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekObjectDeclaredName( handle, objectHandle ) );
 }
 
 
 int Fieldml_CopyObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetObjectDeclaredName( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekObjectDeclaredName( handle, objectHandle ), buffer, bufferLength );
 }
 
 
 FmlErrorNumber Fieldml_SetObjectInt( FmlSessionHandle handle, FmlObjectHandle objectHandle, int value )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
         
     FieldmlObject *object = getObject( session, objectHandle );
 
@@ -1357,6 +1940,7 @@ FmlErrorNumber Fieldml_SetObjectInt( FmlSessionHandle handle, FmlObjectHandle ob
         return session->getLastError();
     }
 
+    object = getWritableObject( session, objectHandle );
     object->intValue = value;
     return session->getLastError();
 }
@@ -1364,8 +1948,9 @@ FmlErrorNumber Fieldml_SetObjectInt( FmlSessionHandle handle, FmlObjectHandle ob
 
 int Fieldml_GetObjectInt( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1385,8 +1970,9 @@ int Fieldml_GetObjectInt( FmlSessionHandle handle, FmlObjectHandle objectHandle
 
 FmlObjectHandle Fieldml_GetValueType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1406,13 +1992,18 @@ FmlObjectHandle Fieldml_GetValueType( FmlSessionHandle handle, FmlObjectHandle o
 
 FmlObjectHandle Fieldml_CreateArgumentEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( session->region == NULL )
     {
         session->setError( FML_ERR_INVALID_REGION, "FieldML session has no region" );
@@ -1476,14 +2067,14 @@ FmlObjectHandle Fieldml_CreateArgumentEvaluator( FmlSessionHandle handle, const
         }
         
         //Shouldn't need to check for name-collision, as we already have.
-        ArgumentEvaluator *chartEvaluator = new ArgumentEvaluator( chartName.c_str(), chartType, true );
+        ArgumentEvaluator *chartEvaluator = new( session->objects.getArena() ) ArgumentEvaluator( session->objects.internName( chartName ), chartType, true );
         addObject( session, chartEvaluator );        
         
-        ArgumentEvaluator *elementEvaluator = new ArgumentEvaluator( elementsName.c_str(), elementsType, true );
+        ArgumentEvaluator *elementEvaluator = new( session->objects.getArena() ) ArgumentEvaluator( session->objects.internName( elementsName ), elementsType, true );
         addObject( session, elementEvaluator );        
     }
     
-    ArgumentEvaluator *argumentEvaluator = new ArgumentEvaluator( name, valueType, false );
+    ArgumentEvaluator *argumentEvaluator = new( session->objects.getArena() ) ArgumentEvaluator( session->objects.internName( name ), valueType, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, argumentEvaluator );
@@ -1492,13 +2083,18 @@ FmlObjectHandle Fieldml_CreateArgumentEvaluator( FmlSessionHandle handle, const
 
 FmlObjectHandle Fieldml_CreateExternalEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create external evaluator. Invalid name." );
@@ -1516,7 +2112,7 @@ FmlObjectHandle Fieldml_CreateExternalEvaluator( FmlSessionHandle handle, const
         return FML_INVALID_HANDLE;
     }
         
-    ExternalEvaluator *externalEvaluator = new ExternalEvaluator( name, valueType, false );
+    ExternalEvaluator *externalEvaluator = new( session->objects.getArena() ) ExternalEvaluator( session->objects.internName( name ), valueType, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, externalEvaluator );
@@ -1525,13 +2121,18 @@ FmlObjectHandle Fieldml_CreateExternalEvaluator( FmlSessionHandle handle, const
 
 FmlObjectHandle Fieldml_CreateParameterEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create parameter evaluator. Invalid name." );
@@ -1549,7 +2150,7 @@ FmlObjectHandle Fieldml_CreateParameterEvaluator( FmlSessionHandle handle, const
         return FML_INVALID_HANDLE;
     }
         
-    ParameterEvaluator *parameterEvaluator = new ParameterEvaluator( name, valueType, false );
+    ParameterEvaluator *parameterEvaluator = new( session->objects.getArena() ) ParameterEvaluator( session->objects.internName( name ), valueType, false, session->objects.getArena() );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, parameterEvaluator );
@@ -1558,13 +2159,18 @@ FmlObjectHandle Fieldml_CreateParameterEvaluator( FmlSessionHandle handle, const
 
 FmlErrorNumber Fieldml_SetParameterDataDescription( FmlSessionHandle handle, FmlObjectHandle objectHandle, FieldmlDataDescriptionType description )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -1578,23 +2184,27 @@ FmlErrorNumber Fieldml_SetParameterDataDescription( FmlSessionHandle handle, Fml
         {
             return session->setError( FML_ERR_ACCESS_VIOLATION, objectHandle, "Parameter evaluator already has a data description." );
         }
+        if( ( description != FML_DATA_DESCRIPTION_DOK_ARRAY ) && ( description != FML_DATA_DESCRIPTION_DENSE_ARRAY ) )
+        {
+            return session->setError( FML_ERR_UNSUPPORTED, objectHandle, "Unsupported/invalid data description." );  
+        }
+        
+        parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
 
         if( description == FML_DATA_DESCRIPTION_DOK_ARRAY )
         {
             delete parameter->dataDescription;
-            parameter->dataDescription = new DokArrayDataDescription();
+            parameter->dataDescription = new( session->objects.getArena() ) DokArrayDataDescription();
+            session->invalidateDependencies( objectHandle );
             return session->getLastError();
         }
-        else if( description == FML_DATA_DESCRIPTION_DENSE_ARRAY )
+        else
         {
             delete parameter->dataDescription;
-            parameter->dataDescription = new DenseArrayDataDescription();
+            parameter->dataDescription = new( session->objects.getArena() ) DenseArrayDataDescription();
+            session->invalidateDependencies( objectHandle );
             return session->getLastError();
         }
-        else
-        {
-            return session->setError( FML_ERR_UNSUPPORTED, objectHandle, "Unsupported/invalid data description." );  
-        }
     }
 
     return session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Must be a parameter evaluator." );
@@ -1603,8 +2213,9 @@ FmlErrorNumber Fieldml_SetParameterDataDescription( FmlSessionHandle handle, Fml
 
 FieldmlDataDescriptionType Fieldml_GetParameterDataDescription( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1624,13 +2235,18 @@ FieldmlDataDescriptionType Fieldml_GetParameterDataDescription( FmlSessionHandle
 
 FmlErrorNumber Fieldml_SetDataSource( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle dataSource )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     FieldmlObject *object = getObject( session, objectHandle );
     if( object == NULL )
@@ -1657,12 +2273,14 @@ FmlErrorNumber Fieldml_SetDataSource( FmlSessionHandle handle, FmlObjectHandle o
         if( parameter->dataDescription->descriptionType == FML_DATA_DESCRIPTION_DENSE_ARRAY )
         {
             //TODO Check that the rank of the data source is equal to the number of dense indexes.
+            parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
             DenseArrayDataDescription *denseArray = (DenseArrayDataDescription*)parameter->dataDescription;
             denseArray->dataSource = dataSource;
         }
         else if( parameter->dataDescription->descriptionType == FML_DATA_DESCRIPTION_DOK_ARRAY )
         {
             //TODO Check that the rank of the data source is equal to the number of dense indexes plus one.
+            parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
             DokArrayDataDescription *dokArray = (DokArrayDataDescription*)parameter->dataDescription;
             dokArray->valueSource = dataSource;
         }
@@ -1683,6 +2301,7 @@ FmlErrorNumber Fieldml_SetDataSource( FmlSessionHandle handle, FmlObjectHandle o
             return session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Ensemble type does not require a data source." );
         }
         
+        ensembleType = (EnsembleType*)getWritableObject( session, objectHandle );
         ensembleType->dataSource = dataSource;
     }
     else if( object->objectType == FHT_MESH_TYPE )
@@ -1701,13 +2320,18 @@ FmlErrorNumber Fieldml_SetDataSource( FmlSessionHandle handle, FmlObjectHandle o
 
 FmlErrorNumber Fieldml_SetKeyDataSource( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle dataSource )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -1738,6 +2362,7 @@ FmlErrorNumber Fieldml_SetKeyDataSource( FmlSessionHandle handle, FmlObjectHandl
     {
         if( parameter->dataDescription->descriptionType == FML_DATA_DESCRIPTION_DOK_ARRAY )
         {
+            parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
             DokArrayDataDescription *dokArray = (DokArrayDataDescription*)parameter->dataDescription;
             dokArray->keySource = dataSource;
         }
@@ -1754,13 +2379,18 @@ FmlErrorNumber Fieldml_SetKeyDataSource( FmlSessionHandle handle, FmlObjectHandl
 
 FmlErrorNumber Fieldml_AddDenseIndexEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle indexHandle, FmlObjectHandle orderHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     FieldmlObject *object = getObject( session, objectHandle );
     if( object == NULL )
@@ -1812,7 +2442,9 @@ FmlErrorNumber Fieldml_AddDenseIndexEvaluator( FmlSessionHandle handle, FmlObjec
     ParameterEvaluator *parameter = ParameterEvaluator::checkedCast( session, objectHandle );
     if( parameter != NULL )
     {
+        parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
         FmlErrorNumber error = parameter->dataDescription->addIndexEvaluator( false, indexHandle, orderHandle );
+        session->invalidateDependencies( objectHandle );
         return session->setError( error, objectHandle, "Cannot set dense index evaluator." );
     }
     
@@ -1822,13 +2454,18 @@ FmlErrorNumber Fieldml_AddDenseIndexEvaluator( FmlSessionHandle handle, FmlObjec
 
 FmlErrorNumber Fieldml_AddSparseIndexEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle indexHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -1852,7 +2489,9 @@ FmlErrorNumber Fieldml_AddSparseIndexEvaluator( FmlSessionHandle handle, FmlObje
     ParameterEvaluator *parameter = ParameterEvaluator::checkedCast( session, objectHandle );
     if( parameter != NULL )
     {
+        parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
         FmlErrorNumber error = parameter->dataDescription->addIndexEvaluator( true, indexHandle, FML_INVALID_HANDLE );
+        session->invalidateDependencies( objectHandle );
         return session->setError( error, objectHandle, "Cannot set sparse index evaluator." );
     }
     
@@ -1862,8 +2501,9 @@ FmlErrorNumber Fieldml_AddSparseIndexEvaluator( FmlSessionHandle handle, FmlObje
 
 int Fieldml_GetParameterIndexCount( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlBoolean isSparse )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1889,8 +2529,9 @@ int Fieldml_GetParameterIndexCount( FmlSessionHandle handle, FmlObjectHandle obj
 
 FmlObjectHandle Fieldml_GetParameterIndexEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int index, FmlBoolean isSparse )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -1914,13 +2555,18 @@ FmlObjectHandle Fieldml_GetParameterIndexEvaluator( FmlSessionHandle handle, Fml
 
 FmlObjectHandle Fieldml_CreatePiecewiseEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create piecewise evaluator. Invalid name." );
@@ -1938,7 +2584,7 @@ FmlObjectHandle Fieldml_CreatePiecewiseEvaluator( FmlSessionHandle handle, const
         return FML_INVALID_HANDLE;
     }
         
-    PiecewiseEvaluator *piecewiseEvaluator = new PiecewiseEvaluator( name, valueType, false );
+    PiecewiseEvaluator *piecewiseEvaluator = new( session->objects.getArena() ) PiecewiseEvaluator( session->objects.internName( name ), valueType, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, piecewiseEvaluator );
@@ -1947,13 +2593,18 @@ FmlObjectHandle Fieldml_CreatePiecewiseEvaluator( FmlSessionHandle handle, const
 
 FmlObjectHandle Fieldml_CreateAggregateEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create aggregate evaluator. Invalid name." );
@@ -1971,7 +2622,7 @@ FmlObjectHandle Fieldml_CreateAggregateEvaluator( FmlSessionHandle handle, const
         return FML_INVALID_HANDLE;
     }
         
-    AggregateEvaluator *aggregateEvaluator = new AggregateEvaluator( name, valueType, false );
+    AggregateEvaluator *aggregateEvaluator = new( session->objects.getArena() ) AggregateEvaluator( session->objects.internName( name ), valueType, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, aggregateEvaluator );
@@ -1980,13 +2631,18 @@ FmlObjectHandle Fieldml_CreateAggregateEvaluator( FmlSessionHandle handle, const
 
 FmlErrorNumber Fieldml_SetDefaultEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle evaluator )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2021,15 +2677,19 @@ FmlErrorNumber Fieldml_SetDefaultEvaluator( FmlSessionHandle handle, FmlObjectHa
         return session->getLastError();
     }
 
+    getWritableObject( session, objectHandle );
+    map = getEvaluatorMap( session, objectHandle );
     map->setDefault( evaluator );
+    session->invalidateDependencies( objectHandle );
     return session->getLastError();
 }
 
 
 FmlObjectHandle Fieldml_GetDefaultEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2049,13 +2709,18 @@ FmlObjectHandle Fieldml_GetDefaultEvaluator( FmlSessionHandle handle, FmlObjectH
 
 FmlErrorNumber Fieldml_SetEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue element, FmlObjectHandle evaluator )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2090,15 +2755,112 @@ FmlErrorNumber Fieldml_SetEvaluator( FmlSessionHandle handle, FmlObjectHandle ob
         return session->getLastError();
     }
     
+    getWritableObject( session, objectHandle );
+    map = getEvaluatorMap( session, objectHandle );
     map->set( element, evaluator );
+    session->invalidateDependencies( objectHandle );
     return session->getLastError();
 }
 
 
+FmlErrorNumber Fieldml_SetEvaluators( FmlSessionHandle handle, FmlObjectHandle objectHandle, int count, const FmlEnsembleValue *elements, const FmlObjectHandle *evaluators )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return FML_ERR_UNKNOWN_HANDLE;
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+
+    if( !checkLocal( session, objectHandle ) )
+    {
+        return session->getLastError();
+    }
+    
+    if( count < 0 )
+    {
+        return session->setError( FML_ERR_INVALID_PARAMETER_3, objectHandle, "Invalid evaluator count." );
+    }
+    if( count == 0 )
+    {
+        return session->setError( FML_ERR_NO_ERROR, "" );
+    }
+    if( elements == NULL )
+    {
+        return session->setError( FML_ERR_INVALID_PARAMETER_4, objectHandle, "Element array cannot be null." );
+    }
+    if( evaluators == NULL )
+    {
+        return session->setError( FML_ERR_INVALID_PARAMETER_5, objectHandle, "Evaluator array cannot be null." );
+    }
+
+    SimpleMap<FmlEnsembleValue, FmlObjectHandle> *map = getEvaluatorMap( session, objectHandle ); 
+ 
+    if( map == NULL )
+    {
+        return session->getLastError();
+    }
+    
+    bool isAggregate = ( Fieldml_GetObjectType( handle, objectHandle ) == FHT_AGGREGATE_EVALUATOR );
+    
+    set<FmlObjectHandle> checkedEvaluators;
+    vector<pair<FmlEnsembleValue, FmlObjectHandle> > pairs;
+    pairs.reserve( count );
+    
+    for( int i = 0; i < count; i++ )
+    {
+        FmlObjectHandle evaluator = evaluators[i];
+        pairs.push_back( pair<FmlEnsembleValue, FmlObjectHandle>( elements[i], evaluator ) );
+        
+        if( ( evaluator == FML_INVALID_HANDLE ) || FmlUtil::contains( checkedEvaluators, evaluator ) )
+        {
+            continue;
+        }
+        
+        if( !checkLocal( session, evaluator ) )
+        {
+            return session->getLastError();
+        }
+    
+        if( isAggregate )
+        {
+            if( !checkIsEvaluatorType( session, evaluator, true, false, false ) )
+            {
+                return session->setError( FML_ERR_INVALID_PARAMETER_5, evaluator, "Invalid type for aggregator delegate." );
+            }
+        }
+        else if( !checkIsEvaluatorTypeCompatible( session, objectHandle, evaluator ) )
+        {
+            return session->setError( FML_ERR_INVALID_PARAMETER_5, objectHandle, "Incompatible type for delegate evaluator." );
+        }
+        
+        if( !checkCyclicDependency( session, objectHandle, evaluator ) )
+        {
+            return session->getLastError();
+        }
+        
+        checkedEvaluators.insert( evaluator );
+    }
+    
+    getWritableObject( session, objectHandle );
+    map = getEvaluatorMap( session, objectHandle );
+    map->setAll( pairs );
+    session->invalidateDependencies( objectHandle );
+    return session->setError( FML_ERR_NO_ERROR, "" );
+}
+
+
 int Fieldml_GetEvaluatorCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2118,8 +2880,9 @@ int Fieldml_GetEvaluatorCount( FmlSessionHandle handle, FmlObjectHandle objectHa
 
 FmlEnsembleValue Fieldml_GetEvaluatorElement( FmlSessionHandle handle, FmlObjectHandle objectHandle, int evaluatorIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2139,8 +2902,9 @@ FmlEnsembleValue Fieldml_GetEvaluatorElement( FmlSessionHandle handle, FmlObject
 
 FmlObjectHandle Fieldml_GetEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int evaluatorIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2158,10 +2922,40 @@ FmlObjectHandle Fieldml_GetEvaluator( FmlSessionHandle handle, FmlObjectHandle o
 }
 
 
+int Fieldml_GetEvaluators( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue *elements, FmlObjectHandle *evaluators, int capacity )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+    
+    if( capacity < 0 )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_5, objectHandle, "Invalid capacity." );
+        return -1;
+    }
+
+    SimpleMap<FmlEnsembleValue, FmlObjectHandle> *map = getEvaluatorMap( session, objectHandle ); 
+ 
+    if( map == NULL )
+    {
+        return -1;
+    }
+
+    session->setError( FML_ERR_NO_ERROR, "" );
+    return copyMap( map, elements, evaluators, capacity );
+}
+
+
 FmlObjectHandle Fieldml_GetElementEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue elementNumber, FmlBoolean allowDefault )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2181,13 +2975,18 @@ FmlObjectHandle Fieldml_GetElementEvaluator( FmlSessionHandle handle, FmlObjectH
 
 FmlObjectHandle Fieldml_CreateReferenceEvaluator( FmlSessionHandle handle, const char * name, FmlObjectHandle sourceEvaluator )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create reference evaluator. Invalid name." );
@@ -2201,7 +3000,7 @@ FmlObjectHandle Fieldml_CreateReferenceEvaluator( FmlSessionHandle handle, const
 
     FmlObjectHandle valueType = Fieldml_GetValueType( handle, sourceEvaluator );
 
-    ReferenceEvaluator *referenceEvaluator = new ReferenceEvaluator( name, sourceEvaluator, valueType, false );
+    ReferenceEvaluator *referenceEvaluator = new( session->objects.getArena() ) ReferenceEvaluator( session->objects.internName( name ), sourceEvaluator, valueType, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, referenceEvaluator );
@@ -2210,8 +3009,9 @@ FmlObjectHandle Fieldml_CreateReferenceEvaluator( FmlSessionHandle handle, const
 
 FmlObjectHandle Fieldml_GetReferenceSourceEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2231,8 +3031,9 @@ FmlObjectHandle Fieldml_GetReferenceSourceEvaluator( FmlSessionHandle handle, Fm
 
 int Fieldml_GetArgumentCount( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlBoolean isBound, FmlBoolean isUsed )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2250,8 +3051,9 @@ int Fieldml_GetArgumentCount( FmlSessionHandle handle, FmlObjectHandle objectHan
 
 FmlObjectHandle Fieldml_GetArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, int argumentIndex, FmlBoolean isBound, FmlBoolean isUsed )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2274,15 +3076,57 @@ FmlObjectHandle Fieldml_GetArgument( FmlSessionHandle handle, FmlObjectHandle ob
 }
 
 
+int Fieldml_GetArguments( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlBoolean isBound, FmlBoolean isUsed, FmlObjectHandle *arguments, int capacity )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return -1;
+    }
+    
+    if( capacity < 0 )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_6, objectHandle, "Invalid capacity." );
+        return -1;
+    }
+
+    session->setError( FML_ERR_NO_ERROR, "" );
+    vector<FmlObjectHandle> args = getArgumentList( session, objectHandle, isBound != 0, isUsed != 0 );
+    if( session->getLastError() != FML_ERR_NO_ERROR )
+    {
+        return -1;
+    }
+    
+    if( arguments != NULL )
+    {
+        int count = min( capacity, (int)args.size() );
+        for( int i = 0; i < count; i++ )
+        {
+            arguments[i] = args[i];
+        }
+    }
+    
+    return args.size();
+}
+
+
 FmlErrorNumber Fieldml_AddArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle evaluatorHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2301,14 +3145,18 @@ FmlErrorNumber Fieldml_AddArgument( FmlSessionHandle handle, FmlObjectHandle obj
     ArgumentEvaluator *argumentEvaluator = ArgumentEvaluator::checkedCast( session, objectHandle );
     if( argumentEvaluator != NULL )
     {
+        argumentEvaluator = (ArgumentEvaluator*)getWritableObject( session, objectHandle );
         argumentEvaluator->arguments.insert( evaluatorHandle );
+        session->invalidateDependencies( objectHandle );
         return session->getLastError();
     }
     
     ExternalEvaluator *externalEvaluator = ExternalEvaluator::checkedCast( session, objectHandle );
     if( externalEvaluator != NULL )
     {
+        externalEvaluator = (ExternalEvaluator*)getWritableObject( session, objectHandle );
         externalEvaluator->arguments.insert( evaluatorHandle );
+        session->invalidateDependencies( objectHandle );
         return session->getLastError();
     }
 
@@ -2318,8 +3166,9 @@ FmlErrorNumber Fieldml_AddArgument( FmlSessionHandle handle, FmlObjectHandle obj
 
 int Fieldml_GetBindCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2332,14 +3181,36 @@ int Fieldml_GetBindCount( FmlSessionHandle handle, FmlObjectHandle objectHandle
         return -1;
     }
     
-    return map->size();
+    return map->size();
+}
+
+
+FmlObjectHandle Fieldml_GetBindArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, int bindIndex )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return FML_INVALID_HANDLE;
+    }
+
+    SimpleMap<FmlObjectHandle, FmlObjectHandle> *map = getBindMap( session, objectHandle );
+    if( map == NULL )
+    {
+        return FML_INVALID_HANDLE;
+    }
+    
+    return map->getKey( bindIndex - 1 );
 }
 
 
-FmlObjectHandle Fieldml_GetBindArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, int bindIndex )
+FmlObjectHandle Fieldml_GetBindEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int bindIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2352,34 +3223,43 @@ FmlObjectHandle Fieldml_GetBindArgument( FmlSessionHandle handle, FmlObjectHandl
         return FML_INVALID_HANDLE;
     }
     
-    return map->getKey( bindIndex - 1 );
+    return map->getValue( bindIndex - 1 );
 }
 
 
-FmlObjectHandle Fieldml_GetBindEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int bindIndex )
+int Fieldml_GetBinds( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle *arguments, FmlObjectHandle *sources, int capacity )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
-        return FML_INVALID_HANDLE;
+        return -1;
+    }
+    
+    if( capacity < 0 )
+    {
+        session->setError( FML_ERR_INVALID_PARAMETER_5, objectHandle, "Invalid capacity." );
+        return -1;
     }
 
     SimpleMap<FmlObjectHandle, FmlObjectHandle> *map = getBindMap( session, objectHandle );
     if( map == NULL )
     {
-        return FML_INVALID_HANDLE;
+        return -1;
     }
     
-    return map->getValue( bindIndex - 1 );
+    session->setError( FML_ERR_NO_ERROR, "" );
+    return copyMap( map, arguments, sources, capacity );
 }
 
 
 FmlObjectHandle Fieldml_GetBindByArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle argumentHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2398,13 +3278,18 @@ FmlObjectHandle Fieldml_GetBindByArgument( FmlSessionHandle handle, FmlObjectHan
 
 FmlErrorNumber Fieldml_SetBind( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle argumentHandle, FmlObjectHandle sourceHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2435,7 +3320,10 @@ FmlErrorNumber Fieldml_SetBind( FmlSessionHandle handle, FmlObjectHandle objectH
         return session->getLastError();
     }
     
+    getWritableObject( session, objectHandle );
+    map = getBindMap( session, objectHandle );
     map->set( argumentHandle, sourceHandle );
+    session->invalidateDependencies( objectHandle );
     return session->getLastError();
 }
 
@@ -2443,8 +3331,9 @@ FmlErrorNumber Fieldml_SetBind( FmlSessionHandle handle, FmlObjectHandle objectH
 
 int Fieldml_GetIndexEvaluatorCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2495,13 +3384,18 @@ int Fieldml_GetIndexEvaluatorCount( FmlSessionHandle handle, FmlObjectHandle obj
 
 FmlErrorNumber Fieldml_SetIndexEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int index, FmlObjectHandle evaluatorHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2527,7 +3421,9 @@ FmlErrorNumber Fieldml_SetIndexEvaluator( FmlSessionHandle handle, FmlObjectHand
     {
         if( index == 1 )
         {
+            piecewise = (PiecewiseEvaluator*)getWritableObject( session, objectHandle );
             piecewise->indexEvaluator = evaluatorHandle;
+            session->invalidateDependencies( objectHandle );
             return session->getLastError();
         }
         else
@@ -2541,7 +3437,9 @@ FmlErrorNumber Fieldml_SetIndexEvaluator( FmlSessionHandle handle, FmlObjectHand
     {
         if( index == 1 )
         {
+            aggregate = (AggregateEvaluator*)getWritableObject( session, objectHandle );
             aggregate->indexEvaluator = evaluatorHandle;
+            session->invalidateDependencies( objectHandle );
             return session->getLastError();
         }
         else
@@ -2553,7 +3451,9 @@ FmlErrorNumber Fieldml_SetIndexEvaluator( FmlSessionHandle handle, FmlObjectHand
     ParameterEvaluator *parameter = ParameterEvaluator::checkedCast( session, objectHandle );
     if( parameter != NULL )
     {
+        parameter = (ParameterEvaluator*)getWritableObject( session, objectHandle );
         FmlErrorNumber error = parameter->dataDescription->setIndexEvaluator( index-1, evaluatorHandle, FML_INVALID_HANDLE );
+        session->invalidateDependencies( objectHandle );
         return session->setError( error, objectHandle, "Cannot set index evaluator." );
     }
     
@@ -2563,8 +3463,9 @@ FmlErrorNumber Fieldml_SetIndexEvaluator( FmlSessionHandle handle, FmlObjectHand
 
 FmlObjectHandle Fieldml_GetIndexEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int indexNumber )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2618,8 +3519,9 @@ FmlObjectHandle Fieldml_GetIndexEvaluator( FmlSessionHandle handle, FmlObjectHan
 
 FmlObjectHandle Fieldml_GetParameterIndexOrder( FmlSessionHandle handle, FmlObjectHandle objectHandle, int index )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -2643,20 +3545,25 @@ FmlObjectHandle Fieldml_GetParameterIndexOrder( FmlSessionHandle handle, FmlObje
 
 FmlObjectHandle Fieldml_CreateBooleanType( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create boolean type. Invalid name." );
         return FML_INVALID_HANDLE;
     }
 
-    BooleanType *booleanType = new BooleanType( name, false );
+    BooleanType *booleanType = new( session->objects.getArena() ) BooleanType( session->objects.internName( name ), false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, booleanType );
@@ -2665,20 +3572,25 @@ FmlObjectHandle Fieldml_CreateBooleanType( FmlSessionHandle handle, const char *
 
 FmlObjectHandle Fieldml_CreateContinuousType( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create continuous type. Invalid name." );
         return FML_INVALID_HANDLE;
     }
 
-    ContinuousType *continuousType = new ContinuousType( name, false );
+    ContinuousType *continuousType = new( session->objects.getArena() ) ContinuousType( session->objects.internName( name ), false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, continuousType );
@@ -2687,13 +3599,18 @@ FmlObjectHandle Fieldml_CreateContinuousType( FmlSessionHandle handle, const cha
 
 FmlObjectHandle Fieldml_CreateContinuousTypeComponents( FmlSessionHandle handle, FmlObjectHandle typeHandle, const char * name, const int count )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_3, typeHandle, "Cannot create components. Invalid name." );
@@ -2742,10 +3659,11 @@ FmlObjectHandle Fieldml_CreateContinuousTypeComponents( FmlSessionHandle handle,
         trueName = type->name + ( name + 1 );
     }
     
-    EnsembleType *ensembleType = new EnsembleType( trueName, true, false );
+    EnsembleType *ensembleType = new( session->objects.getArena() ) EnsembleType( session->objects.internName( trueName ), true, false );
     FmlObjectHandle componentHandle = addObject( session, ensembleType );
     Fieldml_SetEnsembleMembersRange( handle, componentHandle, 1, count, 1 );
     
+    type = (ContinuousType*)getWritableObject( session, typeHandle );
     type->componentType = componentHandle;
     
     return componentHandle;
@@ -2754,20 +3672,25 @@ FmlObjectHandle Fieldml_CreateContinuousTypeComponents( FmlSessionHandle handle,
 
 FmlObjectHandle Fieldml_CreateEnsembleType( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create ensemble type. Invalid name." );
         return FML_INVALID_HANDLE;
     }
 
-    EnsembleType *ensembleType = new EnsembleType( name, false, false );
+    EnsembleType *ensembleType = new( session->objects.getArena() ) EnsembleType( session->objects.internName( name ), false, false );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, ensembleType );
@@ -2776,20 +3699,25 @@ FmlObjectHandle Fieldml_CreateEnsembleType( FmlSessionHandle handle, const char
 
 FmlObjectHandle Fieldml_CreateMeshType( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create mesh type. Invalid name." );
         return FML_INVALID_HANDLE;
     }
 
-    MeshType *meshType = new MeshType( name, false );
+    MeshType *meshType = new( session->objects.getArena() ) MeshType( session->objects.internName( name ), false );
 
     session->setError( FML_ERR_NO_ERROR, "" );
 
@@ -2799,13 +3727,18 @@ FmlObjectHandle Fieldml_CreateMeshType( FmlSessionHandle handle, const char * na
 
 FmlObjectHandle Fieldml_CreateMeshElementsType( FmlSessionHandle handle, FmlObjectHandle meshHandle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_3, meshHandle, "Cannot create mesh elements. Invalid name." );
@@ -2831,9 +3764,10 @@ FmlObjectHandle Fieldml_CreateMeshElementsType( FmlSessionHandle handle, FmlObje
     
     MeshType *meshType = (MeshType*)object;
 
-    EnsembleType *ensembleType = new EnsembleType( meshType->name + "." + name, false, true );
+    EnsembleType *ensembleType = new( session->objects.getArena() ) EnsembleType( session->objects.internName( meshType->name + "." + name ), false, true );
     FmlObjectHandle elementsHandle = addObject( session, ensembleType );
     
+    meshType = (MeshType*)getWritableObject( session, meshHandle );
     meshType->elementsType = elementsHandle;
     
     return elementsHandle;
@@ -2842,13 +3776,18 @@ FmlObjectHandle Fieldml_CreateMeshElementsType( FmlSessionHandle handle, FmlObje
 
 FmlObjectHandle Fieldml_CreateMeshChartType( FmlSessionHandle handle, FmlObjectHandle meshHandle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_3, meshHandle, "Cannot create mesh chart. Invalid name." );
@@ -2874,9 +3813,10 @@ FmlObjectHandle Fieldml_CreateMeshChartType( FmlSessionHandle handle, FmlObjectH
     
     MeshType *meshType = (MeshType*)object;
 
-    ContinuousType *chartType = new ContinuousType( meshType->name + "." + name, true );
+    ContinuousType *chartType = new( session->objects.getArena() ) ContinuousType( session->objects.internName( meshType->name + "." + name ), true );
     FmlObjectHandle chartHandle = addObject( session, chartType );
     
+    meshType = (MeshType*)getWritableObject( session, meshHandle );
     meshType->chartType = chartHandle;
     
     return chartHandle;
@@ -2885,13 +3825,18 @@ FmlObjectHandle Fieldml_CreateMeshChartType( FmlSessionHandle handle, FmlObjectH
 
 FmlErrorNumber Fieldml_SetMeshShapes( FmlSessionHandle handle, FmlObjectHandle meshHandle, FmlObjectHandle shapesHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, meshHandle ) )
     {
@@ -2914,7 +3859,7 @@ FmlErrorNumber Fieldml_SetMeshShapes( FmlSessionHandle handle, FmlObjectHandle m
     }
     else if( object->objectType == FHT_MESH_TYPE ) 
     {
-        MeshType *meshType = (MeshType *)object;
+        MeshType *meshType = (MeshType *)getWritableObject( session, meshHandle );
         meshType->shapes = shapesHandle;
     }
     else
@@ -2928,13 +3873,18 @@ FmlErrorNumber Fieldml_SetMeshShapes( FmlSessionHandle handle, FmlObjectHandle m
 
 FmlErrorNumber Fieldml_SetEnsembleMembersRange( FmlSessionHandle handle, FmlObjectHandle objectHandle, const FmlEnsembleValue minElement, const FmlEnsembleValue maxElement, const int stride )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     if( !checkLocal( session, objectHandle ) )
     {
@@ -2960,7 +3910,7 @@ FmlErrorNumber Fieldml_SetEnsembleMembersRange( FmlSessionHandle handle, FmlObje
     
     if( object->objectType == FHT_ENSEMBLE_TYPE )
     {
-        EnsembleType *ensemble = (EnsembleType*)object;
+        EnsembleType *ensemble = (EnsembleType*)getWritableObject( session, objectHandle );
 
         ensemble->membersType = FML_ENSEMBLE_MEMBER_RANGE;
         ensemble->min = minElement;
@@ -2982,13 +3932,18 @@ FmlErrorNumber Fieldml_SetEnsembleMembersRange( FmlSessionHandle handle, FmlObje
 
 int Fieldml_AddImportSource( FmlSessionHandle handle, const char * href, const char * regionName )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return -1;
     }
+    if( !checkMutable( session ) )
+    {
+        return -1;
+    }
     if( session->region == NULL )
     {
         session->setError( FML_ERR_INVALID_REGION, "FieldML session has no region" );
@@ -3033,13 +3988,18 @@ int Fieldml_AddImportSource( FmlSessionHandle handle, const char * href, const c
 
 FmlObjectHandle Fieldml_AddImport( FmlSessionHandle handle, int importSourceIndex, const char * localName, const char * remoteName )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( session->region == NULL )
     {
         session->setError( FML_ERR_INVALID_REGION, "FieldML session has no region" );
@@ -3064,7 +4024,7 @@ FmlObjectHandle Fieldml_AddImport( FmlSessionHandle handle, int importSourceInde
         return FML_INVALID_HANDLE;
     }
     
-    FmlObjectHandle remoteObject = region->getNamedObject( remoteName );
+    FmlObjectHandle remoteObject = session->getRegionObject( region, remoteName );
     FmlObjectHandle localObject = session->region->getNamedObject( localName );
     
     if( remoteObject == FML_INVALID_HANDLE )
@@ -3087,8 +4047,9 @@ FmlObjectHandle Fieldml_AddImport( FmlSessionHandle handle, int importSourceInde
 
 int Fieldml_GetImportSourceCount( FmlSessionHandle handle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3106,8 +4067,9 @@ int Fieldml_GetImportSourceCount( FmlSessionHandle handle )
 
 int Fieldml_GetImportCount( FmlSessionHandle handle, int importSourceIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3125,8 +4087,9 @@ int Fieldml_GetImportCount( FmlSessionHandle handle, int importSourceIndex )
 
 int Fieldml_CopyImportSourceHref( FmlSessionHandle handle, int importSourceIndex, char * buffer, int bufferLength )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3151,8 +4114,9 @@ int Fieldml_CopyImportSourceHref( FmlSessionHandle handle, int importSourceIndex
 
 int Fieldml_CopyImportSourceRegionName( FmlSessionHandle handle, int importSourceIndex, char * buffer, int bufferLength )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3177,8 +4141,9 @@ int Fieldml_CopyImportSourceRegionName( FmlSessionHandle handle, int importSourc
 
 int Fieldml_CopyImportLocalName( FmlSessionHandle handle, int importSourceIndex, int importIndex, char * buffer, int bufferLength )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3204,8 +4169,9 @@ int Fieldml_CopyImportLocalName( FmlSessionHandle handle, int importSourceIndex,
 
 int Fieldml_CopyImportRemoteName( FmlSessionHandle handle, int importSourceIndex, int importIndex, char * buffer, int bufferLength )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3230,8 +4196,9 @@ int Fieldml_CopyImportRemoteName( FmlSessionHandle handle, int importSourceIndex
 
 FmlObjectHandle Fieldml_GetImportObject( FmlSessionHandle handle, int importSourceIndex, int importIndex )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3249,13 +4216,18 @@ FmlObjectHandle Fieldml_GetImportObject( FmlSessionHandle handle, int importSour
 
 FmlObjectHandle Fieldml_CreateHrefDataResource( FmlSessionHandle handle, const char * name, const char * format, const char * href )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create href data resource. Invalid name." );
@@ -3272,7 +4244,7 @@ FmlObjectHandle Fieldml_CreateHrefDataResource( FmlSessionHandle handle, const c
         return FML_INVALID_HANDLE;
     }
 
-    DataResource *dataResource = new DataResource( name, FML_DATA_RESOURCE_HREF, format, href );
+    DataResource *dataResource = new( session->objects.getArena() ) DataResource( session->objects.internName( name ), FML_DATA_RESOURCE_HREF, format, href );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, dataResource );
@@ -3281,20 +4253,25 @@ FmlObjectHandle Fieldml_CreateHrefDataResource( FmlSessionHandle handle, const c
 
 FmlObjectHandle Fieldml_CreateInlineDataResource( FmlSessionHandle handle, const char * name )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create inline data resource. Invalid name." );
         return FML_INVALID_HANDLE;
     }
 
-    DataResource *dataResource = new DataResource( name, FML_DATA_RESOURCE_INLINE, PLAIN_TEXT_NAME, "" );
+    DataResource *dataResource = new( session->objects.getArena() ) DataResource( session->objects.internName( name ), FML_DATA_RESOURCE_INLINE, PLAIN_TEXT_NAME, "" );
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, dataResource );
 }
@@ -3302,8 +4279,9 @@ FmlObjectHandle Fieldml_CreateInlineDataResource( FmlSessionHandle handle, const
 
 FieldmlDataResourceType Fieldml_GetDataResourceType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3324,13 +4302,18 @@ FieldmlDataResourceType Fieldml_GetDataResourceType( FmlSessionHandle handle, Fm
 
 FmlErrorNumber Fieldml_AddInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle, const char * data, const int length )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
     if( data == NULL )
     {
         return session->setError( FML_ERR_INVALID_PARAMETER_3, objectHandle, "Cannot add inline data. Invalid data." );
@@ -3351,7 +4334,9 @@ FmlErrorNumber Fieldml_AddInlineData( FmlSessionHandle handle, FmlObjectHandle o
         return session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot add inline data. Must be inline data resource." );
     }
     
-    resource->description = resource->description + string( data, length );
+    //NOTE: Appending in place lets the string grow geometrically, so writing data in many small chunks stays linear.
+    resource = (DataResource*)getWritableObject( session, objectHandle );
+    resource->description.append( data, length );
     
     return session->getLastError();
 }
@@ -3359,13 +4344,18 @@ FmlErrorNumber Fieldml_AddInlineData( FmlSessionHandle handle, FmlObjectHandle o
 
 FmlErrorNumber Fieldml_SetInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle, const char * data, const int length )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
     if( data == NULL )
     {
         return session->setError( FML_ERR_INVALID_PARAMETER_3, "Cannot set inline data. Invalid data." );
@@ -3386,7 +4376,8 @@ FmlErrorNumber Fieldml_SetInlineData( FmlSessionHandle handle, FmlObjectHandle o
         return session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot set inline data. Must be inline data resource." );
     }
     
-    resource->description = string( data, length );
+    resource = (DataResource*)getWritableObject( session, objectHandle );
+    resource->description.assign( data, length );
     
     return session->getLastError();
 }
@@ -3394,8 +4385,9 @@ FmlErrorNumber Fieldml_SetInlineData( FmlSessionHandle handle, FmlObjectHandle o
 
 int Fieldml_GetInlineDataLength( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3417,10 +4409,11 @@ int Fieldml_GetInlineDataLength( FmlSessionHandle handle, FmlObjectHandle object
 }
 
 
-char * Fieldml_GetInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3438,14 +4431,25 @@ char * Fieldml_GetInlineData( FmlSessionHandle handle, FmlObjectHandle objectHan
         return NULL;
     }
     
-    return cstrCopy( resource->description );
+    return resource->description.c_str();
+}
+
+
+char * Fieldml_GetInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekInlineData( handle, objectHandle ) );
 }
 
 
 int Fieldml_CopyInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength, int offset )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3475,8 +4479,9 @@ int Fieldml_CopyInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandl
 
 FieldmlDataSourceType Fieldml_GetDataSourceType( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3493,10 +4498,11 @@ FieldmlDataSourceType Fieldml_GetDataSourceType( FmlSessionHandle handle, FmlObj
 }
 
 
-char * Fieldml_GetDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3511,7 +4517,7 @@ char * Fieldml_GetDataResourceHref( FmlSessionHandle handle, FmlObjectHandle obj
     
     if( dataResource->resourceType == FML_DATA_RESOURCE_HREF )
     {
-        return cstrCopy( dataResource->description );
+        return dataResource->description.c_str();
     }
     else
     {
@@ -3521,16 +4527,30 @@ char * Fieldml_GetDataResourceHref( FmlSessionHandle handle, FmlObjectHandle obj
 }
 
 
+char * Fieldml_GetDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekDataResourceHref( handle, objectHandle ) );
+}
+
+
 int Fieldml_CopyDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetDataResourceHref( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekDataResourceHref( handle, objectHandle ), buffer, bufferLength );
 }
 
 
-char * Fieldml_GetDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3543,20 +4563,34 @@ char * Fieldml_GetDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle o
         return NULL;
     }
     
-    return cstrCopy( dataResource->format );
+    return dataResource->format.c_str();
+}
+
+
+char * Fieldml_GetDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekDataResourceFormat( handle, objectHandle ) );
 }
 
 
 int Fieldml_CopyDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetDataResourceFormat( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekDataResourceFormat( handle, objectHandle ), buffer, bufferLength );
 }
 
 
 FmlObjectHandle Fieldml_GetDataSource( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3619,8 +4653,9 @@ FmlObjectHandle Fieldml_GetDataSource( FmlSessionHandle handle, FmlObjectHandle
 
 FmlObjectHandle Fieldml_GetKeyDataSource( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3648,8 +4683,9 @@ FmlObjectHandle Fieldml_GetKeyDataSource( FmlSessionHandle handle, FmlObjectHand
 
 int Fieldml_GetDataSourceCount( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3668,8 +4704,9 @@ int Fieldml_GetDataSourceCount( FmlSessionHandle handle, FmlObjectHandle objectH
 
 FmlObjectHandle Fieldml_GetDataSourceByIndex( FmlSessionHandle handle, FmlObjectHandle objectHandle, int index )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3694,8 +4731,9 @@ FmlObjectHandle Fieldml_GetDataSourceByIndex( FmlSessionHandle handle, FmlObject
 
 FmlObjectHandle Fieldml_GetDataSourceResource( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3722,10 +4760,11 @@ FmlObjectHandle Fieldml_GetDataSourceResource( FmlSessionHandle handle, FmlObjec
 }
 
 
-char * Fieldml_GetArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3738,20 +4777,34 @@ char * Fieldml_GetArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHan
         return NULL;
     }
 
-    return cstrCopy( source->location );
+    return source->location.c_str();
+}
+
+
+char * Fieldml_GetArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekArrayDataSourceLocation( handle, objectHandle ) );
 }
 
 
 int Fieldml_CopyArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetArrayDataSourceLocation( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekArrayDataSourceLocation( handle, objectHandle ), buffer, bufferLength );
 }
 
 
 int Fieldml_GetArrayDataSourceRank( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3783,8 +4836,30 @@ int Fieldml_GetArrayDataSourceRank( FmlSessionHandle handle, FmlObjectHandle obj
 
 FmlErrorNumber Fieldml_GetArrayDataSourceSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
+    return narrowArrayValues( session, objectHandle, source->sizes, sizes );
+}
+
+
+FmlErrorNumber Fieldml_GetArrayDataSourceSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *sizes )
+{
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3808,13 +4883,18 @@ FmlErrorNumber Fieldml_GetArrayDataSourceSizes( FmlSessionHandle handle, FmlObje
 
 FmlErrorNumber Fieldml_SetArrayDataSourceSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return session->getLastError();
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     ArrayDataSource *source = getArrayDataSource( session, objectHandle );
     if( source == NULL )
@@ -3830,20 +4910,75 @@ FmlErrorNumber Fieldml_SetArrayDataSourceSizes( FmlSessionHandle handle, FmlObje
         }
     }
     
-    source->sizes.clear();
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->sizes.assign( sizes, sizes + source->rank );
+    
+    return FML_ERR_NO_ERROR;
+}
+
+
+FmlErrorNumber Fieldml_SetArrayDataSourceSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *sizes )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
     for( int i = 0; i < source->rank; i++ )
     {
-        source->sizes.push_back( sizes[i] );
+        if( sizes[i] < 0 )
+        {
+            return session->setError( FML_ERR_INVALID_PARAMETER_3, objectHandle, "Cannot set array data sizes. Invalid size." );
+        }
     }
     
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->sizes.assign( sizes, sizes + source->rank );
+    
     return FML_ERR_NO_ERROR;
 }
 
 
 FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
+    return narrowArrayValues( session, objectHandle, source->rawSizes, sizes );
+}
+
+
+FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *sizes )
+{
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3867,13 +5002,18 @@ FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlO
 
 FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return session->getLastError();
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     ArrayDataSource *source = getArrayDataSource( session, objectHandle );
     if( source == NULL )
@@ -3889,20 +5029,75 @@ FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlO
         }
     }
     
-    source->rawSizes.clear();
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->rawSizes.assign( sizes, sizes + source->rank );
+    
+    return FML_ERR_NO_ERROR;
+}
+
+
+FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *sizes )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
     for( int i = 0; i < source->rank; i++ )
     {
-        source->rawSizes.push_back( sizes[i] );
+        if( sizes[i] <= 0 )
+        {
+            return session->setError( FML_ERR_INVALID_PARAMETER_3, "Cannot set array data raw size. Invalid size." );
+        }
     }
     
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->rawSizes.assign( sizes, sizes + source->rank );
+    
     return FML_ERR_NO_ERROR;
 }
 
 
 FmlErrorNumber Fieldml_GetArrayDataSourceOffsets( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *offsets )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
+    return narrowArrayValues( session, objectHandle, source->offsets, offsets );
+}
+
+
+FmlErrorNumber Fieldml_GetArrayDataSourceOffsets64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *offsets )
+{
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -3926,13 +5121,18 @@ FmlErrorNumber Fieldml_GetArrayDataSourceOffsets( FmlSessionHandle handle, FmlOb
 
 FmlErrorNumber Fieldml_SetArrayDataSourceOffsets( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *offsets )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return session->getLastError();
     }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
 
     ArrayDataSource *source = getArrayDataSource( session, objectHandle );
     if( source == NULL )
@@ -3948,25 +5148,63 @@ FmlErrorNumber Fieldml_SetArrayDataSourceOffsets( FmlSessionHandle handle, FmlOb
         }
     }
     
-    source->offsets.clear();
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->offsets.assign( offsets, offsets + source->rank );
+    
+    return FML_ERR_NO_ERROR;
+}
+
+
+FmlErrorNumber Fieldml_SetArrayDataSourceOffsets64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *offsets )
+{
+    SessionReference session( handle );
+    ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
+
+    if( session == NULL )
+    {
+        return session->getLastError();
+    }
+    if( !checkMutable( session ) )
+    {
+        return session->getLastError();
+    }
+
+    ArrayDataSource *source = getArrayDataSource( session, objectHandle );
+    if( source == NULL )
+    {
+        return session->getLastError();
+    }
+
     for( int i = 0; i < source->rank; i++ )
     {
-        source->offsets.push_back( offsets[i] );
+        if( offsets[i] < 0 )
+        {
+            return session->setError( FML_ERR_INVALID_PARAMETER_3, "Cannot set array data offset. Invalid offset." );
+        }
     }
     
+    source = (ArrayDataSource*)getWritableObject( session, objectHandle );
+    source->offsets.assign( offsets, offsets + source->rank );
+    
     return FML_ERR_NO_ERROR;
 }
 
 
 FmlObjectHandle Fieldml_CreateArrayDataSource( FmlSessionHandle handle, const char * name, FmlObjectHandle resourceHandle, const char * location, int rank )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_ERR_UNKNOWN_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create array data source. Invalid name." );
@@ -3998,9 +5236,9 @@ FmlObjectHandle Fieldml_CreateArrayDataSource( FmlSessionHandle handle, const ch
         return session->setError( FML_ERR_INVALID_OBJECT, resourceHandle, "Cannot create array data source. Must be a data resource." );
     }
     
-    DataResource *dataResource = getDataResource( session, resourceHandle );
+    DataResource *dataResource = (DataResource*)getWritableObject( session, resourceHandle );
 
-    ArrayDataSource *source = new ArrayDataSource( name, dataResource, location, rank );
+    ArrayDataSource *source = new( session->objects.getArena() ) ArrayDataSource( session->objects.internName( name ), dataResource, location, rank );
 
     session->setError( FML_ERR_NO_ERROR, "" );
     FmlObjectHandle sourceHandle = addObject( session, source );
@@ -4013,13 +5251,18 @@ FmlObjectHandle Fieldml_CreateArrayDataSource( FmlSessionHandle handle, const ch
 
 int Fieldml_CreateConstantEvaluator( FmlSessionHandle handle, const char * name, const char * literal, FmlObjectHandle valueType )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_WRITE_LOCK( session );
 
     if( session == NULL )
     {
         return FML_INVALID_HANDLE;
     }
+    if( !checkMutable( session ) )
+    {
+        return FML_INVALID_HANDLE;
+    }
     if( name == NULL )
     {
         session->setError( FML_ERR_INVALID_PARAMETER_2, "Cannot create constant evaluator. Invalid name." );
@@ -4042,17 +5285,18 @@ int Fieldml_CreateConstantEvaluator( FmlSessionHandle handle, const char * name,
         return FML_INVALID_HANDLE;
     }
 
-    ConstantEvaluator *evaluator = new ConstantEvaluator( name, literal, valueType );
+    ConstantEvaluator *evaluator = new( session->objects.getArena() ) ConstantEvaluator( session->objects.internName( name ), literal, valueType );
     
     session->setError( FML_ERR_NO_ERROR, "" );
     return addObject( session, evaluator );
 }
 
 
-char * Fieldml_GetConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+const char * Fieldml_PeekConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle )
 {
-    FieldmlSession *session = FieldmlSession::handleToSession( handle );
+    SessionReference session( handle );
     ERROR_AUTOSTACK( session );
+    SESSION_READ_LOCK( session );
 
     if( session == NULL )
     {
@@ -4062,7 +5306,7 @@ char * Fieldml_GetConstantEvaluatorValueString( FmlSessionHandle handle, FmlObje
     ConstantEvaluator *evaluator = ConstantEvaluator::checkedCast( session, objectHandle );
     if( evaluator != NULL )
     {
-        return cstrCopy( evaluator->valueString );
+        return evaluator->valueString.c_str();
     }
 
     session->setError( FML_ERR_INVALID_OBJECT, objectHandle, "Cannot get constant evaluator value. Invalid object." );
@@ -4070,7 +5314,20 @@ char * Fieldml_GetConstantEvaluatorValueString( FmlSessionHandle handle, FmlObje
 }
 
 
+char * Fieldml_GetConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle )
+{
+    //NOTE: The lock is held until the borrowed string has been copied.
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return strdupS( Fieldml_PeekConstantEvaluatorValueString( handle, objectHandle ) );
+}
+
+
 int Fieldml_CopyConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength )
 {
-    return cappedCopyAndFree( Fieldml_GetConstantEvaluatorValueString( handle, objectHandle ), buffer, bufferLength );
+    SessionReference session( handle );
+    SESSION_READ_LOCK( session );
+    
+    return cappedCopy( Fieldml_PeekConstantEvaluatorValueString( handle, objectHandle ), buffer, bufferLength );
 }
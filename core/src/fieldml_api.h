@@ -61,6 +61,11 @@
  * 
  * All object names must be unique within their region.
  * 
+ * Sessions may be created, queried and destroyed from multiple threads. Any number of threads
+ * may query a session at once, but calls that modify a session are serialized. Error numbers
+ * are tracked separately for each thread. A session must not be destroyed while other threads
+ * are still using it.
+ * 
  * \note String getters are being considered for deprecation.
  */
 
@@ -117,6 +122,7 @@ typedef int32_t FmlEnsembleValue;               ///< An integer-valued ensemble
 #define FML_ERR_CYCLIC_DEPENDENCY       1008    ///< An attempt was made to create a cyclic dependency.
 #define FML_ERR_INVALID_INDEX           1009    ///< An attempt was made to use an out-of-bounds index.
 #define FML_ERR_READ_ERR                1010    ///< A read error was encountered during IO.
+#define FML_ERR_WRITE_ERR               1011    ///< A write error was encountered during IO.
 
 //Used for giving the user precise feedback on bad parameters passed to the API
 //Only used for parameters other than the FieldML handle and object handle parameters.
@@ -246,6 +252,37 @@ enum FieldmlHandleType
 };
 
 
+/**
+ * Describes the categories of memory held by a session.
+ * 
+ * \see Fieldml_GetMemoryUsage
+ */
+enum FieldmlMemoryCategory
+{
+    FML_MEMORY_TOTAL,         ///< The sum of all the other categories.
+    FML_MEMORY_OBJECTS,       ///< The objects themselves, and the lists of objects held by the session's regions.
+    FML_MEMORY_NAMES,         ///< The session's interned object names.
+    FML_MEMORY_MAPS,          ///< Bind maps, evaluator maps, argument sets and index lists held by objects.
+    FML_MEMORY_BITSETS,       ///< Bitsets held by objects.
+    FML_MEMORY_INLINE_DATA,   ///< The contents of inline data resources.
+    FML_MEMORY_CACHES,        ///< Cached dependency and argument information, and decoded ensemble members.
+};
+
+
+/**
+ * Describes how thoroughly FieldML documents are checked when they are read.
+ * 
+ * \see Fieldml_CreateFromFileWithValidation
+ * \see Fieldml_SetValidationLevel
+ */
+enum FieldmlValidationLevel
+{
+    FML_VALIDATION_UNKNOWN,     ///< The validation level is not known.
+    FML_VALIDATION_SCHEMA,      ///< Documents are validated against the FieldML XML schema before any objects are created. This is the default.
+    FML_VALIDATION_STRUCTURAL   ///< Only the rules the parser relies on (required attributes and elements, element nesting and resolvable object references) are checked, as objects are created.
+};
+
+
 /*
 
  API
@@ -274,6 +311,60 @@ extern "C" {
 FmlSessionHandle Fieldml_CreateFromFile( const char * filename );
 
 
+/**
+ * Creates a FieldML session in the same way as Fieldml_CreateFromFile, checking the file and its imports to the given
+ * level. Structural validation avoids the cost of schema validation, which dominates the loading of documents with
+ * large inline data, but does not check attribute value formats or other rules the parser does not rely on.
+ * 
+ * \see Fieldml_CreateFromFile
+ * \see Fieldml_SetValidationLevel
+ */
+FmlSessionHandle Fieldml_CreateFromFileWithValidation( const char * filename, FieldmlValidationLevel level );
+
+
+/**
+ * Creates a FieldML session in the same way as Fieldml_CreateFromFileWithValidation, but reads the file as a stream
+ * rather than building a tree for the whole document first. Inline data is collected as plain text rather than
+ * into a tree, so peak memory stays close to the size of the inline data rather than growing with the size of the
+ * document's tree. This is intended for very large documents.
+ * 
+ * \note Data resources are created before the other objects in the document, so object handles may be ordered
+ * differently than with Fieldml_CreateFromFile. Imported documents are read in the usual way.
+ * 
+ * \note Nothing from the document is added to the session until the whole document has been read and found to be
+ * well-formed and valid, so a validation error leaves the session's region empty. Errors found after that, while
+ * the objects are being created, leave the region partially read, as with Fieldml_CreateFromFile.
+ * 
+ * \see Fieldml_CreateFromFileWithValidation
+ */
+FmlSessionHandle Fieldml_CreateFromFileStreaming( const char * filename, FieldmlValidationLevel level );
+
+
+/**
+ * Creates a FieldML session in the same way as Fieldml_CreateFromFileWithValidation, but with lazy imports enabled
+ * before the file is read, so that only the objects it actually imports are created.
+ * 
+ * \see Fieldml_SetLazyImports
+ */
+FmlSessionHandle Fieldml_CreateFromFileWithLazyImports( const char * filename, FieldmlValidationLevel level );
+
+
+/**
+ * Creates a FieldML session from a binary file written by Fieldml_WriteBinary. No parsing or validation is needed,
+ * and the file is memory-mapped where possible, so this is much faster than reading the original document. The new
+ * session has the same objects, with the same handles, as the session that was written.
+ * 
+ * \note Binary files are only readable by builds with the same byte order and binary format version
+ * (FML_BINARY_VERSION) as the build that wrote them. Incompatible files are rejected with FML_ERR_READ_ERR.
+ * 
+ * \note Region roots are kept as they were when the file was written, so relative data resource hrefs are still
+ * resolved against the original document's directory.
+ * 
+ * \see Fieldml_WriteBinary
+ */
+FmlSessionHandle Fieldml_CreateFromBinary( const char * filename );
+
+
 /**
  * Creates an empty FieldML handle.
  * 
@@ -290,12 +381,37 @@ FmlSessionHandle Fieldml_Create( const char * location, const char * name );
  * Sets/clears the debug flag. If non-zero, error encoutered by API calls are logged to stdout.
  * 
  * \note This does not include errors encountered when parsing a FieldML file.
+ * 
+ * \note As frozen sessions are not locked, the flag cannot be changed once a session is frozen.
  */
 FmlErrorNumber Fieldml_SetDebug( FmlSessionHandle handle, int debug );
 
 
 /**
- * \return The error code generated by the last API call.
+ * Sets the level to which documents subsequently imported into the given session are checked.
+ * 
+ * \see Fieldml_CreateFromFileWithValidation
+ */
+FmlErrorNumber Fieldml_SetValidationLevel( FmlSessionHandle handle, FieldmlValidationLevel level );
+
+
+/**
+ * Sets whether documents subsequently imported into the given session are read lazily. A lazily imported document
+ * is read and checked in full, and its own imports are processed, but its other objects are only indexed by name.
+ * An object is created when it is first imported, along with the objects it refers to, so importing a few objects
+ * from a large document only creates those objects.
+ * 
+ * \note Objects that have not been imported do not exist in the session, so they are not counted or returned by
+ * any other API call. Once the session is frozen, no further objects are created.
+ * 
+ * \see Fieldml_CreateFromFileWithLazyImports
+ * \see Fieldml_AddImport
+ */
+FmlErrorNumber Fieldml_SetLazyImports( FmlSessionHandle handle, FmlBoolean lazy );
+
+
+/**
+ * \return The error code generated by the last API call made on the given session by the calling thread.
  * 
  * \see FML_ERR_NO_ERROR
  */
@@ -314,6 +430,20 @@ FmlErrorNumber Fieldml_GetLastError( FmlSessionHandle handle );
 FmlErrorNumber Fieldml_WriteFile( FmlSessionHandle handle, const char * filename );
 
 
+/**
+ * Writes the fully resolved contents of the given FieldML handle, including its imports and inline data, to the given
+ * filename in a binary format that can be reloaded with Fieldml_CreateFromBinary. This is intended for documents that
+ * are read repeatedly without changing.
+ * 
+ * \note Objects in lazily imported documents that have not yet been imported are not written.
+ * 
+ * \note Element sequences cannot be written, and cause FML_ERR_WRITE_ERR.
+ * 
+ * \see Fieldml_CreateFromBinary
+ */
+FmlErrorNumber Fieldml_WriteBinary( FmlSessionHandle handle, const char * filename );
+
+
 /**
  * Frees all resources associated with the given handle. The handle will
  * become invalid after this call.
@@ -324,6 +454,51 @@ FmlErrorNumber Fieldml_WriteFile( FmlSessionHandle handle, const char * filename
 void Fieldml_Destroy( FmlSessionHandle handle );
 
 
+/**
+ * Validates the session's objects and, if they are all complete, makes the session read-only. All
+ * dependency information is precomputed, so a frozen session can be queried from any number of
+ * threads without locking. Attempts to modify a frozen session fail with FML_ERR_ACCESS_VIOLATION.
+ * Freezing an already-frozen session has no effect.
+ * 
+ * \note A session should be frozen before it is shared with other threads.
+ * 
+ * \see Fieldml_GetLastError
+ */
+FmlErrorNumber Fieldml_FreezeSession( FmlSessionHandle handle );
+
+
+/**
+ * Creates a new, modifiable session with the same contents as the given session. The given session
+ * is frozen first if necessary, and its objects are then shared with the new session rather than
+ * copied. An object is only copied into the new session when it is first modified there, so the
+ * given session never changes. Object handles are the same in both sessions.
+ * 
+ * The new session must be destroyed separately. The given session may be destroyed at any time.
+ * 
+ * \return The handle of the new session, or FML_INVALID_HANDLE if the given session could not be frozen.
+ * 
+ * \see Fieldml_FreezeSession
+ * \see Fieldml_Destroy
+ */
+FmlSessionHandle Fieldml_CloneSession( FmlSessionHandle handle );
+
+
+/**
+ * Reports the number of bytes of memory held by the given session in the given category. The
+ * figures are kept up to date as the session is modified, so this call is cheap enough to be
+ * polled. Container sizes are measured by capacity, and set nodes are estimated, so the figures
+ * are approximate.
+ * 
+ * \note A cloned session only reports the memory it holds itself. Objects shared with the session
+ * it was cloned from are reported by that session.
+ * 
+ * \return The number of bytes held, or -1 on error.
+ * 
+ * \see Fieldml_CloneSession
+ */
+int64_t Fieldml_GetMemoryUsage( FmlSessionHandle handle, FieldmlMemoryCategory category );
+
+
 /**
  * Frees any string returned by a char* valued Fieldml_Get* function.
  * 
@@ -337,7 +512,8 @@ FmlErrorNumber Fieldml_FreeString( char * string );
  * 
  * \warning All char* valued Fieldm_Get API calls return a newly-allocated buffer
  * containing the string. This must be freed either by the caller (via the C standard library's free() call),
- * or by passing the value to Fieldml_FreeString()
+ * or by passing the value to Fieldml_FreeString(). The corresponding Fieldml_Peek calls avoid the allocation
+ * by returning a string owned by the session.
  * 
  * \see Fieldml_FreeString
  */
@@ -357,6 +533,15 @@ char * Fieldml_GetRegionName( FmlSessionHandle handle );
 int Fieldml_CopyRegionName( FmlSessionHandle handle, char * buffer, int bufferLength );
 
 
+/**
+ * As Fieldml_GetRegionName, but returns the session's own copy of the region name rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetRegionName
+ */
+const char * Fieldml_PeekRegionName( FmlSessionHandle handle );
+
+
 /**
  * \return The root path of the current region.
  * 
@@ -377,6 +562,15 @@ char * Fieldml_GetRegionRoot( FmlSessionHandle handle );
  */
 int Fieldml_CopyRegionRoot( FmlSessionHandle handle, char * buffer, int bufferLength );
 
+
+/**
+ * As Fieldml_GetRegionRoot, but returns the session's own copy of the region root rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed or written to a file, as writing changes the region root.
+ * 
+ * \see Fieldml_GetRegionRoot
+ */
+const char * Fieldml_PeekRegionRoot( FmlSessionHandle handle );
+
 /**
  * \return The number of parsing errors encountered by the given handle during FieldML file parsing.
  */
@@ -408,6 +602,8 @@ int Fieldml_CopyError( FmlSessionHandle handle, int errorIndex, char * buffer, i
 /**
  * Clears the given session's parsing errors and error number.
  * 
+ * \note As frozen sessions are not locked, their errors cannot be cleared.
+ * 
  * \see Fieldml_GetErrorCount
  * \see Fieldml_GetError
  * \see Fieldml_CopyRegionName
@@ -499,6 +695,15 @@ char * Fieldml_GetObjectName( FmlSessionHandle handle, FmlObjectHandle objectHan
 int Fieldml_CopyObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
 
+/**
+ * As Fieldml_GetObjectName, but returns the session's own copy of the name rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetObjectName
+ */
+const char * Fieldml_PeekObjectName( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
+
 /**
  * \return The given object's declared name. This is the name the object was given in the
  * region in which is was declared, and may differ from the the object's local name.
@@ -519,6 +724,15 @@ char * Fieldml_GetObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle o
 int Fieldml_CopyObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
 
+/**
+ * As Fieldml_GetObjectDeclaredName, but returns the session's own copy of the name rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetObjectDeclaredName
+ */
+const char * Fieldml_PeekObjectDeclaredName( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
+
 /**
  * Associate a client-defined integer with the given object. This value is initialized to 0 when
  * the object is created, but is otherwise ignored by the API.
@@ -921,6 +1135,18 @@ FmlObjectHandle Fieldml_GetDefaultEvaluator( FmlSessionHandle handle, FmlObjectH
 FmlErrorNumber Fieldml_SetEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue element, FmlObjectHandle evaluator );
 
 
+/**
+ * Sets a number of index value to evaluator pairings for the given aggregate or piecewise evaluator in one call.
+ * This is equivalent to calling Fieldml_SetEvaluator for each element/evaluator pair in turn, but each distinct
+ * evaluator is only checked once, and the evaluator map is only re-ordered once. If the same element is given more
+ * than once, the last pairing is used. If any evaluator is invalid, no pairings are set.
+ * 
+ * \see Fieldml_SetEvaluator
+ * \see Fieldml_GetEvaluatorCount
+ */
+FmlErrorNumber Fieldml_SetEvaluators( FmlSessionHandle handle, FmlObjectHandle objectHandle, int count, const FmlEnsembleValue *elements, const FmlObjectHandle *evaluators );
+
+
 /**
  * \return The number of explicit index-value to evaluator pairings for the given
  * piecewise or aggregate evaluator.
@@ -955,6 +1181,19 @@ FmlEnsembleValue Fieldml_GetEvaluatorElement( FmlSessionHandle handle, FmlObject
 FmlObjectHandle Fieldml_GetEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int evaluatorIndex );
 
 
+/**
+ * Copies the index-value to evaluator pairings of the given piecewise or aggregate evaluator into the given arrays, in
+ * the same order as Fieldml_GetEvaluatorElement and Fieldml_GetEvaluator. At most capacity pairings are copied. Either
+ * array may be NULL, in which case that half of each pairing is not copied.
+ * 
+ * \return The total number of pairings, which may be greater than capacity, or -1 on error.
+ * 
+ * \see Fieldml_GetEvaluatorCount
+ * \see Fieldml_SetEvaluators
+ */
+int Fieldml_GetEvaluators( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue *elements, FmlObjectHandle *evaluators, int capacity );
+
+
 /**
  * \return The evaluator for the given index value in the given piecewise or aggregate
  * evaluator, or FML_INVALID_HANDLE if there is none defined.
@@ -1033,6 +1272,17 @@ int Fieldml_GetArgumentCount( FmlSessionHandle handle, FmlObjectHandle objectHan
 FmlObjectHandle Fieldml_GetArgument( FmlSessionHandle handle, FmlObjectHandle objectHandle, int argumentIndex, FmlBoolean isBound, FmlBoolean isUsed );
 
 
+/**
+ * Copies the argument evaluators used by the given evaluator, subject to the given qualifiers, into the given array, in
+ * the same order as Fieldml_GetArgument. At most capacity arguments are copied. The array may be NULL.
+ * 
+ * \return The total number of arguments, which may be greater than capacity, or -1 on error.
+ * 
+ * \see Fieldml_GetArgumentCount
+ */
+int Fieldml_GetArguments( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlBoolean isBound, FmlBoolean isUsed, FmlObjectHandle *arguments, int capacity );
+
+
 /**
  * Binds the given argument evaluator to the given source within the scope of the given evaluator.
  * A bound argument can be re-bound, but the overriding bind's scope remains that of the enclosing evaluator.
@@ -1072,6 +1322,19 @@ FmlObjectHandle Fieldml_GetBindArgument( FmlSessionHandle handle, FmlObjectHandl
 FmlObjectHandle Fieldml_GetBindEvaluator( FmlSessionHandle handle, FmlObjectHandle objectHandle, int bindIndex );
 
 
+/**
+ * Copies the binds of the given evaluator into the given arrays, in the same order as Fieldml_GetBindArgument and
+ * Fieldml_GetBindEvaluator. At most capacity binds are copied. Either array may be NULL, in which case that half of
+ * each bind is not copied.
+ * 
+ * \return The total number of binds, which may be greater than capacity, or -1 on error.
+ * 
+ * \see Fieldml_GetBindCount
+ * \see Fieldml_SetBind
+ */
+int Fieldml_GetBinds( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle *arguments, FmlObjectHandle *sources, int capacity );
+
+
 /**
  * \return The argument evaluator to which to given evaluator is bound to in the given evaluator.
  * 
@@ -1120,6 +1383,42 @@ FmlErrorNumber Fieldml_SetEnsembleMembersRange( FmlSessionHandle handle, FmlObje
 int Fieldml_GetMemberCount( FmlSessionHandle handle, FmlObjectHandle objectHandle );
 
 
+/**
+ * \return The member at the given position (starting at 1) in the given ensemble or mesh type, or -1 on error.
+ * 
+ * \see Fieldml_GetEnsembleMembers
+ * \see Fieldml_GetMemberCount
+ */
+FmlEnsembleValue Fieldml_GetEnsembleMember( FmlSessionHandle handle, FmlObjectHandle objectHandle, int memberIndex );
+
+
+/**
+ * Copies at most capacity members of the given ensemble or mesh type into the given buffer, in order, starting with the
+ * member at the given position (starting at 1). Members defined via a data source are decoded on first use and cached as
+ * runs of evenly spaced values, so an ensemble can be iterated over a buffer at a time without re-reading its data.
+ * 
+ * \note Only member data held in plain-text data resources can be decoded.
+ * 
+ * \return The number of members copied, which is zero once firstMemberIndex is past the last member, or -1 on error.
+ * 
+ * \see Fieldml_GetEnsembleMember
+ * \see Fieldml_GetMemberCount
+ */
+int Fieldml_GetEnsembleMembers( FmlSessionHandle handle, FmlObjectHandle objectHandle, int firstMemberIndex, FmlEnsembleValue *members, int capacity );
+
+
+/**
+ * Maps a member of the given ensemble or mesh type to its position, e.g. to find the row of parameter data for a given
+ * element number. The first lookup builds a cached index for the ensemble (a direct table when its members are dense, a
+ * hash table otherwise), after which lookups take constant time.
+ * 
+ * \return The position (starting at 1) of the given member, 0 if it is not a member, or -1 on error.
+ * 
+ * \see Fieldml_GetEnsembleMember
+ */
+int Fieldml_GetEnsembleMemberIndex( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlEnsembleValue member );
+
+
 /**
  * \return The minimum ensemble member used when directly declaring ensemble members.
  * 
@@ -1343,6 +1642,15 @@ char * Fieldml_GetArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHan
 int Fieldml_CopyArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
 
+/**
+ * As Fieldml_GetArrayDataSourceLocation, but returns the session's own copy of the location rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetArrayDataSourceLocation
+ */
+const char * Fieldml_PeekArrayDataSourceLocation( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
+
 /**
  * \return The array rank for the given array data source.
  * 
@@ -1362,6 +1670,16 @@ int Fieldml_GetArrayDataSourceRank( FmlSessionHandle handle, FmlObjectHandle obj
 FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes );
 
 
+/**
+ * 64-bit variant of Fieldml_GetArrayDataSourceRawSizes. The 32-bit variant fails with FML_ERR_UNSUPPORTED if
+ * a raw size does not fit into an int.
+ * 
+ * \see Fieldml_GetArrayDataSourceRawSizes
+ * \see Fieldml_SetArrayDataSourceRawSizes64
+ */
+FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *sizes );
+
+
 /**
  * Set the raw size of the given array data source. This is optional for self-describing data-resource, but must be set
  * plain-text data resources. The sizes argument must contain a number of values equal to the data source's rank.
@@ -1371,6 +1689,15 @@ FmlErrorNumber Fieldml_GetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlO
  */
 FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes );
 
+
+/**
+ * 64-bit variant of Fieldml_SetArrayDataSourceRawSizes.
+ * 
+ * \see Fieldml_SetArrayDataSourceRawSizes
+ * \see Fieldml_GetArrayDataSourceRawSizes64
+ */
+FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *sizes );
+
 /**
  * Get the offsets of the array data accessible via the given data source.
  * The offsets argument must contain a number of values equal to the data source's rank.
@@ -1381,6 +1708,16 @@ FmlErrorNumber Fieldml_SetArrayDataSourceRawSizes( FmlSessionHandle handle, FmlO
 FmlErrorNumber Fieldml_GetArrayDataSourceOffsets( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *offsets );
 
 
+/**
+ * 64-bit variant of Fieldml_GetArrayDataSourceOffsets. The 32-bit variant fails with FML_ERR_UNSUPPORTED if
+ * an offset does not fit into an int.
+ * 
+ * \see Fieldml_GetArrayDataSourceOffsets
+ * \see Fieldml_SetArrayDataSourceOffsets64
+ */
+FmlErrorNumber Fieldml_GetArrayDataSourceOffsets64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *offsets );
+
+
 /**
  * Sets the offsets of the array data accessible via the given data source. These are offsets into the containing
  * array exposed via the data source's associated resource. Offsets are initialised to zero.
@@ -1392,6 +1729,15 @@ FmlErrorNumber Fieldml_GetArrayDataSourceOffsets( FmlSessionHandle handle, FmlOb
 FmlErrorNumber Fieldml_SetArrayDataSourceOffsets( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *offsets );
 
 
+/**
+ * 64-bit variant of Fieldml_SetArrayDataSourceOffsets.
+ * 
+ * \see Fieldml_SetArrayDataSourceOffsets
+ * \see Fieldml_GetArrayDataSourceOffsets64
+ */
+FmlErrorNumber Fieldml_SetArrayDataSourceOffsets64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *offsets );
+
+
 /**
  * Get the sizes of the array data accessible via the given data source. Offsets are initialised to zero. Values
  * of zero will be interpreted as the maximum possible size given the arrays raw size, and the data sources own 
@@ -1402,6 +1748,16 @@ FmlErrorNumber Fieldml_SetArrayDataSourceOffsets( FmlSessionHandle handle, FmlOb
 FmlErrorNumber Fieldml_GetArrayDataSourceSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes );
 
 
+/**
+ * 64-bit variant of Fieldml_GetArrayDataSourceSizes. The 32-bit variant fails with FML_ERR_UNSUPPORTED if
+ * a size does not fit into an int.
+ * 
+ * \see Fieldml_GetArrayDataSourceSizes
+ * \see Fieldml_SetArrayDataSourceSizes64
+ */
+FmlErrorNumber Fieldml_GetArrayDataSourceSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, int64_t *sizes );
+
+
 /**
  * Sets the sizes of the array data accessible via the given data source. Values
  * of zero will be interpreted as the maximum possible size given the arrays raw size, and the data sources own 
@@ -1412,6 +1768,15 @@ FmlErrorNumber Fieldml_GetArrayDataSourceSizes( FmlSessionHandle handle, FmlObje
 FmlErrorNumber Fieldml_SetArrayDataSourceSizes( FmlSessionHandle handle, FmlObjectHandle objectHandle, int *sizes );
 
 
+/**
+ * 64-bit variant of Fieldml_SetArrayDataSourceSizes.
+ * 
+ * \see Fieldml_SetArrayDataSourceSizes
+ * \see Fieldml_GetArrayDataSourceSizes64
+ */
+FmlErrorNumber Fieldml_SetArrayDataSourceSizes64( FmlSessionHandle handle, FmlObjectHandle objectHandle, const int64_t *sizes );
+
+
 /**
  * \return The data source type of the given data source.
  * 
@@ -1422,9 +1787,11 @@ FieldmlDataSourceType Fieldml_GetDataSourceType( FmlSessionHandle handle, FmlObj
 
 /**
  * Appends the given string to the given data resource's inline data. The data resource's type must be
- * FieldmlDataResourceType::FML_DATA_RESOURCE_INLINE.
+ * FieldmlDataResourceType::FML_DATA_RESOURCE_INLINE. The data is appended in place, so large data can be
+ * added in many small chunks, and read back without copying via Fieldml_PeekInlineData.
  * 
  * \see Fieldml_CreateInlineDataResource
+ * \see Fieldml_PeekInlineData
  */
 FmlErrorNumber Fieldml_AddInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle, const char * data, const int length );
 
@@ -1468,6 +1835,15 @@ char * Fieldml_GetInlineData( FmlSessionHandle handle, FmlObjectHandle objectHan
  */
 int Fieldml_CopyInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength, int offset );
 
+
+/**
+ * As Fieldml_GetInlineData, but returns the session's own copy of the data rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the resource's data is next modified, or the session is destroyed. Its length is given by Fieldml_GetInlineDataLength.
+ * 
+ * \see Fieldml_GetInlineData
+ */
+const char * Fieldml_PeekInlineData( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
 /**
  * \return The href of the data resource's file. The data resource's type must be FieldmlDataResourceType::FML_DATA_RESOURCE_HREF.
 
@@ -1486,6 +1862,15 @@ char * Fieldml_GetDataResourceHref( FmlSessionHandle handle, FmlObjectHandle obj
  */
 int Fieldml_CopyDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
+
+/**
+ * As Fieldml_GetDataResourceHref, but returns the session's own copy of the href rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetDataResourceHref
+ */
+const char * Fieldml_PeekDataResourceHref( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
 /**
  * \return The data format of the given data resource's format into the given buffer. The data resource's type must be FieldmlDataResourceType::FML_DATA_RESOURCE_ARRAY.
  * 
@@ -1502,6 +1887,15 @@ char * Fieldml_GetDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle o
 int Fieldml_CopyDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
 
+/**
+ * As Fieldml_GetDataResourceFormat, but returns the session's own copy of the format rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetDataResourceFormat
+ */
+const char * Fieldml_PeekDataResourceFormat( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
+
 /**
  * Creates a new constant evaluator whose value is determined by the given literal.
  * 
@@ -1526,6 +1920,15 @@ char * Fieldml_GetConstantEvaluatorValueString( FmlSessionHandle handle, FmlObje
  */
 int Fieldml_CopyConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle, char * buffer, int bufferLength );
 
+
+/**
+ * As Fieldml_GetConstantEvaluatorValueString, but returns the session's own copy of the value string rather than allocating a new one. The
+ * returned string must not be modified or freed. It remains valid until the session is destroyed.
+ * 
+ * \see Fieldml_GetConstantEvaluatorValueString
+ */
+const char * Fieldml_PeekConstantEvaluatorValueString( FmlSessionHandle handle, FmlObjectHandle objectHandle );
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,1287 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined WIN32
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Evaluators.h"
+#include "fieldml_structs.h"
+#include "fieldml_binary.h"
+
+using namespace std;
+
+//A binary session file is a header, followed by arrays of fixed-size region, import source, import and object
+//records, then a pool of 64-bit values and a pool of characters. Records refer to values and strings by their offset
+//in the pools rather than by address, so the file can be used straight from a read-only mapping. Every record is a
+//multiple of eight bytes long, so the value pool is aligned. Integers are stored in the writer's byte order.
+
+static const char BINARY_MAGIC[8] = { 'F', 'M', 'L', 'B', 'I', 'N', '\r', '\n' };
+
+static const int32_t BINARY_BYTE_ORDER = 0x01020304;
+
+enum BinaryObjectFlags
+{
+    BINARY_VIRTUAL = 1,
+    BINARY_COMPONENT_ENSEMBLE = 2,
+    BINARY_DEFAULT_EVALUATOR = 4
+};
+
+
+struct BinaryString
+{
+    int64_t offset;
+    int64_t length;
+};
+
+
+struct BinaryHeader
+{
+    char magic[8];
+    int32_t version;
+    int32_t byteOrder;
+    int32_t regionCount;
+    int32_t currentRegion;
+    int32_t importSourceCount;
+    int32_t importCount;
+    int32_t objectCount;
+    int32_t reserved;
+    int64_t valueCount;
+    int64_t stringLength;
+};
+
+
+struct BinaryRegion
+{
+    BinaryString href;
+    BinaryString name;
+    BinaryString root;
+};
+
+
+struct BinaryImportSource
+{
+    int32_t region;
+    int32_t sourceRegion;
+    BinaryString href;
+    BinaryString name;
+};
+
+
+struct BinaryImport
+{
+    int32_t region;
+    int32_t sourceRegion;
+    int32_t object;
+    int32_t reserved;
+    BinaryString localName;
+    BinaryString remoteName;
+};
+
+
+/**
+ * A single object, stored at the index of its handle. The meaning of the subtype, references, numbers and value
+ * lists depends on the object's type:
+ * 
+ * EnsembleType: subtype is the members type, references[0] the members data source, numbers the minimum, maximum,
+ * stride and count.
+ * ContinuousType: references[0] is the component ensemble.
+ * MeshType: references are the chart type, elements type and shapes evaluator.
+ * DataResource: subtype is the resource type, text the inline data or href, format the format. values[0] lists the
+ * data sources.
+ * DataSource: subtype is the source type, references[0] the resource, text the location, numbers[0] the rank.
+ * values[0], values[1] and values[2] are the offsets, sizes and raw sizes.
+ * 
+ * For all evaluators, references[0] is the value type.
+ * ConstantEvaluator: text is the value string.
+ * ReferenceEvaluator: references[1] is the source evaluator. values[0] holds argument/source bind pairs.
+ * PiecewiseEvaluator, AggregateEvaluator: references[1] is the index evaluator, references[2] the default evaluator.
+ * values[0] holds argument/source bind pairs, values[1] element/evaluator pairs.
+ * ArgumentEvaluator, ExternalEvaluator: values[0] lists the arguments.
+ * ParameterEvaluator: subtype is the data description type, references[1] the (value) data source, references[2] the
+ * key data source. values[0], values[1] and values[2] are the sparse indexes, dense indexes and dense index orders.
+ */
+struct BinaryObject
+{
+    int32_t objectType;
+    int32_t region;
+    int32_t flags;
+    int32_t intValue;
+    int32_t subtype;
+    int32_t references[3];
+    BinaryString name;
+    BinaryString text;
+    BinaryString format;
+    int64_t numbers[4];
+    
+    //NOTE: The value lists are stored consecutively, starting at valueOffset.
+    int64_t valueOffset;
+    int64_t valueCounts[3];
+};
+
+//========================================================================
+//
+// Writing
+//
+//========================================================================
+
+struct BinaryContents
+{
+    vector<BinaryRegion> regions;
+    vector<BinaryImportSource> importSources;
+    vector<BinaryImport> imports;
+    vector<BinaryObject> objects;
+    vector<int64_t> values;
+    string strings;
+};
+
+
+static BinaryString addString( BinaryContents &contents, const string &value )
+{
+    BinaryString binaryString;
+    
+    binaryString.offset = contents.strings.length();
+    binaryString.length = value.length();
+    contents.strings.append( value );
+    
+    return binaryString;
+}
+
+
+//NOTE: Each object's value lists must be added in order, as they are stored consecutively.
+static void addValue( BinaryContents &contents, BinaryObject &record, int list, int64_t value )
+{
+    contents.values.push_back( value );
+    record.valueCounts[list]++;
+}
+
+
+template<typename C> static void addValues( BinaryContents &contents, BinaryObject &record, int list, const C &values )
+{
+    for( typename C::const_iterator i = values.begin(); i != values.end(); i++ )
+    {
+        addValue( contents, record, list, *i );
+    }
+}
+
+
+template<typename K> static void addPairs( BinaryContents &contents, BinaryObject &record, int list, const SimpleMap<K, FmlObjectHandle> &map )
+{
+    for( typename SimpleMap<K, FmlObjectHandle>::ConstIterator i = map.begin(); i != map.end(); i++ )
+    {
+        addValue( contents, record, list, i->first );
+        addValue( contents, record, list, i->second );
+    }
+}
+
+
+static int writeEnsembleType( BinaryContents & /*contents*/, EnsembleType *ensembleType, BinaryObject &record )
+{
+    if( ensembleType->isComponentEnsemble )
+    {
+        record.flags |= BINARY_COMPONENT_ENSEMBLE;
+    }
+    record.subtype = ensembleType->membersType;
+    record.references[0] = ensembleType->dataSource;
+    record.numbers[0] = ensembleType->min;
+    record.numbers[1] = ensembleType->max;
+    record.numbers[2] = ensembleType->stride;
+    record.numbers[3] = ensembleType->count;
+    
+    return 0;
+}
+
+
+static int writeMeshType( BinaryContents & /*contents*/, MeshType *meshType, BinaryObject &record )
+{
+    record.references[0] = meshType->chartType;
+    record.references[1] = meshType->elementsType;
+    record.references[2] = meshType->shapes;
+    
+    return 0;
+}
+
+
+static int writeDataResource( BinaryContents &contents, DataResource *dataResource, BinaryObject &record )
+{
+    record.subtype = dataResource->resourceType;
+    record.text = addString( contents, dataResource->description );
+    record.format = addString( contents, dataResource->format );
+    addValues( contents, record, 0, dataResource->dataSources );
+    
+    return 0;
+}
+
+
+static int writeDataSource( BinaryContents &contents, DataSource *dataSource, FmlObjectHandle resourceHandle, BinaryObject &record )
+{
+    if( dataSource->sourceType != FML_DATA_SOURCE_ARRAY )
+    {
+        return 1;
+    }
+    
+    ArrayDataSource *arraySource = (ArrayDataSource*)dataSource;
+    
+    record.subtype = arraySource->sourceType;
+    record.references[0] = resourceHandle;
+    record.text = addString( contents, arraySource->location );
+    record.numbers[0] = arraySource->rank;
+    addValues( contents, record, 0, arraySource->offsets );
+    addValues( contents, record, 1, arraySource->sizes );
+    addValues( contents, record, 2, arraySource->rawSizes );
+    
+    return 0;
+}
+
+
+static int writeParameterEvaluator( BinaryContents &contents, ParameterEvaluator *parameterEvaluator, BinaryObject &record )
+{
+    BaseDataDescription *description = parameterEvaluator->dataDescription;
+    
+    record.subtype = description->descriptionType;
+    if( description->descriptionType == FML_DATA_DESCRIPTION_DENSE_ARRAY )
+    {
+        record.references[1] = ( (DenseArrayDataDescription*)description )->dataSource;
+    }
+    else if( description->descriptionType == FML_DATA_DESCRIPTION_DOK_ARRAY )
+    {
+        record.references[1] = ( (DokArrayDataDescription*)description )->valueSource;
+        record.references[2] = ( (DokArrayDataDescription*)description )->keySource;
+    }
+    else if( description->descriptionType != FML_DATA_DESCRIPTION_UNKNOWN )
+    {
+        return 1;
+    }
+    
+    int sparseCount = description->getIndexCount( true );
+    for( int i = 0; i < sparseCount; i++ )
+    {
+        FmlObjectHandle evaluator;
+        description->getIndexEvaluator( i, true, evaluator );
+        addValue( contents, record, 0, evaluator );
+    }
+    
+    int denseCount = description->getIndexCount( false );
+    for( int i = 0; i < denseCount; i++ )
+    {
+        FmlObjectHandle evaluator;
+        description->getIndexEvaluator( i, false, evaluator );
+        addValue( contents, record, 1, evaluator );
+    }
+    for( int i = 0; i < denseCount; i++ )
+    {
+        FmlObjectHandle order;
+        description->getIndexOrder( i, order );
+        addValue( contents, record, 2, order );
+    }
+    
+    return 0;
+}
+
+
+template<typename E> static int writeMapEvaluator( BinaryContents &contents, E *evaluator, BinaryObject &record )
+{
+    record.references[1] = evaluator->indexEvaluator;
+    if( evaluator->evaluators.hasDefault() )
+    {
+        record.flags |= BINARY_DEFAULT_EVALUATOR;
+        record.references[2] = evaluator->evaluators.getDefault();
+    }
+    addPairs( contents, record, 0, evaluator->binds );
+    addPairs( contents, record, 1, evaluator->evaluators );
+    
+    return 0;
+}
+
+
+static int writeObject( BinaryContents &contents, FieldmlObject *object, SimpleMap<FmlObjectHandle, FmlObjectHandle> &sourceResources, FmlObjectHandle handle, BinaryObject &record )
+{
+    switch( object->objectType )
+    {
+    case FHT_ENSEMBLE_TYPE:
+        return writeEnsembleType( contents, (EnsembleType*)object, record );
+    case FHT_CONTINUOUS_TYPE:
+        record.references[0] = ( (ContinuousType*)object )->componentType;
+        return 0;
+    case FHT_MESH_TYPE:
+        return writeMeshType( contents, (MeshType*)object, record );
+    case FHT_BOOLEAN_TYPE:
+        return 0;
+    case FHT_DATA_RESOURCE:
+        return writeDataResource( contents, (DataResource*)object, record );
+    case FHT_DATA_SOURCE:
+        return writeDataSource( contents, (DataSource*)object, sourceResources.get( handle, false ), record );
+    default:
+        break;
+    }
+    
+    Evaluator *evaluator = (Evaluator*)object;
+    record.references[0] = evaluator->valueType;
+    
+    switch( object->objectType )
+    {
+    case FHT_ARGUMENT_EVALUATOR:
+        addValues( contents, record, 0, ( (ArgumentEvaluator*)object )->arguments );
+        return 0;
+    case FHT_EXTERNAL_EVALUATOR:
+        addValues( contents, record, 0, ( (ExternalEvaluator*)object )->arguments );
+        return 0;
+    case FHT_REFERENCE_EVALUATOR:
+        record.references[1] = ( (ReferenceEvaluator*)object )->sourceEvaluator;
+        addPairs( contents, record, 0, ( (ReferenceEvaluator*)object )->binds );
+        return 0;
+    case FHT_PARAMETER_EVALUATOR:
+        return writeParameterEvaluator( contents, (ParameterEvaluator*)object, record );
+    case FHT_PIECEWISE_EVALUATOR:
+        return writeMapEvaluator( contents, (PiecewiseEvaluator*)object, record );
+    case FHT_AGGREGATE_EVALUATOR:
+        return writeMapEvaluator( contents, (AggregateEvaluator*)object, record );
+    case FHT_CONSTANT_EVALUATOR:
+        record.text = addString( contents, ( (ConstantEvaluator*)object )->valueString );
+        return 0;
+    default:
+        break;
+    }
+    
+    return 1;
+}
+
+
+static void writeRegions( BinaryContents &contents, FieldmlSession *session )
+{
+    int regionCount = session->getRegionCount();
+    for( int regionIndex = 0; regionIndex < regionCount; regionIndex++ )
+    {
+        FieldmlRegion *region = session->getRegion( regionIndex );
+        
+        BinaryRegion record;
+        record.href = addString( contents, region->getHref() );
+        record.name = addString( contents, region->getName() );
+        record.root = addString( contents, region->getRoot() );
+        contents.regions.push_back( record );
+        
+        int sourceCount = region->getImportSourceCount();
+        for( int sourceIndex = 0; sourceIndex < sourceCount; sourceIndex++ )
+        {
+            //NOTE: Import sources are indexed by the imported region's index, so not every index is in use.
+            string href = region->getImportSourceHref( sourceIndex );
+            if( href.length() == 0 )
+            {
+                continue;
+            }
+            
+            BinaryImportSource sourceRecord;
+            sourceRecord.region = regionIndex;
+            sourceRecord.sourceRegion = sourceIndex;
+            sourceRecord.href = addString( contents, href );
+            sourceRecord.name = addString( contents, region->getImportSourceRegionName( sourceIndex ) );
+            contents.importSources.push_back( sourceRecord );
+            
+            int importCount = region->getImportCount( sourceIndex );
+            for( int importIndex = 1; importIndex <= importCount; importIndex++ )
+            {
+                BinaryImport importRecord;
+                importRecord.region = regionIndex;
+                importRecord.sourceRegion = sourceIndex;
+                importRecord.object = region->getImportObject( sourceIndex, importIndex );
+                importRecord.reserved = 0;
+                importRecord.localName = addString( contents, region->getImportLocalName( sourceIndex, importIndex ) );
+                importRecord.remoteName = addString( contents, region->getImportRemoteName( sourceIndex, importIndex ) );
+                contents.imports.push_back( importRecord );
+            }
+        }
+    }
+}
+
+
+static int findRegion( FieldmlSession *session, FmlObjectHandle handle )
+{
+    int regionCount = session->getRegionCount();
+    for( int regionIndex = 0; regionIndex < regionCount; regionIndex++ )
+    {
+        if( session->getRegion( regionIndex )->hasLocalObject( handle, true, false ) )
+        {
+            return regionIndex;
+        }
+    }
+    
+    return -1;
+}
+
+
+template<typename T> static bool writeArray( FILE *file, const vector<T> &values )
+{
+    return values.empty() || ( fwrite( &values[0], sizeof( T ), values.size(), file ) == values.size() );
+}
+
+
+int writeFieldmlBinary( FieldmlSession *session, const char *filename )
+{
+    BinaryContents contents;
+    
+    writeRegions( contents, session );
+    
+    //NOTE: Data sources only refer to their resource by address, so their handles are found from the resources.
+    SimpleMap<FmlObjectHandle, FmlObjectHandle> sourceResources( FML_INVALID_HANDLE );
+    
+    int objectCount = session->objects.getCount();
+    contents.objects.reserve( objectCount );
+    for( FmlObjectHandle handle = 0; handle < objectCount; handle++ )
+    {
+        FieldmlObject *object = session->getObject( handle );
+        
+        BinaryObject record;
+        memset( &record, 0, sizeof( record ) );
+        record.objectType = object->objectType;
+        record.region = findRegion( session, handle );
+        record.flags = object->isVirtual ? BINARY_VIRTUAL : 0;
+        record.intValue = object->intValue;
+        record.references[0] = FML_INVALID_HANDLE;
+        record.references[1] = FML_INVALID_HANDLE;
+        record.references[2] = FML_INVALID_HANDLE;
+        record.name = addString( contents, object->name );
+        record.valueOffset = contents.values.size();
+        
+        if( writeObject( contents, object, sourceResources, handle, record ) != 0 )
+        {
+            session->logError( "Cannot store object in binary file", object->name.c_str(), filename );
+            return 1;
+        }
+        
+        if( object->objectType == FHT_DATA_RESOURCE )
+        {
+            vector<FmlObjectHandle> &dataSources = ( (DataResource*)object )->dataSources;
+            for( vector<FmlObjectHandle>::const_iterator i = dataSources.begin(); i != dataSources.end(); i++ )
+            {
+                sourceResources.set( *i, handle );
+            }
+        }
+        
+        contents.objects.push_back( record );
+    }
+    
+    BinaryHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, BINARY_MAGIC, sizeof( header.magic ) );
+    header.version = FML_BINARY_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.regionCount = contents.regions.size();
+    header.currentRegion = -1;
+    for( int i = 0; i < header.regionCount; i++ )
+    {
+        if( session->getRegion( i ) == session->region )
+        {
+            header.currentRegion = i;
+        }
+    }
+    header.importSourceCount = contents.importSources.size();
+    header.importCount = contents.imports.size();
+    header.objectCount = contents.objects.size();
+    header.valueCount = contents.values.size();
+    header.stringLength = contents.strings.length();
+    
+    FILE *file = fopen( filename, "wb" );
+    if( file == NULL )
+    {
+        session->logError( "Cannot open binary file for writing", filename );
+        return 1;
+    }
+    
+    bool written =
+        ( fwrite( &header, sizeof( header ), 1, file ) == 1 ) &&
+        writeArray( file, contents.regions ) &&
+        writeArray( file, contents.importSources ) &&
+        writeArray( file, contents.imports ) &&
+        writeArray( file, contents.objects ) &&
+        writeArray( file, contents.values ) &&
+        ( fwrite( contents.strings.data(), 1, contents.strings.length(), file ) == contents.strings.length() );
+    
+    if( ( fclose( file ) != 0 ) || !written )
+    {
+        session->logError( "Error writing binary file", filename );
+        return 1;
+    }
+    
+    return 0;
+}
+
+//========================================================================
+//
+// Reading
+//
+//========================================================================
+
+/**
+ * A read-only view of a whole file. Where possible, the file is mapped rather than read, so only the pages that are
+ * actually used are loaded.
+ */
+class MappedFile
+{
+private:
+    const char *data;
+    
+    size_t size;
+    
+public:
+    MappedFile()
+    {
+        data = NULL;
+        size = 0;
+    }
+    
+    
+    bool open( const char *filename );
+    
+    
+    const char *getData()
+    {
+        return data;
+    }
+    
+    
+    size_t getSize()
+    {
+        return size;
+    }
+    
+    
+    ~MappedFile();
+};
+
+
+#if defined WIN32
+
+bool MappedFile::open( const char *filename )
+{
+    FILE *file = fopen( filename, "rb" );
+    if( file == NULL )
+    {
+        return false;
+    }
+    
+    bool ok = ( fseek( file, 0, SEEK_END ) == 0 );
+    long length = ok ? ftell( file ) : -1;
+    if( length > 0 )
+    {
+        char *buffer = new char[length];
+        rewind( file );
+        if( fread( buffer, 1, length, file ) == (size_t)length )
+        {
+            data = buffer;
+            size = length;
+        }
+        else
+        {
+            delete[] buffer;
+        }
+    }
+    fclose( file );
+    
+    return data != NULL;
+}
+
+
+MappedFile::~MappedFile()
+{
+    delete[] data;
+}
+
+#else
+
+bool MappedFile::open( const char *filename )
+{
+    int descriptor = ::open( filename, O_RDONLY );
+    if( descriptor < 0 )
+    {
+        return false;
+    }
+    
+    struct stat status;
+    if( ( fstat( descriptor, &status ) == 0 ) && ( status.st_size > 0 ) )
+    {
+        void *mapping = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+        if( mapping != MAP_FAILED )
+        {
+            data = (const char*)mapping;
+            size = status.st_size;
+        }
+    }
+    close( descriptor );
+    
+    return data != NULL;
+}
+
+
+MappedFile::~MappedFile()
+{
+    if( data != NULL )
+    {
+        munmap( (void*)data, size );
+    }
+}
+
+#endif
+
+
+/**
+ * The sections of a binary session file.
+ */
+struct BinaryImage
+{
+    const BinaryHeader *header;
+    const BinaryRegion *regions;
+    const BinaryImportSource *importSources;
+    const BinaryImport *imports;
+    const BinaryObject *objects;
+    const int64_t *values;
+    const char *strings;
+};
+
+
+static bool getString( const BinaryImage &image, const BinaryString &binaryString, string &value )
+{
+    if( ( binaryString.offset < 0 ) || ( binaryString.length < 0 ) || ( binaryString.offset > image.header->stringLength - binaryString.length ) )
+    {
+        return false;
+    }
+    
+    value.assign( image.strings + binaryString.offset, binaryString.length );
+    return true;
+}
+
+
+static bool isHandle( const BinaryImage &image, int64_t handle )
+{
+    return ( handle >= FML_INVALID_HANDLE ) && ( handle < image.header->objectCount );
+}
+
+
+//NOTE: Every stride'th value, starting with the first, must be a handle.
+static bool areHandles( const BinaryImage &image, const int64_t *values, int64_t count, int stride )
+{
+    for( int64_t i = 0; i < count; i += stride )
+    {
+        if( !isHandle( image, values[i] ) )
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+template<typename K> static void setPairs( SimpleMap<K, FmlObjectHandle> &map, const int64_t *values, int64_t count )
+{
+    vector<pair<K, FmlObjectHandle> > pairs;
+    pairs.reserve( count / 2 );
+    for( int64_t i = 0; i + 1 < count; i += 2 )
+    {
+        pairs.push_back( pair<K, FmlObjectHandle>( (K)values[i], (FmlObjectHandle)values[i + 1] ) );
+    }
+    
+    map.setAll( pairs );
+}
+
+
+static FieldmlObject *readEnsembleType( FieldmlSession *session, const InternedName &name, const BinaryObject &record )
+{
+    //NOTE: EnsembleMembers relies on the rules that Fieldml_SetEnsembleMembersRange enforces, so the fields must follow them.
+    int64_t min = record.numbers[0];
+    int64_t max = record.numbers[1];
+    int64_t stride = record.numbers[2];
+    int64_t count = record.numbers[3];
+    if( ( record.subtype < FML_ENSEMBLE_MEMBER_UNKNOWN ) || ( record.subtype > FML_ENSEMBLE_MEMBER_STRIDE_RANGE_DATA ) )
+    {
+        return NULL;
+    }
+    if( ( min < 0 ) || ( min > max ) || ( max > INT_MAX ) || ( stride < 1 ) || ( stride > INT_MAX ) || ( count < 0 ) || ( count > INT_MAX ) )
+    {
+        return NULL;
+    }
+    if( ( record.subtype == FML_ENSEMBLE_MEMBER_UNKNOWN ) && ( count != 0 ) )
+    {
+        return NULL;
+    }
+    if( ( record.subtype == FML_ENSEMBLE_MEMBER_RANGE ) && ( count != ( ( max - min ) / stride ) + 1 ) )
+    {
+        return NULL;
+    }
+    
+    EnsembleType *ensembleType = new( session->objects.getArena() ) EnsembleType( name, ( record.flags & BINARY_COMPONENT_ENSEMBLE ) != 0, ( record.flags & BINARY_VIRTUAL ) != 0 );
+    
+    ensembleType->membersType = (FieldmlEnsembleMembersType)record.subtype;
+    ensembleType->dataSource = record.references[0];
+    ensembleType->min = (FmlEnsembleValue)record.numbers[0];
+    ensembleType->max = (FmlEnsembleValue)record.numbers[1];
+    ensembleType->stride = (int)record.numbers[2];
+    ensembleType->count = (int)record.numbers[3];
+    
+    return ensembleType;
+}
+
+
+static FieldmlObject *readMeshType( FieldmlSession *session, const InternedName &name, const BinaryObject &record )
+{
+    MeshType *meshType = new( session->objects.getArena() ) MeshType( name, ( record.flags & BINARY_VIRTUAL ) != 0 );
+    
+    meshType->chartType = record.references[0];
+    meshType->elementsType = record.references[1];
+    meshType->shapes = record.references[2];
+    
+    return meshType;
+}
+
+
+static FieldmlObject *readDataResource( FieldmlSession *session, const BinaryImage &image, const InternedName &name, const BinaryObject &record, const int64_t *values )
+{
+    string description;
+    string format;
+    if( !getString( image, record.text, description ) || !getString( image, record.format, format ) )
+    {
+        return NULL;
+    }
+    if( ( record.subtype != FML_DATA_RESOURCE_HREF ) && ( record.subtype != FML_DATA_RESOURCE_INLINE ) )
+    {
+        return NULL;
+    }
+    if( !areHandles( image, values, record.valueCounts[0], 1 ) )
+    {
+        return NULL;
+    }
+    
+    DataResource *dataResource = new( session->objects.getArena() ) DataResource( name, (FieldmlDataResourceType)record.subtype, format, description );
+    dataResource->dataSources.assign( values, values + record.valueCounts[0] );
+    
+    return dataResource;
+}
+
+
+static FieldmlObject *readDataSource( FieldmlSession *session, const BinaryImage &image, const InternedName &name, const BinaryObject &record, const int64_t *values )
+{
+    string location;
+    if( ( record.subtype != FML_DATA_SOURCE_ARRAY ) || !getString( image, record.text, location ) )
+    {
+        return NULL;
+    }
+    
+    //NOTE: Each of the offsets, sizes and raw sizes holds one entry per dimension.
+    int64_t rank = record.numbers[0];
+    if( ( rank < 1 ) || ( rank > INT_MAX ) ||
+        ( record.valueCounts[0] != rank ) || ( record.valueCounts[1] != rank ) || ( record.valueCounts[2] != rank ) )
+    {
+        return NULL;
+    }
+    
+    //NOTE: Resources are always created before their data sources.
+    FmlObjectHandle resourceHandle = record.references[0];
+    if( ( resourceHandle < 0 ) || ( resourceHandle >= session->objects.getCount() ) )
+    {
+        return NULL;
+    }
+    FieldmlObject *resource = session->getObject( resourceHandle );
+    if( resource->objectType != FHT_DATA_RESOURCE )
+    {
+        return NULL;
+    }
+    
+    ArrayDataSource *arraySource = new( session->objects.getArena() ) ArrayDataSource( name, (DataResource*)resource, location, (int)rank );
+    
+    const int64_t *offsets = values;
+    const int64_t *sizes = offsets + record.valueCounts[0];
+    const int64_t *rawSizes = sizes + record.valueCounts[1];
+    arraySource->offsets.assign( offsets, offsets + record.valueCounts[0] );
+    arraySource->sizes.assign( sizes, sizes + record.valueCounts[1] );
+    arraySource->rawSizes.assign( rawSizes, rawSizes + record.valueCounts[2] );
+    
+    return arraySource;
+}
+
+
+static FieldmlObject *readParameterEvaluator( FieldmlSession *session, const BinaryImage &image, const InternedName &name, const BinaryObject &record, const int64_t *values )
+{
+    if( !areHandles( image, values, record.valueCounts[0] + record.valueCounts[1] + record.valueCounts[2], 1 ) )
+    {
+        return NULL;
+    }
+    if( record.valueCounts[1] != record.valueCounts[2] )
+    {
+        return NULL;
+    }
+    if( ( record.subtype != FML_DATA_DESCRIPTION_UNKNOWN ) && ( record.subtype != FML_DATA_DESCRIPTION_DENSE_ARRAY ) &&
+        ( record.subtype != FML_DATA_DESCRIPTION_DOK_ARRAY ) )
+    {
+        return NULL;
+    }
+    
+    ObjectArena &arena = session->objects.getArena();
+    ParameterEvaluator *parameterEvaluator = new( arena ) ParameterEvaluator( name, record.references[0], ( record.flags & BINARY_VIRTUAL ) != 0, arena );
+    
+    if( record.subtype == FML_DATA_DESCRIPTION_DENSE_ARRAY )
+    {
+        DenseArrayDataDescription *description = new( arena ) DenseArrayDataDescription();
+        description->dataSource = record.references[1];
+        parameterEvaluator->dataDescription = description;
+    }
+    else if( record.subtype == FML_DATA_DESCRIPTION_DOK_ARRAY )
+    {
+        DokArrayDataDescription *description = new( arena ) DokArrayDataDescription();
+        description->valueSource = record.references[1];
+        description->keySource = record.references[2];
+        parameterEvaluator->dataDescription = description;
+    }
+    
+    const int64_t *sparseIndexes = values;
+    const int64_t *denseIndexes = sparseIndexes + record.valueCounts[0];
+    const int64_t *denseOrders = denseIndexes + record.valueCounts[1];
+    //NOTE: The description rejects indexes it cannot hold, such as sparse indexes on a dense array.
+    for( int64_t i = 0; i < record.valueCounts[0]; i++ )
+    {
+        if( parameterEvaluator->dataDescription->addIndexEvaluator( true, (FmlObjectHandle)sparseIndexes[i], FML_INVALID_HANDLE ) != FML_ERR_NO_ERROR )
+        {
+            return NULL;
+        }
+    }
+    for( int64_t i = 0; i < record.valueCounts[1]; i++ )
+    {
+        if( parameterEvaluator->dataDescription->addIndexEvaluator( false, (FmlObjectHandle)denseIndexes[i], (FmlObjectHandle)denseOrders[i] ) != FML_ERR_NO_ERROR )
+        {
+            return NULL;
+        }
+    }
+    
+    return parameterEvaluator;
+}
+
+
+template<typename E> static FieldmlObject *readMapEvaluator( E *evaluator, const BinaryImage &image, const BinaryObject &record, const int64_t *values )
+{
+    const int64_t *binds = values;
+    const int64_t *evaluators = binds + record.valueCounts[0];
+    if( ( record.valueCounts[0] % 2 != 0 ) || ( record.valueCounts[1] % 2 != 0 ) ||
+        !areHandles( image, binds, record.valueCounts[0], 1 ) || !areHandles( image, evaluators + 1, record.valueCounts[1], 2 ) )
+    {
+        return NULL;
+    }
+    
+    evaluator->indexEvaluator = record.references[1];
+    if( ( record.flags & BINARY_DEFAULT_EVALUATOR ) != 0 )
+    {
+        evaluator->evaluators.setDefault( record.references[2] );
+    }
+    setPairs( evaluator->binds, binds, record.valueCounts[0] );
+    setPairs( evaluator->evaluators, evaluators, record.valueCounts[1] );
+    
+    return evaluator;
+}
+
+
+static FieldmlObject *readObject( FieldmlSession *session, const BinaryImage &image, const BinaryObject &record )
+{
+    string name;
+    if( !getString( image, record.name, name ) )
+    {
+        return NULL;
+    }
+    for( int i = 0; i < 3; i++ )
+    {
+        if( !isHandle( image, record.references[i] ) )
+        {
+            return NULL;
+        }
+    }
+    
+    int64_t valueCount = 0;
+    for( int i = 0; i < 3; i++ )
+    {
+        if( record.valueCounts[i] < 0 )
+        {
+            return NULL;
+        }
+        valueCount += record.valueCounts[i];
+    }
+    if( ( record.valueOffset < 0 ) || ( record.valueOffset > image.header->valueCount - valueCount ) )
+    {
+        return NULL;
+    }
+    const int64_t *values = image.values + record.valueOffset;
+    
+    ObjectArena &arena = session->objects.getArena();
+    const InternedName internedName = session->objects.internName( name );
+    bool isVirtual = ( record.flags & BINARY_VIRTUAL ) != 0;
+    FmlObjectHandle valueType = record.references[0];
+    
+    switch( record.objectType )
+    {
+    case FHT_ENSEMBLE_TYPE:
+        return readEnsembleType( session, internedName, record );
+    case FHT_CONTINUOUS_TYPE:
+    {
+        ContinuousType *continuousType = new( arena ) ContinuousType( internedName, isVirtual );
+        continuousType->componentType = record.references[0];
+        return continuousType;
+    }
+    case FHT_MESH_TYPE:
+        return readMeshType( session, internedName, record );
+    case FHT_BOOLEAN_TYPE:
+        return new( arena ) BooleanType( internedName, isVirtual );
+    case FHT_DATA_RESOURCE:
+        return readDataResource( session, image, internedName, record, values );
+    case FHT_DATA_SOURCE:
+        return readDataSource( session, image, internedName, record, values );
+    case FHT_ARGUMENT_EVALUATOR:
+    case FHT_EXTERNAL_EVALUATOR:
+    {
+        if( !areHandles( image, values, record.valueCounts[0], 1 ) )
+        {
+            return NULL;
+        }
+        if( record.objectType == FHT_ARGUMENT_EVALUATOR )
+        {
+            ArgumentEvaluator *argumentEvaluator = new( arena ) ArgumentEvaluator( internedName, valueType, isVirtual );
+            argumentEvaluator->arguments.insert( values, values + record.valueCounts[0] );
+            return argumentEvaluator;
+        }
+        ExternalEvaluator *externalEvaluator = new( arena ) ExternalEvaluator( internedName, valueType, isVirtual );
+        externalEvaluator->arguments.insert( values, values + record.valueCounts[0] );
+        return externalEvaluator;
+    }
+    case FHT_REFERENCE_EVALUATOR:
+    {
+        if( ( record.valueCounts[0] % 2 != 0 ) || !areHandles( image, values, record.valueCounts[0], 1 ) )
+        {
+            return NULL;
+        }
+        ReferenceEvaluator *referenceEvaluator = new( arena ) ReferenceEvaluator( internedName, record.references[1], valueType, isVirtual );
+        setPairs( referenceEvaluator->binds, values, record.valueCounts[0] );
+        return referenceEvaluator;
+    }
+    case FHT_PARAMETER_EVALUATOR:
+        return readParameterEvaluator( session, image, internedName, record, values );
+    case FHT_PIECEWISE_EVALUATOR:
+        return readMapEvaluator( new( arena ) PiecewiseEvaluator( internedName, valueType, isVirtual ), image, record, values );
+    case FHT_AGGREGATE_EVALUATOR:
+        return readMapEvaluator( new( arena ) AggregateEvaluator( internedName, valueType, isVirtual ), image, record, values );
+    case FHT_CONSTANT_EVALUATOR:
+    {
+        string valueString;
+        if( !getString( image, record.text, valueString ) )
+        {
+            return NULL;
+        }
+        return new( arena ) ConstantEvaluator( internedName, valueString, valueType );
+    }
+    default:
+        break;
+    }
+    
+    return NULL;
+}
+
+
+/**
+ * Checks that the given handle is invalid, or refers to an object whose type lies between the given types.
+ */
+static bool isReference( FieldmlSession *session, int64_t handle, FieldmlHandleType firstType, FieldmlHandleType lastType )
+{
+    if( handle == FML_INVALID_HANDLE )
+    {
+        return true;
+    }
+    
+    FieldmlHandleType type = session->getObject( (FmlObjectHandle)handle )->objectType;
+    return ( type >= firstType ) && ( type <= lastType );
+}
+
+
+//NOTE: Every stride'th value, starting with the first, must be a reference.
+static bool areReferences( FieldmlSession *session, const int64_t *values, int64_t count, int stride, FieldmlHandleType firstType, FieldmlHandleType lastType )
+{
+    for( int64_t i = 0; i < count; i += stride )
+    {
+        if( !isReference( session, values[i], firstType, lastType ) )
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+/**
+ * Checks that the given record's references are to the types of object that the Set* API accepts for them. Records
+ * may refer to objects with later handles, so this can only be done once every object has been read.
+ */
+static bool checkReferences( FieldmlSession *session, const BinaryImage &image, const BinaryObject &record )
+{
+    const int64_t *values = image.values + record.valueOffset;
+    const int64_t *binds = values;
+    const int64_t *evaluators = binds + record.valueCounts[0];
+    
+    switch( record.objectType )
+    {
+    case FHT_ENSEMBLE_TYPE:
+        if( ( record.subtype != FML_ENSEMBLE_MEMBER_UNKNOWN ) && ( record.subtype != FML_ENSEMBLE_MEMBER_RANGE ) &&
+            ( record.references[0] == FML_INVALID_HANDLE ) )
+        {
+            return false;
+        }
+        return isReference( session, record.references[0], FHT_DATA_SOURCE, FHT_DATA_SOURCE );
+    case FHT_CONTINUOUS_TYPE:
+        return isReference( session, record.references[0], FHT_ENSEMBLE_TYPE, FHT_ENSEMBLE_TYPE );
+    case FHT_MESH_TYPE:
+        return isReference( session, record.references[0], FHT_CONTINUOUS_TYPE, FHT_CONTINUOUS_TYPE ) &&
+            isReference( session, record.references[1], FHT_ENSEMBLE_TYPE, FHT_ENSEMBLE_TYPE ) &&
+            isReference( session, record.references[2], FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR );
+    case FHT_BOOLEAN_TYPE:
+        return true;
+    case FHT_DATA_RESOURCE:
+        return areReferences( session, values, record.valueCounts[0], 1, FHT_DATA_SOURCE, FHT_DATA_SOURCE );
+    case FHT_DATA_SOURCE:
+        //NOTE: The resource is checked when the data source is read.
+        return true;
+    default:
+        break;
+    }
+    
+    if( !isReference( session, record.references[0], FHT_ENSEMBLE_TYPE, FHT_BOOLEAN_TYPE ) )
+    {
+        return false;
+    }
+    
+    switch( record.objectType )
+    {
+    case FHT_ARGUMENT_EVALUATOR:
+    case FHT_EXTERNAL_EVALUATOR:
+        return areReferences( session, values, record.valueCounts[0], 1, FHT_ARGUMENT_EVALUATOR, FHT_ARGUMENT_EVALUATOR );
+    case FHT_REFERENCE_EVALUATOR:
+        return isReference( session, record.references[1], FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR ) &&
+            areReferences( session, binds, record.valueCounts[0], 2, FHT_ARGUMENT_EVALUATOR, FHT_ARGUMENT_EVALUATOR ) &&
+            areReferences( session, binds + 1, record.valueCounts[0] - 1, 2, FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR );
+    case FHT_PIECEWISE_EVALUATOR:
+    case FHT_AGGREGATE_EVALUATOR:
+        return isReference( session, record.references[1], FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR ) &&
+            isReference( session, record.references[2], FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR ) &&
+            areReferences( session, binds, record.valueCounts[0], 2, FHT_ARGUMENT_EVALUATOR, FHT_ARGUMENT_EVALUATOR ) &&
+            areReferences( session, binds + 1, record.valueCounts[0] - 1, 2, FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR ) &&
+            areReferences( session, evaluators + 1, record.valueCounts[1] - 1, 2, FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR );
+    case FHT_PARAMETER_EVALUATOR:
+        return isReference( session, record.references[1], FHT_DATA_SOURCE, FHT_DATA_SOURCE ) &&
+            isReference( session, record.references[2], FHT_DATA_SOURCE, FHT_DATA_SOURCE ) &&
+            areReferences( session, values, record.valueCounts[0] + record.valueCounts[1] + record.valueCounts[2], 1, FHT_ARGUMENT_EVALUATOR, FHT_CONSTANT_EVALUATOR );
+    default:
+        break;
+    }
+    
+    return true;
+}
+
+
+/**
+ * Locates the sections of the given file, checking that the header is compatible and the sections fill the file.
+ */
+static bool getImage( MappedFile &file, BinaryImage &image )
+{
+    if( file.getSize() < sizeof( BinaryHeader ) )
+    {
+        return false;
+    }
+    
+    const BinaryHeader *header = (const BinaryHeader*)file.getData();
+    if( ( memcmp( header->magic, BINARY_MAGIC, sizeof( header->magic ) ) != 0 ) || ( header->byteOrder != BINARY_BYTE_ORDER ) || ( header->version != FML_BINARY_VERSION ) )
+    {
+        return false;
+    }
+    if( ( header->regionCount < 0 ) || ( header->importSourceCount < 0 ) || ( header->importCount < 0 ) || ( header->objectCount < 0 ) ||
+        ( header->valueCount < 0 ) || ( header->stringLength < 0 ) )
+    {
+        return false;
+    }
+    if( ( header->currentRegion < 0 ) || ( header->currentRegion >= header->regionCount ) )
+    {
+        return false;
+    }
+    
+    //NOTE: The counts are checked against the file size first, so the total cannot overflow.
+    uint64_t fileSize = file.getSize();
+    if( ( (uint64_t)header->valueCount > fileSize / sizeof( int64_t ) ) || ( (uint64_t)header->stringLength > fileSize ) )
+    {
+        return false;
+    }
+    uint64_t expectedSize = sizeof( BinaryHeader ) +
+        header->regionCount * (uint64_t)sizeof( BinaryRegion ) +
+        header->importSourceCount * (uint64_t)sizeof( BinaryImportSource ) +
+        header->importCount * (uint64_t)sizeof( BinaryImport ) +
+        header->objectCount * (uint64_t)sizeof( BinaryObject ) +
+        header->valueCount * (uint64_t)sizeof( int64_t ) +
+        header->stringLength;
+    if( expectedSize != fileSize )
+    {
+        return false;
+    }
+    
+    image.header = header;
+    image.regions = (const BinaryRegion*)( header + 1 );
+    image.importSources = (const BinaryImportSource*)( image.regions + header->regionCount );
+    image.imports = (const BinaryImport*)( image.importSources + header->importSourceCount );
+    image.objects = (const BinaryObject*)( image.imports + header->importCount );
+    image.values = (const int64_t*)( image.objects + header->objectCount );
+    image.strings = (const char*)( image.values + header->valueCount );
+    
+    return true;
+}
+
+
+static bool readImports( FieldmlSession *session, const BinaryImage &image )
+{
+    int regionCount = image.header->regionCount;
+    
+    for( int i = 0; i < image.header->importSourceCount; i++ )
+    {
+        const BinaryImportSource &record = image.importSources[i];
+        string href;
+        string name;
+        if( ( record.region < 0 ) || ( record.region >= regionCount ) || ( record.sourceRegion < 0 ) || ( record.sourceRegion >= regionCount ) ||
+            !getString( image, record.href, href ) || !getString( image, record.name, name ) )
+        {
+            return false;
+        }
+        session->getRegion( record.region )->addImportSource( record.sourceRegion, href, name );
+    }
+    
+    for( int i = 0; i < image.header->importCount; i++ )
+    {
+        const BinaryImport &record = image.imports[i];
+        string localName;
+        string remoteName;
+        if( ( record.region < 0 ) || ( record.region >= regionCount ) || !isHandle( image, record.object ) ||
+            !getString( image, record.localName, localName ) || !getString( image, record.remoteName, remoteName ) )
+        {
+            return false;
+        }
+        session->getRegion( record.region )->addImport( record.sourceRegion, localName, remoteName, record.object );
+    }
+    
+    return true;
+}
+
+
+int readFieldmlBinary( FieldmlSession *session, const char *filename )
+{
+    MappedFile file;
+    if( !file.open( filename ) )
+    {
+        session->logError( "Cannot read binary file", filename );
+        return 1;
+    }
+    
+    BinaryImage image;
+    if( !getImage( file, image ) )
+    {
+        session->logError( "Not a compatible FieldML binary file", filename );
+        return 1;
+    }
+    
+    for( int i = 0; i < image.header->regionCount; i++ )
+    {
+        const BinaryRegion &record = image.regions[i];
+        string href;
+        string name;
+        string root;
+        if( !getString( image, record.href, href ) || !getString( image, record.name, name ) || !getString( image, record.root, root ) )
+        {
+            session->logError( "Invalid region in binary file", filename );
+            return 1;
+        }
+        session->addNewRegion( href, name )->setRoot( root );
+    }
+    
+    for( int i = 0; i < image.header->objectCount; i++ )
+    {
+        const BinaryObject &record = image.objects[i];
+        FieldmlObject *object = NULL;
+        if( ( record.region >= -1 ) && ( record.region < image.header->regionCount ) )
+        {
+            object = readObject( session, image, record );
+        }
+        if( object == NULL )
+        {
+            session->logError( "Invalid object in binary file", filename );
+            return 1;
+        }
+        
+        object->intValue = record.intValue;
+        FmlObjectHandle handle = session->objects.addObject( object );
+        if( record.region >= 0 )
+        {
+            session->getRegion( record.region )->addLocalObject( handle );
+        }
+    }
+    
+    for( int i = 0; i < image.header->objectCount; i++ )
+    {
+        if( !checkReferences( session, image, image.objects[i] ) )
+        {
+            session->logError( "Invalid object reference in binary file", filename );
+            return 1;
+        }
+    }
+    
+    if( !readImports( session, image ) )
+    {
+        session->logError( "Invalid import in binary file", filename );
+        return 1;
+    }
+    
+    session->region = session->getRegion( image.header->currentRegion );
+    
+    return 0;
+}
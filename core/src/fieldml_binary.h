@@ -0,0 +1,69 @@
+/* \file
+ * $Id$
+ * \author Caton Little
+ * \brief 
+ *
+ * \section LICENSE
+ *
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.1 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See the
+ * License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is FieldML
+ *
+ * The Initial Developer of the Original Code is Auckland Uniservices Ltd,
+ * Auckland, New Zealand. Portions created by the Initial Developer are
+ * Copyright (C) 2010 the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ */
+
+#ifndef H_FIELDML_BINARY
+#define H_FIELDML_BINARY
+
+#include "FieldmlSession.h"
+
+/**
+ * The version of the binary session format written by writeFieldmlBinary. Files written with any other version are
+ * rejected by readFieldmlBinary, and must be rewritten from their original documents.
+ */
+#define FML_BINARY_VERSION 1
+
+/**
+ * Writes the session's objects, regions and imports to the given file in a compact binary form.
+ * 
+ * \return Non-zero if the file could not be written, or the session has objects that cannot be stored.
+ */
+int writeFieldmlBinary( FieldmlSession *session, const char *filename );
+
+/**
+ * Recreates the contents of a file written by writeFieldmlBinary in the given session, which must be empty. Objects
+ * are created directly from their records, with the same handles, so the file is not parsed or validated beyond
+ * checking that its records are consistent.
+ * 
+ * \return Non-zero if the file could not be read, or is not a compatible binary session file.
+ */
+int readFieldmlBinary( FieldmlSession *session, const char *filename );
+
+#endif //H_FIELDML_BINARY
@@ -41,6 +41,7 @@
 
 #include "string_const.h"
 #include "fieldml_structs.h"
+#include "Util.h"
 
 using namespace std;
 
@@ -50,12 +51,26 @@ using namespace std;
 //
 //========================================================================
 
-FieldmlObject::FieldmlObject( const string _name, FieldmlHandleType _type, bool _isVirtual ) :
-    name( _name ),
+FieldmlObject::FieldmlObject( const InternedName &_name, FieldmlHandleType _type, bool _isVirtual ) :
     objectType( _type ),
+    name( _name.value ),
+    nameId( _name.id ),
     isVirtual( _isVirtual )
 {
     intValue = 0;
+    accountedSize = 0;
+}
+
+
+size_t FieldmlObject::getContentSize() const
+{
+    return 0;
+}
+
+
+FieldmlMemoryCategory FieldmlObject::getContentCategory() const
+{
+    return FML_MEMORY_MAPS;
 }
 
 
@@ -64,14 +79,32 @@ FieldmlObject::~FieldmlObject()
 }
 
 
-ElementSequence::ElementSequence( const string _name, FmlObjectHandle _elementType ) :
+ElementSequence::ElementSequence( const InternedName &_name, FmlObjectHandle _elementType ) :
     FieldmlObject( _name, FHT_UNKNOWN, false ),
     elementType( _elementType )
 {
 }
 
 
-EnsembleType::EnsembleType( const string _name, bool _isComponentEnsemble, bool _isVirtual ) :
+FieldmlObject *ElementSequence::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ElementSequence( *this );
+}
+
+
+size_t ElementSequence::getContentSize() const
+{
+    return members.getMemoryUsage();
+}
+
+
+FieldmlMemoryCategory ElementSequence::getContentCategory() const
+{
+    return FML_MEMORY_BITSETS;
+}
+
+
+EnsembleType::EnsembleType( const InternedName &_name, bool _isComponentEnsemble, bool _isVirtual ) :
     FieldmlObject( _name, FHT_ENSEMBLE_TYPE, _isVirtual ),
     isComponentEnsemble( _isComponentEnsemble )
 {
@@ -80,23 +113,42 @@ EnsembleType::EnsembleType( const string _name, bool _isComponentEnsemble, bool
     min = 0;
     max = 0;
     stride = 1;
+    dataSource = FML_INVALID_HANDLE;
+}
+
+
+FieldmlObject *EnsembleType::clone( ObjectArena &arena ) const
+{
+    return new( arena ) EnsembleType( *this );
 }
 
 
-BooleanType::BooleanType( const string _name, bool _isVirtual ) :
+BooleanType::BooleanType( const InternedName &_name, bool _isVirtual ) :
     FieldmlObject( _name, FHT_BOOLEAN_TYPE, _isVirtual )
 {
 }
 
 
-ContinuousType::ContinuousType( const string _name, bool _isVirtual ) :
+FieldmlObject *BooleanType::clone( ObjectArena &arena ) const
+{
+    return new( arena ) BooleanType( *this );
+}
+
+
+ContinuousType::ContinuousType( const InternedName &_name, bool _isVirtual ) :
     FieldmlObject( _name, FHT_CONTINUOUS_TYPE, _isVirtual )
 {
     componentType = FML_INVALID_HANDLE;
 }
 
 
-MeshType::MeshType( const string _name, bool _isVirtual ) :
+FieldmlObject *ContinuousType::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ContinuousType( *this );
+}
+
+
+MeshType::MeshType( const InternedName &_name, bool _isVirtual ) :
     FieldmlObject( _name, FHT_MESH_TYPE, _isVirtual )
 {
     shapes = FML_INVALID_HANDLE;
@@ -105,7 +157,13 @@ MeshType::MeshType( const string _name, bool _isVirtual ) :
 }
 
 
-DataResource::DataResource( const string _name, FieldmlDataResourceType _resourceType, const string _format, const string _description ) : 
+FieldmlObject *MeshType::clone( ObjectArena &arena ) const
+{
+    return new( arena ) MeshType( *this );
+}
+
+
+DataResource::DataResource( const InternedName &_name, FieldmlDataResourceType _resourceType, const string _format, const string _description ) : 
     FieldmlObject( _name, FHT_DATA_RESOURCE, false ),
     resourceType( _resourceType ),
     format( _format ),
@@ -114,6 +172,29 @@ DataResource::DataResource( const string _name, FieldmlDataResourceType _resourc
 }
 
 
+FieldmlObject *DataResource::clone( ObjectArena &arena ) const
+{
+    return new( arena ) DataResource( *this );
+}
+
+
+size_t DataResource::getContentSize() const
+{
+    if( resourceType != FML_DATA_RESOURCE_INLINE )
+    {
+        return 0;
+    }
+    
+    return FmlUtil::memoryUsage( description );
+}
+
+
+FieldmlMemoryCategory DataResource::getContentCategory() const
+{
+    return FML_MEMORY_INLINE_DATA;
+}
+
+
 DataResource::~DataResource()
 {
 }
@@ -130,12 +211,24 @@ BaseDataDescription::~BaseDataDescription()
 }
 
 
+size_t BaseDataDescription::getContentSize() const
+{
+    return 0;
+}
+
+
 UnknownDataDescription::UnknownDataDescription() :
     BaseDataDescription( FML_DATA_DESCRIPTION_UNKNOWN )
 {
 }
 
 
+BaseDataDescription *UnknownDataDescription::clone( ObjectArena &arena ) const
+{
+    return new( arena ) UnknownDataDescription( *this );
+}
+
+
 void UnknownDataDescription::addDelegates( set<FmlObjectHandle> &delegates )
 {
 }
@@ -194,6 +287,18 @@ DenseArrayDataDescription::DenseArrayDataDescription() :
 }
 
 
+BaseDataDescription *DenseArrayDataDescription::clone( ObjectArena &arena ) const
+{
+    return new( arena ) DenseArrayDataDescription( *this );
+}
+
+
+size_t DenseArrayDataDescription::getContentSize() const
+{
+    return FmlUtil::memoryUsage( denseIndexes ) + FmlUtil::memoryUsage( denseOrders );
+}
+
+
 void DenseArrayDataDescription::addDelegates( set<FmlObjectHandle> &delegates )
 {
     delegates.insert( denseIndexes.begin(), denseIndexes.end() );
@@ -301,6 +406,18 @@ DokArrayDataDescription::DokArrayDataDescription() :
 }
 
 
+BaseDataDescription *DokArrayDataDescription::clone( ObjectArena &arena ) const
+{
+    return new( arena ) DokArrayDataDescription( *this );
+}
+
+
+size_t DokArrayDataDescription::getContentSize() const
+{
+    return FmlUtil::memoryUsage( sparseIndexes ) + FmlUtil::memoryUsage( denseIndexes ) + FmlUtil::memoryUsage( denseOrders );
+}
+
+
 void DokArrayDataDescription::addDelegates( set<FmlObjectHandle> &delegates )
 {
     delegates.insert( denseIndexes.begin(), denseIndexes.end() );
@@ -455,7 +572,7 @@ DokArrayDataDescription::~DokArrayDataDescription()
 }
 
 
-DataSource::DataSource( const std::string _name, DataResource *_resource, FieldmlDataSourceType _type ) :
+DataSource::DataSource( const InternedName &_name, DataResource *_resource, FieldmlDataSourceType _type ) :
     FieldmlObject( _name, FHT_DATA_SOURCE, false ),
     resource( _resource ),
     sourceType( _type )
@@ -463,7 +580,15 @@ DataSource::DataSource( const std::string _name, DataResource *_resource, Fieldm
 }
 
 
-ArrayDataSource:: ArrayDataSource( const string _name, DataResource *_resource, const string _location, int _rank ) :
+DataSource::DataSource( const DataSource &source, DataResource *_resource ) :
+    FieldmlObject( source ),
+    sourceType( source.sourceType ),
+    resource( _resource )
+{
+}
+
+
+ArrayDataSource:: ArrayDataSource( const InternedName &_name, DataResource *_resource, const string _location, int _rank ) :
     DataSource( _name, _resource, FML_DATA_SOURCE_ARRAY ),
     rank( _rank ),
     location( _location )
@@ -474,6 +599,35 @@ ArrayDataSource:: ArrayDataSource( const string _name, DataResource *_resource,
 }
 
 
+ArrayDataSource::ArrayDataSource( const ArrayDataSource &source, DataResource *_resource ) :
+    DataSource( source, _resource ),
+    location( source.location ),
+    rank( source.rank ),
+    offsets( source.offsets ),
+    sizes( source.sizes ),
+    rawSizes( source.rawSizes )
+{
+}
+
+
+FieldmlObject *ArrayDataSource::clone( ObjectArena &arena ) const
+{
+    return new( arena ) ArrayDataSource( *this );
+}
+
+
+DataSource *ArrayDataSource::cloneForResource( ObjectArena &arena, DataResource *_resource ) const
+{
+    return new( arena ) ArrayDataSource( *this, _resource );
+}
+
+
+size_t ArrayDataSource::getContentSize() const
+{
+    return FmlUtil::memoryUsage( offsets ) + FmlUtil::memoryUsage( sizes ) + FmlUtil::memoryUsage( rawSizes );
+}
+
+
 ArrayDataSource::~ ArrayDataSource()
 {
 }
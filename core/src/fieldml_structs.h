@@ -49,19 +49,43 @@
 #include "fieldml_api.h"
 #include "SimpleMap.h"
 #include "SimpleBitset.h"
+#include "ObjectArena.h"
+#include "StringTable.h"
 
-class FieldmlObject
+class FieldmlObject :
+    public ArenaObject
 {
 public:
     const FieldmlHandleType objectType;
-    const std::string name;
+    
+    //The object's name, interned in its session's string table.
+    const std::string &name;
+    const int nameId;
     
     //Virtual objects are either imports, or objects which are strict sub-objects (e.g. component ensembles, mesh element/chart arguments)/
     const bool isVirtual;
 
     int intValue;
     
-    FieldmlObject( const std::string _name, FieldmlHandleType _type, bool _isVirtual );
+    //The content size last added to the object store's memory usage figures.
+    size_t accountedSize;
+    
+    FieldmlObject( const InternedName &_name, FieldmlHandleType _type, bool _isVirtual );
+    
+    /**
+     * Creates a copy of this object, and of any sub-objects it owns, in the given arena.
+     */
+    virtual FieldmlObject *clone( ObjectArena &arena ) const = 0;
+    
+    /**
+     * The number of bytes allocated for the object's variable-sized contents, such as maps and lists.
+     */
+    virtual size_t getContentSize() const;
+    
+    /**
+     * The memory usage category that the object's contents are reported under.
+     */
+    virtual FieldmlMemoryCategory getContentCategory() const;
     
     virtual ~FieldmlObject();
 };
@@ -85,7 +109,9 @@ public:
     
     FmlObjectHandle dataSource;
     
-    EnsembleType( const std::string _name, bool _isComponentEnsemble, bool _isVirtual );
+    EnsembleType( const InternedName &_name, bool _isComponentEnsemble, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
 };
 
 
@@ -97,7 +123,13 @@ public:
 
     SimpleBitset members;
     
-    ElementSequence( const std::string _name, FmlObjectHandle _componentType );
+    ElementSequence( const InternedName &_name, FmlObjectHandle _componentType );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
+    
+    virtual FieldmlMemoryCategory getContentCategory() const;
 };
 
 
@@ -105,7 +137,9 @@ class BooleanType :
     public FieldmlObject
 {
 public:
-    BooleanType( const std::string _name, bool _isVirtual );
+    BooleanType( const InternedName &_name, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
 };
 
 
@@ -115,7 +149,9 @@ class ContinuousType :
 public:
     FmlObjectHandle componentType;
     
-    ContinuousType( const std::string _name, bool _isVirtual );
+    ContinuousType( const InternedName &_name, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
 };
 
 
@@ -127,7 +163,9 @@ public:
     FmlObjectHandle elementsType;
     FmlObjectHandle shapes;
     
-    MeshType( const std::string _name, bool _isVirtual );
+    MeshType( const InternedName &_name, bool _isVirtual );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
 };
 
 
@@ -145,7 +183,13 @@ public:
 
     std::vector<FmlObjectHandle> dataSources;
     
-    DataResource( const std::string _name, FieldmlDataResourceType _type, const std::string _format, const std::string _description );
+    DataResource( const InternedName &_name, FieldmlDataResourceType _type, const std::string _format, const std::string _description );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
+    
+    virtual FieldmlMemoryCategory getContentCategory() const;
         
     virtual ~DataResource();
 };
@@ -155,13 +199,21 @@ class DataSource :
     public FieldmlObject
 {
 protected:
-    DataSource( const std::string _name, DataResource *_resource, FieldmlDataSourceType _type );
+    DataSource( const InternedName &_name, DataResource *_resource, FieldmlDataSourceType _type );
+    
+    DataSource( const DataSource &source, DataResource *_resource );
     
 public:
     const FieldmlDataSourceType sourceType;
     
     DataResource * const resource;
     
+    /**
+     * Creates a copy of this data source that refers to the given resource instead, for use when the resource itself
+     * has been copied.
+     */
+    virtual DataSource *cloneForResource( ObjectArena &arena, DataResource *_resource ) const = 0;
+    
     virtual ~DataSource()
     {
     }
@@ -177,20 +229,29 @@ public:
     
     const int rank;
     
-    std::vector<int> offsets;
+    std::vector<int64_t> offsets;
     
-    std::vector<int> sizes;
+    std::vector<int64_t> sizes;
     
     //NOTE: Optional for formats that internally specify sizes.
-    std::vector<int> rawSizes;
+    std::vector<int64_t> rawSizes;
+    
+    ArrayDataSource( const InternedName &_name, DataResource *_resource, const std::string _location, int _rank );
+    
+    ArrayDataSource( const ArrayDataSource &source, DataResource *_resource );
+    
+    virtual FieldmlObject *clone( ObjectArena &arena ) const;
+    
+    virtual DataSource *cloneForResource( ObjectArena &arena, DataResource *_resource ) const;
     
-    ArrayDataSource( const std::string _name, DataResource *_resource, const std::string _location, int _rank );
+    virtual size_t getContentSize() const;
     
     virtual ~ArrayDataSource();
 };
 
 
-class BaseDataDescription
+class BaseDataDescription :
+    public ArenaObject
 {
 public:
     const FieldmlDataDescriptionType descriptionType;
@@ -210,6 +271,13 @@ public:
     virtual FmlErrorNumber getIndexOrder( int index, FmlObjectHandle &order ) = 0;
     
     virtual int getIndexCount( bool isSparse ) = 0;
+    
+    virtual BaseDataDescription *clone( ObjectArena &arena ) const = 0;
+    
+    /**
+     * The number of bytes allocated for the description's index lists.
+     */
+    virtual size_t getContentSize() const;
 
     virtual ~BaseDataDescription() = 0;
     
@@ -223,6 +291,8 @@ class UnknownDataDescription :
 {
 public:
     UnknownDataDescription();
+    
+    virtual BaseDataDescription *clone( ObjectArena &arena ) const;
 
     virtual void addDelegates( std::set<FmlObjectHandle> &delegates );
 
@@ -258,6 +328,10 @@ public:
     FmlObjectHandle dataSource;
     
     DenseArrayDataDescription();
+    
+    virtual BaseDataDescription *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
 
     virtual void addDelegates( std::set<FmlObjectHandle> &delegates );
 
@@ -292,6 +366,10 @@ public:
     FmlObjectHandle valueSource;
     
     DokArrayDataDescription();
+    
+    virtual BaseDataDescription *clone( ObjectArena &arena ) const;
+    
+    virtual size_t getContentSize() const;
 
     virtual void addDelegates( std::set<FmlObjectHandle> &delegates );
 
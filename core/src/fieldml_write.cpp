@@ -39,7 +39,9 @@
  *
  */
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include <libxml/encoding.h>
 #include <libxml/xmlwriter.h>
@@ -56,7 +58,7 @@ const char * MY_ENCODING = "ISO-8859-1";
 const int tBufferLength = 256;
 
 
-static void writeValues( xmlTextWriterPtr writer, const xmlChar *tag, int *values, int count, bool onlyIfNonzero = false )
+static void writeValues( xmlTextWriterPtr writer, const xmlChar *tag, int64_t *values, int count, bool onlyIfNonzero = false )
 {
     //NOTE: Raw sizes may not be set.
     bool doWrite = false;
@@ -78,11 +80,11 @@ static void writeValues( xmlTextWriterPtr writer, const xmlChar *tag, int *value
     {
         if( i > 0 )
         {
-            xmlTextWriterWriteFormatString( writer, " %d", values[i] );
+            xmlTextWriterWriteFormatString( writer, " %lld", (long long)values[i] );
         }
         else
         {
-            xmlTextWriterWriteFormatString( writer, "%d", values[i] );
+            xmlTextWriterWriteFormatString( writer, "%lld", (long long)values[i] );
         }
     }
     xmlTextWriterEndElement( writer );
@@ -91,7 +93,7 @@ static void writeValues( xmlTextWriterPtr writer, const xmlChar *tag, int *value
 
 static void writeObjectName( xmlTextWriterPtr writer, const xmlChar *attribute, FmlSessionHandle handle, FmlObjectHandle object )
 {
-    xmlTextWriterWriteAttribute( writer, attribute, (const xmlChar*)Fieldml_GetObjectName( handle, object ) );
+    xmlTextWriterWriteAttribute( writer, attribute, (const xmlChar*)Fieldml_PeekObjectName( handle, object ) );
 }
 
 
@@ -99,7 +101,7 @@ static void writeObjectName( xmlTextWriterPtr writer, const xmlChar *attribute,
 {
     parentName += ".";
     
-    string objectName = Fieldml_GetObjectName( handle, object );
+    string objectName = Fieldml_PeekObjectName( handle, object );
     
     if( objectName.compare( 0, parentName.length(), parentName ) == 0 )
     {
@@ -139,23 +141,29 @@ static int writeBinds( xmlTextWriterPtr writer, FmlSessionHandle handle, FmlObje
     if( indexArgument != FML_INVALID_HANDLE )
     {
         xmlTextWriterStartElement( writer, BIND_INDEX_TAG );
-        xmlTextWriterWriteAttribute( writer, ARGUMENT_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, indexArgument ) );
+        xmlTextWriterWriteAttribute( writer, ARGUMENT_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, indexArgument ) );
         xmlTextWriterWriteAttribute( writer, INDEX_NUMBER_ATTRIB, (const xmlChar*)"1" );
         xmlTextWriterEndElement( writer );
     }
     
-    for( int i = 1; i <= count; i++ )
+    vector<FmlObjectHandle> arguments( max( count, 0 ) ), sources( max( count, 0 ) );
+    if( count > 0 )
+    {
+        Fieldml_GetBinds( handle, object, &arguments[0], &sources[0], count );
+    }
+    
+    for( int i = 0; i < count; i++ )
     {
-        FmlObjectHandle source = Fieldml_GetBindEvaluator( handle, object, i );
-        FmlObjectHandle argument =  Fieldml_GetBindArgument( handle, object, i );
+        FmlObjectHandle source = sources[i];
+        FmlObjectHandle argument = arguments[i];
         if( ( source == FML_INVALID_HANDLE ) || ( argument == FML_INVALID_HANDLE ) )
         {
             continue;
         }
 
         xmlTextWriterStartElement( writer, BIND_TAG );
-        xmlTextWriterWriteAttribute( writer, ARGUMENT_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, argument ) );
-        xmlTextWriterWriteAttribute( writer, SOURCE_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, source ) );
+        xmlTextWriterWriteAttribute( writer, ARGUMENT_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, argument ) );
+        xmlTextWriterWriteAttribute( writer, SOURCE_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, source ) );
         xmlTextWriterEndElement( writer );
     }
     
@@ -173,18 +181,21 @@ static int writeArguments( xmlTextWriterPtr writer, FmlSessionHandle handle, Fml
         return 0;
     }
 
+    vector<FmlObjectHandle> arguments( count );
+    count = min( count, Fieldml_GetArguments( handle, object, 1, 1, &arguments[0], count ) );
+
     xmlTextWriterStartElement( writer, ARGUMENTS_TAG );
     
-    for( int i = 1; i <= count; i++ )
+    for( int i = 0; i < count; i++ )
     {
-        FmlObjectHandle argument = Fieldml_GetArgument( handle, object, i, 1, 1 );
+        FmlObjectHandle argument = arguments[i];
         if( argument == FML_INVALID_HANDLE )
         {
             continue;
         }
 
         xmlTextWriterStartElement( writer, ARGUMENT_TAG );
-        xmlTextWriterWriteAttribute( writer, NAME_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, argument ) );
+        xmlTextWriterWriteAttribute( writer, NAME_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, argument ) );
         xmlTextWriterEndElement( writer );
     }
     
@@ -309,13 +320,13 @@ static int writeMeshType( xmlTextWriterPtr writer, FmlSessionHandle handle, FmlO
     FmlObjectHandle elementsType = Fieldml_GetMeshElementsType( handle, object );
     if( elementsType != FML_INVALID_HANDLE )
     {
-        writeEnsembleType( writer, handle, elementsType, ELEMENTS_TAG, Fieldml_GetObjectName( handle, object ) );
+        writeEnsembleType( writer, handle, elementsType, ELEMENTS_TAG, Fieldml_PeekObjectName( handle, object ) );
     }
 
     FmlObjectHandle chartType = Fieldml_GetMeshChartType( handle, object );
     if( chartType != FML_INVALID_HANDLE )
     {
-        writeContinuousType( writer, handle, chartType, CHART_TAG, Fieldml_GetObjectName( handle, object ) );
+        writeContinuousType( writer, handle, chartType, CHART_TAG, Fieldml_PeekObjectName( handle, object ) );
     }
     
     xmlTextWriterStartElement( writer, SHAPES_TAG );
@@ -343,29 +354,28 @@ static int writeDataSource( xmlTextWriterPtr writer, FmlSessionHandle handle, Fm
         
         writeObjectName( writer, NAME_ATTRIB, handle, object );
 
-        char *location = Fieldml_GetArrayDataSourceLocation( handle, object );
+        const char *location = Fieldml_PeekArrayDataSourceLocation( handle, object );
         int rank = Fieldml_GetArrayDataSourceRank( handle, object );
         
         xmlTextWriterWriteFormatAttribute( writer, LOCATION_ATTRIB, "%s", location );
         xmlTextWriterWriteFormatAttribute( writer, RANK_ATTRIB, "%d", rank );
         
-        int *values = new int[rank];
+        int64_t *values = new int64_t[rank];
         
-        if( Fieldml_GetArrayDataSourceRawSizes( handle, object, values ) == FML_ERR_NO_ERROR )
+        if( Fieldml_GetArrayDataSourceRawSizes64( handle, object, values ) == FML_ERR_NO_ERROR )
         {
             writeValues( writer, RAW_ARRAY_SIZE_TAG, values, rank, true );
         }
         
-        if( Fieldml_GetArrayDataSourceOffsets( handle, object, values ) == FML_ERR_NO_ERROR )
+        if( Fieldml_GetArrayDataSourceOffsets64( handle, object, values ) == FML_ERR_NO_ERROR )
         {
             writeValues( writer, ARRAY_DATA_OFFSET_TAG, values, rank, true );
         }
         
-        if( Fieldml_GetArrayDataSourceSizes( handle, object, values ) == FML_ERR_NO_ERROR )
+        if( Fieldml_GetArrayDataSourceSizes64( handle, object, values ) == FML_ERR_NO_ERROR )
         {
             writeValues( writer, ARRAY_DATA_SIZE_TAG, values, rank, true );
         }
-        Fieldml_FreeString(location);
         delete[] values;
         
         xmlTextWriterEndElement( writer );
@@ -377,8 +387,6 @@ static int writeDataSource( xmlTextWriterPtr writer, FmlSessionHandle handle, Fm
 
 static int writeDataResource( xmlTextWriterPtr writer, FmlSessionHandle handle, FmlObjectHandle object )
 {
-    char tBuffer[tBufferLength];
-
     xmlTextWriterStartElement( writer, DATA_RESOURCE_TAG );
 
     writeObjectName( writer, NAME_ATTRIB, handle, object );
@@ -389,30 +397,21 @@ static int writeDataResource( xmlTextWriterPtr writer, FmlSessionHandle handle,
 
     if( type == FML_DATA_RESOURCE_HREF )
     {
-				char *href = Fieldml_GetDataResourceHref( handle, object );
-				char *resourceFormat = Fieldml_GetDataResourceFormat( handle, object );
+        const char *href = Fieldml_PeekDataResourceHref( handle, object );
+        const char *resourceFormat = Fieldml_PeekDataResourceFormat( handle, object );
         xmlTextWriterStartElement( writer, DATA_RESOURCE_HREF_TAG );
         xmlTextWriterWriteAttribute( writer, QUALIFIED_HREF_ATTRIB, (const xmlChar*)href );
         xmlTextWriterWriteAttribute( writer, FORMAT_ATTRIB, (const xmlChar*)resourceFormat );
         xmlTextWriterEndElement( writer );
-        Fieldml_FreeString(href);
-        Fieldml_FreeString(resourceFormat);
     }
     else if( type == FML_DATA_RESOURCE_INLINE )
     {
         xmlTextWriterStartElement( writer, DATA_RESOURCE_STRING_TAG );
 
-        int offset = 0;
-        int length = 1;
-        
-        while( length > 0 )
+        const char *inlineData = Fieldml_PeekInlineData( handle, object );
+        if( ( inlineData != NULL ) && ( Fieldml_GetInlineDataLength( handle, object ) > 0 ) )
         {
-            length = Fieldml_CopyInlineData( handle, object, tBuffer, tBufferLength - 1, offset );
-            if( length > 0 )
-            {
-                xmlTextWriterWriteFormatString( writer, "%s", tBuffer );
-                offset += length;
-            }
+            xmlTextWriterWriteString( writer, (const xmlChar*)inlineData );
         }
         
         xmlTextWriterEndElement( writer );
@@ -492,7 +491,7 @@ static int writeConstantEvaluator( xmlTextWriterPtr writer, FmlSessionHandle han
     xmlTextWriterStartElement( writer, CONSTANT_EVALUATOR_TAG );
     
     writeObjectName( writer, NAME_ATTRIB, handle, object );
-    xmlTextWriterWriteFormatAttribute( writer, VALUE_ATTRIB, "%s", Fieldml_GetConstantEvaluatorValueString( handle, object ) );
+    xmlTextWriterWriteFormatAttribute( writer, VALUE_ATTRIB, "%s", Fieldml_PeekConstantEvaluatorValueString( handle, object ) );
     writeObjectName( writer, VALUE_TYPE_ATTRIB, handle, Fieldml_GetValueType( handle, object ) );
 
     xmlTextWriterEndElement( writer );
@@ -517,7 +516,7 @@ static int writePiecewiseEvaluator( xmlTextWriterPtr writer, FmlSessionHandle ha
     {
         xmlTextWriterStartElement( writer, INDEX_EVALUATOR_TAG );
 
-        xmlTextWriterWriteFormatAttribute( writer, EVALUATOR_ATTRIB, "%s", Fieldml_GetObjectName( handle, indexEvaluator ) );
+        xmlTextWriterWriteFormatAttribute( writer, EVALUATOR_ATTRIB, "%s", Fieldml_PeekObjectName( handle, indexEvaluator ) );
         xmlTextWriterWriteFormatAttribute( writer, INDEX_NUMBER_ATTRIB, "%d", 1 );
 
         xmlTextWriterEndElement( writer );
@@ -533,18 +532,25 @@ static int writePiecewiseEvaluator( xmlTextWriterPtr writer, FmlSessionHandle ha
         
         if( defaultEvaluator != FML_INVALID_HANDLE )
         {
-            xmlTextWriterWriteFormatAttribute( writer, DEFAULT_ATTRIB, "%s", Fieldml_GetObjectName( handle, defaultEvaluator ) );
+            xmlTextWriterWriteFormatAttribute( writer, DEFAULT_ATTRIB, "%s", Fieldml_PeekObjectName( handle, defaultEvaluator ) );
         }
     
-        for( int i = 1; i <= count; i++ )
+        vector<FmlEnsembleValue> elements( max( count, 0 ) );
+        vector<FmlObjectHandle> evaluators( max( count, 0 ) );
+        if( count > 0 )
+        {
+            Fieldml_GetEvaluators( handle, object, &elements[0], &evaluators[0], count );
+        }
+        
+        for( int i = 0; i < count; i++ )
         {
-            FmlEnsembleValue element = Fieldml_GetEvaluatorElement( handle, object, i );
-            FmlObjectHandle evaluator = Fieldml_GetEvaluator( handle, object, i );
+            FmlEnsembleValue element = elements[i];
+            FmlObjectHandle evaluator = evaluators[i];
             if( ( element <= 0 ) || ( evaluator == FML_INVALID_HANDLE ) )
             {
                 continue;
             }
-            writeComponentEvaluator( writer, EVALUATOR_MAP_ENTRY_TAG, VALUE_ATTRIB, element, Fieldml_GetObjectName( handle, evaluator ) );
+            writeComponentEvaluator( writer, EVALUATOR_MAP_ENTRY_TAG, VALUE_ATTRIB, element, Fieldml_PeekObjectName( handle, evaluator ) );
         }
 
         xmlTextWriterEndElement( writer );
@@ -579,12 +585,12 @@ static void writeParameterIndexes( xmlTextWriterPtr writer, FmlSessionHandle han
                 continue;
             }
             xmlTextWriterStartElement( writer, INDEX_EVALUATOR_TAG );
-            xmlTextWriterWriteAttribute( writer, EVALUATOR_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, index ) );
+            xmlTextWriterWriteAttribute( writer, EVALUATOR_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, index ) );
 
             FmlObjectHandle order = Fieldml_GetParameterIndexOrder( handle, object, i );
             if( order != FML_INVALID_HANDLE )
             {
-                xmlTextWriterWriteAttribute( writer, ORDER_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, order ) );
+                xmlTextWriterWriteAttribute( writer, ORDER_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, order ) );
             }
 
             xmlTextWriterEndElement( writer );
@@ -600,7 +606,7 @@ static void writeDenseArrayData( xmlTextWriterPtr writer, FmlSessionHandle handl
     xmlTextWriterStartElement( writer, DENSE_ARRAY_DATA_TAG );
     
     FmlObjectHandle dataObject = Fieldml_GetDataSource( handle, object );
-    xmlTextWriterWriteAttribute( writer, DATA_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, dataObject ) );
+    xmlTextWriterWriteAttribute( writer, DATA_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, dataObject ) );
     
     writeParameterIndexes( writer, handle, object, 0 );
 
@@ -614,8 +620,8 @@ static void writeDOKArrayData( xmlTextWriterPtr writer, FmlSessionHandle handle,
     
     FmlObjectHandle dataObject = Fieldml_GetDataSource( handle, object );
     FmlObjectHandle keyDataObject = Fieldml_GetKeyDataSource( handle, object );
-    xmlTextWriterWriteAttribute( writer,KEY_DATA_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, keyDataObject ) );
-    xmlTextWriterWriteAttribute( writer, VALUE_DATA_ATTRIB, (const xmlChar*)Fieldml_GetObjectName( handle, dataObject ) );
+    xmlTextWriterWriteAttribute( writer,KEY_DATA_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, keyDataObject ) );
+    xmlTextWriterWriteAttribute( writer, VALUE_DATA_ATTRIB, (const xmlChar*)Fieldml_PeekObjectName( handle, dataObject ) );
     
     writeParameterIndexes( writer, handle, object, 1 );
     writeParameterIndexes( writer, handle, object, 0 );
@@ -669,18 +675,25 @@ static int writeAggregateEvaluator( xmlTextWriterPtr writer, FmlSessionHandle ha
         
         if( defaultEvaluator != FML_INVALID_HANDLE )
         {
-            xmlTextWriterWriteFormatAttribute( writer, DEFAULT_ATTRIB, "%s", Fieldml_GetObjectName( handle, defaultEvaluator ) );
+            xmlTextWriterWriteFormatAttribute( writer, DEFAULT_ATTRIB, "%s", Fieldml_PeekObjectName( handle, defaultEvaluator ) );
         }
     
-        for( int i = 1; i <= count; i++ )
+        vector<FmlEnsembleValue> elements( max( count, 0 ) );
+        vector<FmlObjectHandle> evaluators( max( count, 0 ) );
+        if( count > 0 )
+        {
+            Fieldml_GetEvaluators( handle, object, &elements[0], &evaluators[0], count );
+        }
+        
+        for( int i = 0; i < count; i++ )
         {
-            FmlEnsembleValue element = Fieldml_GetEvaluatorElement( handle, object, i );
-            FmlObjectHandle evaluator = Fieldml_GetEvaluator( handle, object, i );
+            FmlEnsembleValue element = elements[i];
+            FmlObjectHandle evaluator = evaluators[i];
             if( ( element <= 0 ) || ( evaluator == FML_INVALID_HANDLE ) )
             {
                 continue;
             }
-            writeComponentEvaluator( writer, COMPONENT_EVALUATOR_TAG, COMPONENT_ATTRIB, element, Fieldml_GetObjectName( handle, evaluator ) );
+            writeComponentEvaluator( writer, COMPONENT_EVALUATOR_TAG, COMPONENT_ATTRIB, element, Fieldml_PeekObjectName( handle, evaluator ) );
         }
 
         xmlTextWriterEndElement( writer );
@@ -753,7 +766,7 @@ int writeFieldmlFile( FieldmlErrorHandler *errorHandler, FmlSessionHandle handle
     xmlTextWriterWriteAttribute( writer, (const xmlChar*)"xmlns:xlink", XLINK_NAMESPACE_STRING );
     xmlTextWriterStartElement( writer, REGION_TAG );
     
-    const char *regionName = Fieldml_GetRegionName( handle );
+    const char *regionName = Fieldml_PeekRegionName( handle );
     if( ( regionName != NULL ) && ( strlen( regionName ) > 0 ) ) 
     {
         xmlTextWriterWriteAttribute( writer, NAME_ATTRIB, (const xmlChar*)regionName );        
@@ -208,6 +208,17 @@ const string makeFilename( const string dir, const string file )
         return file;
     }
 
+    if( ( file[0] == NIX_PATH_SEP ) || ( file.find( "://" ) != string::npos ) )
+    {
+        return file;
+    }
+#ifdef WIN32
+    if( ( file[0] == WIN_PATH_SEP ) || ( ( file.length() > 1 ) && ( file[1] == ':' ) ) )
+    {
+        return file;
+    }
+#endif
+
     if( dir.length() > 0 )
     {
         return dir + DEFAULT_SEP + file;
@@ -52,12 +52,17 @@ protected:
     ArrayDataReader( FieldmlIoContext *_context );
     
 public:
-    virtual FmlIoErrorNumber readIntSlab( const int *offsets, const int *sizes, int *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber readIntSlab( const int64_t *offsets, const int64_t *sizes, int *valueBuffer ) = 0;
     
-    virtual FmlIoErrorNumber readDoubleSlab( const int *offsets, const int *sizes, double *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber readDoubleSlab( const int64_t *offsets, const int64_t *sizes, double *valueBuffer ) = 0;
     
     //TODO Provide options for reading into 32/64 bit packed boolean arrays?
-    virtual FmlIoErrorNumber readBooleanSlab( const int *offsets, const int *sizes, FmlBoolean *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber readBooleanSlab( const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer ) = 0;
+    
+    /**
+     * \return The rank of the array being read, and therefore the number of offsets and sizes each slab read takes.
+     */
+    virtual int getRank() = 0;
     
     virtual FmlIoErrorNumber close() = 0;
     
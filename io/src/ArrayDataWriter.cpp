@@ -46,12 +46,12 @@
 
 using namespace std;
 
-ArrayDataWriter *ArrayDataWriter::create( FieldmlIoContext *context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank )
+ArrayDataWriter *ArrayDataWriter::create( FieldmlIoContext *context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank )
 {
     ArrayDataWriter *writer = NULL;
     
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
-    char *temp_string = Fieldml_GetDataResourceFormat( context->getSession(), resource );
+    const char *temp_string = Fieldml_PeekDataResourceFormat( context->getSession(), resource );
     string format;
     
     if( !StringUtil::safeString( temp_string, format ) )
@@ -78,7 +78,6 @@ ArrayDataWriter *ArrayDataWriter::create( FieldmlIoContext *context, const strin
     {
         context->setError( FML_IOERR_UNSUPPORTED );
     }
-    Fieldml_FreeString(temp_string);
     
     return writer;
 }
@@ -53,18 +53,23 @@ protected:
 
     ArrayDataWriter( FieldmlIoContext *_context );
 public:
-    virtual FmlIoErrorNumber writeIntSlab( const int *offsets, const int *sizes, const int *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber writeIntSlab( const int64_t *offsets, const int64_t *sizes, const int *valueBuffer ) = 0;
     
-    virtual FmlIoErrorNumber writeDoubleSlab( const int *offsets, const int *sizes, const double *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber writeDoubleSlab( const int64_t *offsets, const int64_t *sizes, const double *valueBuffer ) = 0;
     
     //TODO Provide options for writing from 32/64 bit packed boolean arrays?
-    virtual FmlIoErrorNumber writeBooleanSlab( const int *offsets, const int *sizes, const FmlBoolean *valueBuffer ) = 0;
+    virtual FmlIoErrorNumber writeBooleanSlab( const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer ) = 0;
+    
+    /**
+     * \return The rank of the array being written, and therefore the number of offsets and sizes each slab write takes.
+     */
+    virtual int getRank() = 0;
     
     virtual FmlIoErrorNumber close() = 0;
     
     virtual ~ArrayDataWriter();
     
-    static ArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank );
+    static ArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank );
 };
 
 
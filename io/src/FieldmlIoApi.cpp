@@ -40,6 +40,7 @@
  */
 
 #include <cstring>
+#include <vector>
 
 #include "StringUtil.h"
 #include "fieldml_api.h"
@@ -85,7 +86,7 @@ FmlReaderHandle Fieldml_OpenReader( FmlSessionHandle handle, FmlObjectHandle obj
     if( Fieldml_GetDataSourceType( handle, objectHandle ) == FML_DATA_SOURCE_ARRAY )
     {
         string root;
-        char *region_string = Fieldml_GetRegionRoot( handle );
+        const char *region_string = Fieldml_PeekRegionRoot( handle );
         if( !StringUtil::safeString( region_string, root ) )
         {
             FieldmlIoSession::getSession().setError( FML_IOERR_CORE_ERROR );
@@ -94,7 +95,6 @@ FmlReaderHandle Fieldml_OpenReader( FmlSessionHandle handle, FmlObjectHandle obj
         {
             reader = ArrayDataReader::create( FieldmlIoSession::getSession().createContext( handle ), root, objectHandle );
         }
-        Fieldml_FreeString(region_string);
     }
     else
     {
@@ -119,6 +119,22 @@ FmlIoErrorNumber Fieldml_ReadIntSlab( FmlReaderHandle readerHandle, const int *o
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = reader->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return reader->readIntSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_ReadIntSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, int *valueBuffer )
+{
+    ArrayDataReader *reader = FieldmlIoSession::getSession().handleToReader( readerHandle );
+    if( reader == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return reader->readIntSlab( offsets, sizes, valueBuffer );
 }
 
@@ -131,6 +147,22 @@ FmlIoErrorNumber Fieldml_ReadDoubleSlab( FmlReaderHandle readerHandle, const int
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = reader->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return reader->readDoubleSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_ReadDoubleSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, double *valueBuffer )
+{
+    ArrayDataReader *reader = FieldmlIoSession::getSession().handleToReader( readerHandle );
+    if( reader == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return reader->readDoubleSlab( offsets, sizes, valueBuffer );
 }
 
@@ -143,6 +175,22 @@ FmlIoErrorNumber Fieldml_ReadBooleanSlab( FmlReaderHandle readerHandle, const in
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = reader->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return reader->readBooleanSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_ReadBooleanSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer )
+{
+    ArrayDataReader *reader = FieldmlIoSession::getSession().handleToReader( readerHandle );
+    if( reader == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return reader->readBooleanSlab( offsets, sizes, valueBuffer );
 }
 
@@ -166,6 +214,18 @@ FmlIoErrorNumber Fieldml_CloseReader( FmlReaderHandle readerHandle )
 
 
 FmlWriterHandle Fieldml_OpenArrayWriter( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle typeHandle, FmlBoolean append, int *sizes, int rank )
+{
+    vector<int64_t> wideSizes;
+    if( rank > 0 )
+    {
+        wideSizes.assign( sizes, sizes + rank );
+    }
+    
+    return Fieldml_OpenArrayWriter64( handle, objectHandle, typeHandle, append, wideSizes.empty() ? NULL : &wideSizes[0], rank );
+}
+
+
+FmlWriterHandle Fieldml_OpenArrayWriter64( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle typeHandle, FmlBoolean append, const int64_t *sizes, int rank )
 {
     if( Fieldml_IsObjectLocal( handle, objectHandle, 0 ) != 1 )
     {
@@ -209,7 +269,7 @@ FmlWriterHandle Fieldml_OpenArrayWriter( FmlSessionHandle handle, FmlObjectHandl
     {
         FieldmlIoContext *context = FieldmlIoSession::getSession().createContext( handle );
         string root;
-        if( !StringUtil::safeString( Fieldml_GetRegionRoot( handle ), root ) )
+        if( !StringUtil::safeString( Fieldml_PeekRegionRoot( handle ), root ) )
         {
             FieldmlIoSession::getSession().setError( FML_IOERR_CORE_ERROR );
         }
@@ -237,6 +297,22 @@ FmlIoErrorNumber Fieldml_WriteIntSlab( FmlWriterHandle writerHandle, const int *
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = writer->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return writer->writeIntSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_WriteIntSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const int *valueBuffer )
+{
+    ArrayDataWriter *writer = FieldmlIoSession::getSession().handleToWriter( writerHandle );
+    if( writer == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return writer->writeIntSlab( offsets, sizes, valueBuffer );
 }
 
@@ -249,6 +325,22 @@ FmlIoErrorNumber Fieldml_WriteDoubleSlab( FmlWriterHandle writerHandle, const in
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = writer->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return writer->writeDoubleSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_WriteDoubleSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const double *valueBuffer )
+{
+    ArrayDataWriter *writer = FieldmlIoSession::getSession().handleToWriter( writerHandle );
+    if( writer == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return writer->writeDoubleSlab( offsets, sizes, valueBuffer );
 }
 
@@ -261,6 +353,22 @@ FmlIoErrorNumber Fieldml_WriteBooleanSlab( FmlWriterHandle writerHandle, const i
         return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
     }
 
+    const int rank = writer->getRank();
+    vector<int64_t> wideOffsets( offsets, offsets + rank );
+    vector<int64_t> wideSizes( sizes, sizes + rank );
+
+    return writer->writeBooleanSlab( &wideOffsets[0], &wideSizes[0], valueBuffer );
+}
+
+
+FmlIoErrorNumber Fieldml_WriteBooleanSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer )
+{
+    ArrayDataWriter *writer = FieldmlIoSession::getSession().handleToWriter( writerHandle );
+    if( writer == NULL )
+    {
+        return FieldmlIoSession::getSession().setError( FML_IOERR_UNKNOWN_OBJECT );
+    }
+
     return writer->writeBooleanSlab( offsets, sizes, valueBuffer );
 }
 
@@ -132,6 +132,14 @@ FmlReaderHandle Fieldml_OpenReader( FmlSessionHandle handle, FmlObjectHandle obj
 FmlIoErrorNumber Fieldml_ReadIntSlab( FmlReaderHandle readerHandle, const int *offsets, const int *sizes, int *valueBuffer );
 
 
+/**
+ * 64-bit variant of Fieldml_ReadIntSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_ReadIntSlab
+ */
+FmlIoErrorNumber Fieldml_ReadIntSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, int *valueBuffer );
+
+
 /**
  * Reads data from the multi-dimensional array specified by the given offsets and sizes into the given buffer. The first
  * size/offset is applied to the outermost index, and so on.
@@ -139,6 +147,14 @@ FmlIoErrorNumber Fieldml_ReadIntSlab( FmlReaderHandle readerHandle, const int *o
 FmlIoErrorNumber Fieldml_ReadDoubleSlab( FmlReaderHandle readerHandle, const int *offsets, const int *sizes, double *valueBuffer );
 
 
+/**
+ * 64-bit variant of Fieldml_ReadDoubleSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_ReadDoubleSlab
+ */
+FmlIoErrorNumber Fieldml_ReadDoubleSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, double *valueBuffer );
+
+
 /**
  * Reads data from the multi-dimensional array specified by the given offsets and sizes into the given buffer. The first
  * size/offset is applied to the outermost index, and so on.
@@ -146,6 +162,14 @@ FmlIoErrorNumber Fieldml_ReadDoubleSlab( FmlReaderHandle readerHandle, const int
 FmlIoErrorNumber Fieldml_ReadBooleanSlab( FmlReaderHandle readerHandle, const int *offsets, const int *sizes, FmlBoolean *valueBuffer );
 
 
+/**
+ * 64-bit variant of Fieldml_ReadBooleanSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_ReadBooleanSlab
+ */
+FmlIoErrorNumber Fieldml_ReadBooleanSlab64( FmlReaderHandle readerHandle, const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer );
+
+
 /**
  * Closes the given data reader. The reader's handle should not be used after this call.
  * 
@@ -164,6 +188,14 @@ FmlIoErrorNumber Fieldml_CloseReader( FmlReaderHandle readerHandle );
  */
 FmlWriterHandle Fieldml_OpenArrayWriter( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle typeHandle, FmlBoolean append, int *sizes, int rank );
 
+
+/**
+ * 64-bit variant of Fieldml_OpenArrayWriter, for arrays whose sizes do not fit into an int.
+ * 
+ * \see Fieldml_OpenArrayWriter
+ */
+FmlWriterHandle Fieldml_OpenArrayWriter64( FmlSessionHandle handle, FmlObjectHandle objectHandle, FmlObjectHandle typeHandle, FmlBoolean append, const int64_t *sizes, int rank );
+
 /**
  * Write out some integer values to the given data writer. The data will be interpreted as an n-dimensional array of
  * the given size, and written out at the given offset. The first
@@ -175,6 +207,14 @@ FmlWriterHandle Fieldml_OpenArrayWriter( FmlSessionHandle handle, FmlObjectHandl
  */
 FmlIoErrorNumber Fieldml_WriteIntSlab( FmlWriterHandle writerHandle, const int *offsets, const int *sizes, const int *valueBuffer );
 
+
+/**
+ * 64-bit variant of Fieldml_WriteIntSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_WriteIntSlab
+ */
+FmlIoErrorNumber Fieldml_WriteIntSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const int *valueBuffer );
+
 /**
  * Write out some double-precision values to the given data writer. The data will be interpreted as an n-dimensional array of
  * the given size, and written out at the given offset. The first
@@ -187,6 +227,14 @@ FmlIoErrorNumber Fieldml_WriteIntSlab( FmlWriterHandle writerHandle, const int *
 FmlIoErrorNumber Fieldml_WriteDoubleSlab( FmlWriterHandle writerHandle, const int *offsets, const int *sizes, const double *valueBuffer );
 
 
+/**
+ * 64-bit variant of Fieldml_WriteDoubleSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_WriteDoubleSlab
+ */
+FmlIoErrorNumber Fieldml_WriteDoubleSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const double *valueBuffer );
+
+
 /**
  * Write out some boolean values to the given data writer. The data will be interpreted as an n-dimensional array of
  * the given size, and written out at the given offset. The first
@@ -199,6 +247,14 @@ FmlIoErrorNumber Fieldml_WriteDoubleSlab( FmlWriterHandle writerHandle, const in
 FmlIoErrorNumber Fieldml_WriteBooleanSlab( FmlWriterHandle writerHandle, const int *offsets, const int *sizes, const FmlBoolean *valueBuffer );
 
 
+/**
+ * 64-bit variant of Fieldml_WriteBooleanSlab, for arrays whose offsets or sizes do not fit into an int.
+ * 
+ * \see Fieldml_WriteBooleanSlab
+ */
+FmlIoErrorNumber Fieldml_WriteBooleanSlab64( FmlWriterHandle writerHandle, const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer );
+
+
 /**
  * Closes the given data writer. The writer's handle cannot be used after this call.
  * 
@@ -53,7 +53,7 @@ Hdf5ArrayDataReader *Hdf5ArrayDataReader::create( FieldmlIoContext *context, con
     Hdf5ArrayDataReader *reader = NULL;
 
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
-    char *temp_string = Fieldml_GetDataResourceFormat( context->getSession(), resource );
+    const char *temp_string = Fieldml_PeekDataResourceFormat( context->getSession(), resource );
     string format;
 
     if( !StringUtil::safeString( temp_string, format ) )
@@ -93,7 +93,6 @@ Hdf5ArrayDataReader *Hdf5ArrayDataReader::create( FieldmlIoContext *context, con
         H5Pclose( accessProperties );
 #endif //FIELDML_PHDF5_ARRAY
     }
-    Fieldml_FreeString(temp_string);
     
     return reader;
 }
@@ -116,20 +115,18 @@ Hdf5ArrayDataReader::Hdf5ArrayDataReader( FieldmlIoContext *_context, const stri
         FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
 
         string description;
-        char *temp_href = Fieldml_GetDataResourceHref( context->getSession(), resource );
+        const char *temp_href = Fieldml_PeekDataResourceHref( context->getSession(), resource );
         if( !StringUtil::safeString( temp_href, description ) )
         {
             break;
         }
-        Fieldml_FreeString(temp_href);
 
         string location;
-        char *temp_string = Fieldml_GetArrayDataSourceLocation( context->getSession(), source );
+        const char *temp_string = Fieldml_PeekArrayDataSourceLocation( context->getSession(), source );
         if( !StringUtil::safeString( temp_string, location ) )
         {
             break;
         }
-        Fieldml_FreeString(temp_string);
 
         const string filename = StringUtil::makeFilename( root, description );
 
@@ -192,7 +189,7 @@ Hdf5ArrayDataReader::Hdf5ArrayDataReader( FieldmlIoContext *_context, const stri
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataReader::readSlab( const int *offsets, const int *sizes, hid_t requiredDatatype, void *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataReader::readSlab( const int64_t *offsets, const int64_t *sizes, hid_t requiredDatatype, void *valueBuffer )
 {
     if( datatype != requiredDatatype )
     {
@@ -233,7 +230,7 @@ FmlIoErrorNumber Hdf5ArrayDataReader::readSlab( const int *offsets, const int *s
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataReader::readIntSlab( const int *offsets, const int *sizes, int *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataReader::readIntSlab( const int64_t *offsets, const int64_t *sizes, int *valueBuffer )
 {
     if( closed )
     {
@@ -244,7 +241,7 @@ FmlIoErrorNumber Hdf5ArrayDataReader::readIntSlab( const int *offsets, const int
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataReader::readDoubleSlab( const int *offsets, const int *sizes, double *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataReader::readDoubleSlab( const int64_t *offsets, const int64_t *sizes, double *valueBuffer )
 {
     if( closed )
     {
@@ -255,7 +252,7 @@ FmlIoErrorNumber Hdf5ArrayDataReader::readDoubleSlab( const int *offsets, const
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataReader::readBooleanSlab( const int *offsets, const int *sizes, FmlBoolean *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataReader::readBooleanSlab( const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer )
 {
     if( closed )
     {
@@ -266,6 +263,12 @@ FmlIoErrorNumber Hdf5ArrayDataReader::readBooleanSlab( const int *offsets, const
 }
 
 
+int Hdf5ArrayDataReader::getRank()
+{
+    return rank;
+}
+
+
 FmlIoErrorNumber Hdf5ArrayDataReader::close()
 {
     if( closed )
@@ -66,16 +66,18 @@ private:
     
     Hdf5ArrayDataReader( FieldmlIoContext *_context, const std::string root, FmlObjectHandle source, hid_t fileAccessProperties );
 
-    FmlIoErrorNumber readSlab( const int *offsets, const int *sizes, hid_t requiredDatatype, void *valueBuffer );
+    FmlIoErrorNumber readSlab( const int64_t *offsets, const int64_t *sizes, hid_t requiredDatatype, void *valueBuffer );
     
 public:
     bool ok;
 
-    virtual FmlIoErrorNumber readIntSlab( const int *offsets, const int *sizes, int *valueBuffer );
+    virtual FmlIoErrorNumber readIntSlab( const int64_t *offsets, const int64_t *sizes, int *valueBuffer );
     
-    virtual FmlIoErrorNumber readDoubleSlab( const int *offsets, const int *sizes, double *valueBuffer );
+    virtual FmlIoErrorNumber readDoubleSlab( const int64_t *offsets, const int64_t *sizes, double *valueBuffer );
     
-    virtual FmlIoErrorNumber readBooleanSlab( const int *offsets, const int *sizes, FmlBoolean *valueBuffer );
+    virtual FmlIoErrorNumber readBooleanSlab( const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer );
+    
+    virtual int getRank();
     
     virtual FmlIoErrorNumber close();
     
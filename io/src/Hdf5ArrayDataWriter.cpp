@@ -49,12 +49,12 @@ using namespace std;
 
 #if defined FIELDML_HDF5_ARRAY || defined FIELDML_PHDF5_ARRAY
 
-Hdf5ArrayDataWriter *Hdf5ArrayDataWriter::create( FieldmlIoContext *context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank )
+Hdf5ArrayDataWriter *Hdf5ArrayDataWriter::create( FieldmlIoContext *context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank )
 {
     Hdf5ArrayDataWriter *writer = NULL;
     
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
-    char *temp_string = Fieldml_GetDataResourceFormat( context->getSession(), resource );
+    const char *temp_string = Fieldml_PeekDataResourceFormat( context->getSession(), resource );
     string format;
 
     if( !StringUtil::safeString( temp_string, format ) )
@@ -94,13 +94,12 @@ Hdf5ArrayDataWriter *Hdf5ArrayDataWriter::create( FieldmlIoContext *context, con
         H5Pclose( accessProperties );
 #endif //FIELDML_PHDF5_ARRAY
     }
-    Fieldml_FreeString(temp_string);
     
     return writer;
 }
 
 
-Hdf5ArrayDataWriter::Hdf5ArrayDataWriter( FieldmlIoContext *_context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int _rank, hid_t accessProperties ) :
+Hdf5ArrayDataWriter::Hdf5ArrayDataWriter( FieldmlIoContext *_context, const string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int _rank, hid_t accessProperties ) :
     ArrayDataWriter( _context )
 {
     rank = _rank;
@@ -120,20 +119,18 @@ Hdf5ArrayDataWriter::Hdf5ArrayDataWriter( FieldmlIoContext *_context, const stri
     while( true )
     {
         string description;
-        char *temp_href = Fieldml_GetDataResourceHref( context->getSession(), resource );
-        if( !StringUtil::safeString( Fieldml_GetDataResourceHref( context->getSession(), resource ), description ) )
+        const char *temp_href = Fieldml_PeekDataResourceHref( context->getSession(), resource );
+        if( !StringUtil::safeString( temp_href, description ) )
         {
             break;
         }
-        Fieldml_FreeString(temp_href);
 
         string location;
-        char *temp_string = Fieldml_GetArrayDataSourceLocation( context->getSession(), source );
+        const char *temp_string = Fieldml_PeekArrayDataSourceLocation( context->getSession(), source );
         if( !StringUtil::safeString( temp_string, location ) )
         {
             break;
         }
-        Fieldml_FreeString(temp_string);
 
         const string filename = StringUtil::makeFilename( root, description );
         //TODO Add an API-level enum to allow the user to append data, nuke any existing file, or fail if the file already exists. 
@@ -214,7 +211,7 @@ Hdf5ArrayDataWriter::Hdf5ArrayDataWriter( FieldmlIoContext *_context, const stri
 }
 
 
-bool Hdf5ArrayDataWriter::initializeWithNewDataset( const string location, int *sizes, FieldmlHandleType handleType )
+bool Hdf5ArrayDataWriter::initializeWithNewDataset( const string location, const int64_t *sizes, FieldmlHandleType handleType )
 {
     for( int i = 0; i < rank; i++ )
     {
@@ -255,7 +252,7 @@ bool Hdf5ArrayDataWriter::initializeWithNewDataset( const string location, int *
 }
 
 
-bool Hdf5ArrayDataWriter::initializeWithExistingDataset( int *sizes )
+bool Hdf5ArrayDataWriter::initializeWithExistingDataset( const int64_t *sizes )
 {
     //The dataset already exists. Make sure its dataspace is compatible with the one requested.
     dataspace = H5Dget_space( dataset );
@@ -278,7 +275,7 @@ bool Hdf5ArrayDataWriter::initializeWithExistingDataset( int *sizes )
     
     for( int i = 0; i < rank; i++ )
     {
-        if( ( hSizes[i] != H5S_UNLIMITED ) && ( hSizes[i] < sizes[i] ) )
+        if( ( hSizes[i] != H5S_UNLIMITED ) && ( hSizes[i] < (hsize_t)sizes[i] ) )
         {
             existingRank = -1;
         }
@@ -294,7 +291,7 @@ bool Hdf5ArrayDataWriter::initializeWithExistingDataset( int *sizes )
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataWriter::writeSlab( const int *offsets, const int *sizes, hid_t requiredDatatype, const void *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataWriter::writeSlab( const int64_t *offsets, const int64_t *sizes, hid_t requiredDatatype, const void *valueBuffer )
 {
     if( datatype != requiredDatatype )
     {
@@ -336,7 +333,7 @@ FmlIoErrorNumber Hdf5ArrayDataWriter::writeSlab( const int *offsets, const int *
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataWriter::writeIntSlab( const int *offsets, const int *sizes, const int *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataWriter::writeIntSlab( const int64_t *offsets, const int64_t *sizes, const int *valueBuffer )
 {
     if( closed )
     {
@@ -347,7 +344,7 @@ FmlIoErrorNumber Hdf5ArrayDataWriter::writeIntSlab( const int *offsets, const in
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataWriter::writeDoubleSlab( const int *offsets, const int *sizes, const double *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataWriter::writeDoubleSlab( const int64_t *offsets, const int64_t *sizes, const double *valueBuffer )
 {
     if( closed )
     {
@@ -358,7 +355,7 @@ FmlIoErrorNumber Hdf5ArrayDataWriter::writeDoubleSlab( const int *offsets, const
 }
 
 
-FmlIoErrorNumber Hdf5ArrayDataWriter::writeBooleanSlab( const int *offsets, const int *sizes, const FmlBoolean *valueBuffer )
+FmlIoErrorNumber Hdf5ArrayDataWriter::writeBooleanSlab( const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer )
 {
     if( closed )
     {
@@ -369,6 +366,12 @@ FmlIoErrorNumber Hdf5ArrayDataWriter::writeBooleanSlab( const int *offsets, cons
 }
 
 
+int Hdf5ArrayDataWriter::getRank()
+{
+    return rank;
+}
+
+
 FmlIoErrorNumber Hdf5ArrayDataWriter::close()
 {
     if( closed )
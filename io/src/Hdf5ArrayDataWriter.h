@@ -65,28 +65,30 @@ private:
     hsize_t *hSizes;
     hsize_t *hOffsets;
     
-    bool initializeWithExistingDataset( int *sizes );
+    bool initializeWithExistingDataset( const int64_t *sizes );
     
-    bool initializeWithNewDataset( const std::string sourceName, int *sizes, FieldmlHandleType handleType );
+    bool initializeWithNewDataset( const std::string sourceName, const int64_t *sizes, FieldmlHandleType handleType );
 
-    FmlIoErrorNumber writeSlab( const int *offsets, const int *sizes, hid_t requiredDatatype, const void *valueBuffer );
+    FmlIoErrorNumber writeSlab( const int64_t *offsets, const int64_t *sizes, hid_t requiredDatatype, const void *valueBuffer );
 
 public:
     bool ok;
 
-    Hdf5ArrayDataWriter( FieldmlIoContext *_context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank, hid_t fileAccessProperties );
+    Hdf5ArrayDataWriter( FieldmlIoContext *_context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank, hid_t fileAccessProperties );
     
-    virtual FmlIoErrorNumber writeIntSlab( const int *offsets, const int *sizes, const int *valueBuffer );
+    virtual FmlIoErrorNumber writeIntSlab( const int64_t *offsets, const int64_t *sizes, const int *valueBuffer );
     
-    virtual FmlIoErrorNumber writeDoubleSlab( const int *offsets, const int *sizes, const double *valueBuffer );
+    virtual FmlIoErrorNumber writeDoubleSlab( const int64_t *offsets, const int64_t *sizes, const double *valueBuffer );
     
-    virtual FmlIoErrorNumber writeBooleanSlab( const int *offsets, const int *sizes, const FmlBoolean *valueBuffer );
+    virtual FmlIoErrorNumber writeBooleanSlab( const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer );
+    
+    virtual int getRank();
     
     virtual FmlIoErrorNumber close();
     
     virtual ~Hdf5ArrayDataWriter();
     
-    static Hdf5ArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank );
+    static Hdf5ArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank );
 };
 #endif //FIELDML_HDF5_ARRAY || FIELDML_PHDF5_ARRAY
 
@@ -57,7 +57,7 @@ using namespace std;
 class BufferReader
 {
 protected:
-    int bufferPos;
+    int64_t bufferPos;
     FieldmlInputStream * const stream;
     
 public:
@@ -66,7 +66,7 @@ public:
     
     virtual ~BufferReader() {}
     
-    virtual void read( int count ) = 0;
+    virtual void read( int64_t count ) = 0;
 };
 
 
@@ -80,9 +80,9 @@ public:
     DoubleBufferReader( FieldmlInputStream *_stream, double *_buffer ) :
         BufferReader( _stream ), buffer( _buffer ) {}
     
-    void read( int count )
+    void read( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             buffer[bufferPos++] = stream->readDouble();
         }
@@ -100,9 +100,9 @@ public:
     IntBufferReader( FieldmlInputStream *_stream, int *_buffer ) :
         BufferReader( _stream ), buffer( _buffer ) {}
     
-    void read( int count )
+    void read( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             buffer[bufferPos++] = stream->readInt();
         }
@@ -120,9 +120,9 @@ public:
     BooleanBufferReader( FieldmlInputStream *_stream, FmlBoolean *_buffer ) :
         BufferReader( _stream ), buffer( _buffer ) {}
     
-    void read( int count )
+    void read( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             buffer[bufferPos++] = stream->readBoolean();
         }
@@ -136,13 +136,12 @@ TextArrayDataReader *TextArrayDataReader::create( FieldmlIoContext *context, con
     
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
     string format;
-    char *temp_string = Fieldml_GetDataResourceFormat( context->getSession(), resource );
+    const char *temp_string = Fieldml_PeekDataResourceFormat( context->getSession(), resource );
     if( !StringUtil::safeString( temp_string, format ) )
     {
         context->setError( FML_IOERR_CORE_ERROR );
         return NULL;
     }
-    Fieldml_FreeString(temp_string);
     FieldmlDataResourceType type = Fieldml_GetDataResourceType( context->getSession(), resource );
     
     int rank = Fieldml_GetArrayDataSourceRank( context->getSession(), source );
@@ -161,24 +160,22 @@ TextArrayDataReader *TextArrayDataReader::create( FieldmlIoContext *context, con
     if( type == FML_DATA_RESOURCE_HREF )
     {
         string href;
-        char *temp_href = Fieldml_GetDataResourceHref( context->getSession(), resource );
+        const char *temp_href = Fieldml_PeekDataResourceHref( context->getSession(), resource );
         if( !StringUtil::safeString( temp_href, href ) )
         {
             context->setError( FML_IOERR_CORE_ERROR );
             return NULL;
         }
-        Fieldml_FreeString(temp_href);
         stream = FieldmlInputStream::createTextFileStream( StringUtil::makeFilename( root, href ) );
     }
     else if( type == FML_DATA_RESOURCE_INLINE )
     {
         string data;
-        char *temp_inline_data = Fieldml_GetInlineData( context->getSession(), resource );
+        const char *temp_inline_data = Fieldml_PeekInlineData( context->getSession(), resource );
         if( !StringUtil::safeString( temp_inline_data, data ) )
         {
             return NULL;
         }
-        Fieldml_FreeString(temp_inline_data);
         stream = FieldmlInputStream::createStringStream( data );
     }
     
@@ -205,21 +202,20 @@ TextArrayDataReader::TextArrayDataReader( FieldmlIoContext *_context, FieldmlInp
     
     nextOutermostOffset = -1;
     
-    sourceSizes = new int[sourceRank];
-    sourceRawSizes = new int[sourceRank];
-    sourceOffsets = new int[sourceRank];
+    sourceSizes = new int64_t[sourceRank];
+    sourceRawSizes = new int64_t[sourceRank];
+    sourceOffsets = new int64_t[sourceRank];
     
-    Fieldml_GetArrayDataSourceSizes( context->getSession(), source, sourceSizes );
-    Fieldml_GetArrayDataSourceRawSizes( context->getSession(), source, sourceRawSizes );
-    Fieldml_GetArrayDataSourceOffsets( context->getSession(), source, sourceOffsets );
+    Fieldml_GetArrayDataSourceSizes64( context->getSession(), source, sourceSizes );
+    Fieldml_GetArrayDataSourceRawSizes64( context->getSession(), source, sourceRawSizes );
+    Fieldml_GetArrayDataSourceOffsets64( context->getSession(), source, sourceOffsets );
     
-    char *temp_string = Fieldml_GetArrayDataSourceLocation( context->getSession(), source );
+    const char *temp_string = Fieldml_PeekArrayDataSourceLocation( context->getSession(), source );
     StringUtil::safeString( temp_string, sourceLocation );
-    Fieldml_FreeString(temp_string);
 }
 
 
-bool TextArrayDataReader::checkDimensions( const int *offsets, const int *sizes )
+bool TextArrayDataReader::checkDimensions( const int64_t *offsets, const int64_t *sizes )
 {
     for( int i = 0; i < sourceRank; i++ )
     {
@@ -232,7 +228,7 @@ bool TextArrayDataReader::checkDimensions( const int *offsets, const int *sizes
             return false;
         }
         
-        int rawSize = sourceSizes[i];
+        int64_t rawSize = sourceSizes[i];
         if( rawSize == 0 )
         {
             //NOTE: Intentional. If the array-source size has not been set, use the underlying size.
@@ -274,17 +270,16 @@ FmlIoErrorNumber TextArrayDataReader::skipPreamble()
 }
 
 
-bool TextArrayDataReader::applyOffsets( const int *offsets, const int *sizes, int depth, bool isHead )
+bool TextArrayDataReader::applyOffsets( const int64_t *offsets, const int64_t *sizes, int depth, bool isHead )
 {
-    long count = 1;
+    int64_t count = 1;
     
     for( int i = depth+1; i < sourceRank; i++ )
     {
-        //NOTE This could overflow in the event that someone puts that much data into a text file. Probability: Lilliputian.
         count *= sourceRawSizes[i];
     }
     
-    int sliceCount;
+    int64_t sliceCount;
     if( isHead )
     {
         sliceCount = sourceOffsets[depth] + offsets[depth];
@@ -303,9 +298,9 @@ bool TextArrayDataReader::applyOffsets( const int *offsets, const int *sizes, in
         return true;
     }
     
-    for( int j = 0; j < sliceCount; j++ )
+    for( int64_t j = 0; j < sliceCount; j++ )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             stream->readDouble();
         }
@@ -315,7 +310,7 @@ bool TextArrayDataReader::applyOffsets( const int *offsets, const int *sizes, in
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readPreSlab( const int *offsets, const int *sizes )
+FmlIoErrorNumber TextArrayDataReader::readPreSlab( const int64_t *offsets, const int64_t *sizes )
 {
     if( !checkDimensions( offsets, sizes ) )
     {
@@ -344,7 +339,7 @@ FmlIoErrorNumber TextArrayDataReader::readPreSlab( const int *offsets, const int
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readSlice( const int *offsets, const int *sizes, int depth, BufferReader &reader )
+FmlIoErrorNumber TextArrayDataReader::readSlice( const int64_t *offsets, const int64_t *sizes, int depth, BufferReader &reader )
 {
     if( !applyOffsets( offsets, sizes, depth, true ) )
     {
@@ -362,7 +357,7 @@ FmlIoErrorNumber TextArrayDataReader::readSlice( const int *offsets, const int *
     else
     {
         int err;
-        for( int i = 0; i < sizes[depth]; i++ )
+        for( int64_t i = 0; i < sizes[depth]; i++ )
         {
             err = readSlice( offsets, sizes, depth + 1, reader );
             if( err != FML_IOERR_NO_ERROR )
@@ -386,7 +381,7 @@ FmlIoErrorNumber TextArrayDataReader::readSlice( const int *offsets, const int *
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readSlab( const int *offsets, const int *sizes, BufferReader &reader )
+FmlIoErrorNumber TextArrayDataReader::readSlab( const int64_t *offsets, const int64_t *sizes, BufferReader &reader )
 {
     int err = readPreSlab( offsets, sizes );
     if( err != FML_IOERR_NO_ERROR )
@@ -398,7 +393,7 @@ FmlIoErrorNumber TextArrayDataReader::readSlab( const int *offsets, const int *s
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readIntSlab( const int *offsets, const int *sizes, int *valueBuffer )
+FmlIoErrorNumber TextArrayDataReader::readIntSlab( const int64_t *offsets, const int64_t *sizes, int *valueBuffer )
 {
     if( closed )
     {
@@ -411,7 +406,7 @@ FmlIoErrorNumber TextArrayDataReader::readIntSlab( const int *offsets, const int
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readDoubleSlab( const int *offsets, const int *sizes, double *valueBuffer )
+FmlIoErrorNumber TextArrayDataReader::readDoubleSlab( const int64_t *offsets, const int64_t *sizes, double *valueBuffer )
 {
     if( closed )
     {
@@ -424,7 +419,7 @@ FmlIoErrorNumber TextArrayDataReader::readDoubleSlab( const int *offsets, const
 }
 
 
-FmlIoErrorNumber TextArrayDataReader::readBooleanSlab( const int *offsets, const int *sizes, FmlBoolean *valueBuffer )
+FmlIoErrorNumber TextArrayDataReader::readBooleanSlab( const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer )
 {
     if( closed )
     {
@@ -437,6 +432,12 @@ FmlIoErrorNumber TextArrayDataReader::readBooleanSlab( const int *offsets, const
 }
 
 
+int TextArrayDataReader::getRank()
+{
+    return sourceRank;
+}
+
+
 FmlIoErrorNumber TextArrayDataReader::close()
 {
     if( closed )
@@ -454,7 +455,7 @@ TextArrayDataReader::~TextArrayDataReader()
 {
     delete stream;
     
-    delete sourceRawSizes;
-    delete sourceSizes;
-    delete sourceOffsets;
+    delete[] sourceRawSizes;
+    delete[] sourceSizes;
+    delete[] sourceOffsets;
 }
@@ -60,39 +60,41 @@ private:
 
     int sourceRank;
     
-    int *sourceSizes;
+    int64_t *sourceSizes;
     
-    int *sourceRawSizes;
+    int64_t *sourceRawSizes;
     
-    int *sourceOffsets;
+    int64_t *sourceOffsets;
     
     std::string sourceLocation;
     
-    int nextOutermostOffset;
+    int64_t nextOutermostOffset;
     
     //The seek position of the start of the array data. This is a minor optimization to save us from having to line-skip for each read.
     long startPos;
 
     TextArrayDataReader( FieldmlIoContext *_context, FieldmlInputStream *_stream, FmlObjectHandle source, int _sourceRank );
     
-    bool checkDimensions( const int *offsets, const int *sizes );
+    bool checkDimensions( const int64_t *offsets, const int64_t *sizes );
     
-    bool applyOffsets( const int *offsets, const int *sizes, int depth, bool isHead );
+    bool applyOffsets( const int64_t *offsets, const int64_t *sizes, int depth, bool isHead );
     
-    FmlIoErrorNumber readPreSlab( const int *offsets, const int *sizes );
+    FmlIoErrorNumber readPreSlab( const int64_t *offsets, const int64_t *sizes );
     
-    FmlIoErrorNumber readSlice( const int *offsets, const int *sizes, int depth, BufferReader &reader );
+    FmlIoErrorNumber readSlice( const int64_t *offsets, const int64_t *sizes, int depth, BufferReader &reader );
     
-    FmlIoErrorNumber readSlab( const int *offsets, const int *sizes, BufferReader &reader );
+    FmlIoErrorNumber readSlab( const int64_t *offsets, const int64_t *sizes, BufferReader &reader );
     
     FmlIoErrorNumber skipPreamble();
 
 public:
-    virtual FmlIoErrorNumber readIntSlab( const int *offsets, const int *sizes, int *valueBuffer );
+    virtual FmlIoErrorNumber readIntSlab( const int64_t *offsets, const int64_t *sizes, int *valueBuffer );
     
-    virtual FmlIoErrorNumber readDoubleSlab( const int *offsets, const int *sizes, double *valueBuffer );
+    virtual FmlIoErrorNumber readDoubleSlab( const int64_t *offsets, const int64_t *sizes, double *valueBuffer );
     
-    virtual FmlIoErrorNumber readBooleanSlab( const int *offsets, const int *sizes, FmlBoolean *valueBuffer );
+    virtual FmlIoErrorNumber readBooleanSlab( const int64_t *offsets, const int64_t *sizes, FmlBoolean *valueBuffer );
+    
+    virtual int getRank();
     
     virtual FmlIoErrorNumber close();
     
@@ -97,7 +97,7 @@ public:
 class BufferWriter
 {
 protected:
-    int bufferPos;
+    int64_t bufferPos;
     FieldmlOutputStream * const stream;
     
 public:
@@ -106,7 +106,7 @@ public:
     
     virtual ~BufferWriter() {}
     
-    virtual void write( int count ) = 0;
+    virtual void write( int64_t count ) = 0;
 };
 
 
@@ -120,9 +120,9 @@ public:
     DoubleBufferWriter( FieldmlOutputStream *_stream, const double *_buffer ) :
         BufferWriter( _stream ), buffer( _buffer ) {}
     
-    void write( int count )
+    void write( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             stream->writeDouble( buffer[bufferPos++] );
         }
@@ -140,9 +140,9 @@ public:
     IntBufferWriter( FieldmlOutputStream *_stream, const int *_buffer ) :
         BufferWriter( _stream ), buffer( _buffer ) {}
     
-    void write( int count )
+    void write( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             stream->writeInt( buffer[bufferPos++] );
         }
@@ -160,9 +160,9 @@ public:
     BooleanBufferWriter( FieldmlOutputStream *_stream, const FmlBoolean *_buffer ) :
         BufferWriter( _stream ), buffer( _buffer ) {}
     
-    void write( int count )
+    void write( int64_t count )
     {
-        for( int i = 0; i < count; i++ )
+        for( int64_t i = 0; i < count; i++ )
         {
             stream->writeBoolean( buffer[bufferPos++] );
         }
@@ -170,20 +170,19 @@ public:
 };
 
 
-TextArrayDataWriter *TextArrayDataWriter::create( FieldmlIoContext *context, string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank )
+TextArrayDataWriter *TextArrayDataWriter::create( FieldmlIoContext *context, string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank )
 {
     TextArrayDataWriter *writer = NULL;
     
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
     string format;
-    char *temp_string = Fieldml_GetDataResourceFormat( context->getSession(), resource );
+    const char *temp_string = Fieldml_PeekDataResourceFormat( context->getSession(), resource );
     
     if( !StringUtil::safeString( temp_string, format ) )
     {
         context->setError( FML_IOERR_CORE_ERROR );
         return NULL;
     }
-    Fieldml_FreeString(temp_string);
     
     if( format != StringUtil::PLAIN_TEXT_NAME )
     {
@@ -202,7 +201,7 @@ TextArrayDataWriter *TextArrayDataWriter::create( FieldmlIoContext *context, str
 }
 
 
-TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const string root, FmlObjectHandle _source, FieldmlHandleType handleType, bool append, int *sizes, int _rank ) :
+TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const string root, FmlObjectHandle _source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int _rank ) :
     ArrayDataWriter( _context ),
     source( _source ),
     sourceSizes( NULL ),
@@ -218,8 +217,8 @@ TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const stri
         return;
     }
 
-    sourceSizes = new int[sourceRank];
-    Fieldml_GetArrayDataSourceSizes( context->getSession(), source, sourceSizes );
+    sourceSizes = new int64_t[sourceRank];
+    Fieldml_GetArrayDataSourceSizes64( context->getSession(), source, sourceSizes );
     
     FmlObjectHandle resource = Fieldml_GetDataSourceResource( context->getSession(), source );
     FieldmlDataResourceType type = Fieldml_GetDataResourceType( context->getSession(), resource );
@@ -228,7 +227,7 @@ TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const stri
     {
         string href;
         string path;
-        char *temp_href = Fieldml_GetDataResourceHref( context->getSession(), resource );
+        const char *temp_href = Fieldml_PeekDataResourceHref( context->getSession(), resource );
         if( !StringUtil::safeString( temp_href, href ) )
         {
             context->setError( FML_IOERR_CORE_ERROR );
@@ -238,7 +237,6 @@ TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const stri
             string path = StringUtil::makeFilename( root, href );
             stream = FieldmlOutputStream::createTextFileStream( path, append );
         }
-        Fieldml_FreeString(temp_href);
     }
     else if( type == FML_DATA_RESOURCE_INLINE )
     {
@@ -253,7 +251,7 @@ TextArrayDataWriter::TextArrayDataWriter( FieldmlIoContext *_context, const stri
 }
 
 
-FmlIoErrorNumber TextArrayDataWriter::writeSlice( const int *sizes, const int depth, BufferWriter &writer )
+FmlIoErrorNumber TextArrayDataWriter::writeSlice( const int64_t *sizes, const int depth, BufferWriter &writer )
 {
     if( depth == sourceRank - 1 )
     {
@@ -262,7 +260,7 @@ FmlIoErrorNumber TextArrayDataWriter::writeSlice( const int *sizes, const int de
     }
     
     int err;
-    for( int i = 0; i < sizes[depth]; i++ )
+    for( int64_t i = 0; i < sizes[depth]; i++ )
     {
         err = writeSlice( sizes, depth + 1, writer );
         if( err != FML_IOERR_NO_ERROR )
@@ -275,7 +273,7 @@ FmlIoErrorNumber TextArrayDataWriter::writeSlice( const int *sizes, const int de
 }
     
 
-FmlIoErrorNumber TextArrayDataWriter::writeSlab( const int *offsets, const int *sizes, BufferWriter &writer )
+FmlIoErrorNumber TextArrayDataWriter::writeSlab( const int64_t *offsets, const int64_t *sizes, BufferWriter &writer )
 {
     if( offsets[0] != offset )
     {
@@ -306,7 +304,7 @@ FmlIoErrorNumber TextArrayDataWriter::writeSlab( const int *offsets, const int *
 }
 
 
-FmlIoErrorNumber TextArrayDataWriter::writeIntSlab( const int *offsets, const int *sizes, const int *valueBuffer )
+FmlIoErrorNumber TextArrayDataWriter::writeIntSlab( const int64_t *offsets, const int64_t *sizes, const int *valueBuffer )
 {
     if( closed )
     {
@@ -319,7 +317,7 @@ FmlIoErrorNumber TextArrayDataWriter::writeIntSlab( const int *offsets, const in
 }
 
 
-FmlIoErrorNumber TextArrayDataWriter::writeDoubleSlab( const int *offsets, const int *sizes, const double *valueBuffer )
+FmlIoErrorNumber TextArrayDataWriter::writeDoubleSlab( const int64_t *offsets, const int64_t *sizes, const double *valueBuffer )
 {
     if( closed )
     {
@@ -332,7 +330,7 @@ FmlIoErrorNumber TextArrayDataWriter::writeDoubleSlab( const int *offsets, const
 }
 
 
-FmlIoErrorNumber TextArrayDataWriter::writeBooleanSlab( const int *offsets, const int *sizes, const FmlBoolean *valueBuffer )
+FmlIoErrorNumber TextArrayDataWriter::writeBooleanSlab( const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer )
 {
     if( closed )
     {
@@ -345,6 +343,12 @@ FmlIoErrorNumber TextArrayDataWriter::writeBooleanSlab( const int *offsets, cons
 }
 
 
+int TextArrayDataWriter::getRank()
+{
+    return sourceRank;
+}
+
+
 FmlIoErrorNumber TextArrayDataWriter::close()
 {
     if( closed )
@@ -368,5 +372,5 @@ TextArrayDataWriter::~TextArrayDataWriter()
         delete stream;
     }
     
-    delete sourceSizes;
+    delete[] sourceSizes;
 }
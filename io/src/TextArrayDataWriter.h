@@ -59,30 +59,32 @@ private:
     
     int sourceRank;
     
-    int *sourceSizes;
+    int64_t *sourceSizes;
     
-    int offset;
+    int64_t offset;
 
-    FmlIoErrorNumber writeSlice( const int *sizes, const int depth, BufferWriter &writer );
+    FmlIoErrorNumber writeSlice( const int64_t *sizes, const int depth, BufferWriter &writer );
 
-    FmlIoErrorNumber writeSlab( const int *offsets, const int *sizes, BufferWriter &writer );
+    FmlIoErrorNumber writeSlab( const int64_t *offsets, const int64_t *sizes, BufferWriter &writer );
 
 public:
     bool ok;
 
-    TextArrayDataWriter( FieldmlIoContext *_context, const std::string root, FmlObjectHandle _source, FieldmlHandleType handleType, bool append, int *sizes, int rank );
+    TextArrayDataWriter( FieldmlIoContext *_context, const std::string root, FmlObjectHandle _source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank );
     
-    virtual FmlIoErrorNumber writeIntSlab( const int *offsets, const int *sizes, const int *valueBuffer );
+    virtual FmlIoErrorNumber writeIntSlab( const int64_t *offsets, const int64_t *sizes, const int *valueBuffer );
     
-    virtual FmlIoErrorNumber writeDoubleSlab( const int *offsets, const int *sizes, const double *valueBuffer );
+    virtual FmlIoErrorNumber writeDoubleSlab( const int64_t *offsets, const int64_t *sizes, const double *valueBuffer );
     
-    virtual FmlIoErrorNumber writeBooleanSlab( const int *offsets, const int *sizes, const FmlBoolean *valueBuffer );
+    virtual FmlIoErrorNumber writeBooleanSlab( const int64_t *offsets, const int64_t *sizes, const FmlBoolean *valueBuffer );
+    
+    virtual int getRank();
     
     virtual FmlIoErrorNumber close();
     
     virtual ~TextArrayDataWriter();
     
-    static TextArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, int *sizes, int rank );
+    static TextArrayDataWriter *create( FieldmlIoContext *context, const std::string root, FmlObjectHandle source, FieldmlHandleType handleType, bool append, const int64_t *sizes, int rank );
 };
 
 #endif //H_TEXT_ARRAY_DATA_WRITER
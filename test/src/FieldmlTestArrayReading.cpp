@@ -176,6 +176,69 @@ SIMPLE_TEST( FieldmlDataArrayReadTest )
 }
 
 
+/**
+ * Ensure that 64-bit sizes and offsets round-trip, and that 64-bit slab reads match their 32-bit counterparts.
+ */
+SIMPLE_TEST( FieldmlDataArray64BitTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle resource = Fieldml_CreateInlineDataResource( session, "test.resource" );
+
+    const int rank = 2;
+    FmlObjectHandle source = Fieldml_CreateArrayDataSource( session, "test.source", resource, "1", rank );
+    FmlObjectHandle largeSource = Fieldml_CreateArrayDataSource( session, "test.large_source", resource, "1", rank );
+    
+    const int64_t largeSizes[rank] = { 3000000000LL, 4 };
+    int err = Fieldml_SetArrayDataSourceRawSizes64( session, largeSource, largeSizes );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    
+    int64_t realLargeSizes[rank] = { -1, -1 };
+    err = Fieldml_GetArrayDataSourceRawSizes64( session, largeSource, realLargeSizes );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    SIMPLE_ASSERT_EQUALS( largeSizes[0], realLargeSizes[0] );
+    SIMPLE_ASSERT_EQUALS( largeSizes[1], realLargeSizes[1] );
+    
+    int narrowSizes[rank];
+    err = Fieldml_GetArrayDataSourceRawSizes( session, largeSource, narrowSizes );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_UNSUPPORTED, err );
+    
+    const int64_t sizes[rank] = { 3, 4 };
+    Fieldml_SetArrayDataSourceRawSizes64( session, source, sizes );
+    const string rawData = "1 2 3 4\n5 6 7 8\n9 10 11 12\n";
+    Fieldml_SetInlineData( session, resource, rawData.c_str(), rawData.length() );
+    
+    FmlObjectHandle reader = Fieldml_OpenReader( session, source );
+    SIMPLE_ASSERT( FML_INVALID_HANDLE != reader );
+    
+    const int64_t readOffsets[rank] = { 1, 2 };
+    const int64_t readSizes[rank] = { 2, 2 };
+    int buffer[4] = { -1, -1, -1, -1 };
+    err = Fieldml_ReadIntSlab64( reader, readOffsets, readSizes, buffer );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    SIMPLE_ASSERT_EQUALS( 7, buffer[0] );
+    SIMPLE_ASSERT_EQUALS( 8, buffer[1] );
+    SIMPLE_ASSERT_EQUALS( 11, buffer[2] );
+    SIMPLE_ASSERT_EQUALS( 12, buffer[3] );
+    
+    const int narrowOffsets[rank] = { 1, 2 };
+    const int narrowReadSizes[rank] = { 2, 2 };
+    int narrowBuffer[4] = { -1, -1, -1, -1 };
+    err = Fieldml_ReadIntSlab( reader, narrowOffsets, narrowReadSizes, narrowBuffer );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    for( int i = 0; i < 4; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( buffer[i], narrowBuffer[i] );
+    }
+    
+    Fieldml_CloseReader( reader );
+    
+    Fieldml_Destroy( session );
+}
+
+
 /**
  * Ensure that newly created HDF5 data sources have the correct state.
  */
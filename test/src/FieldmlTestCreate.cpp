@@ -38,9 +38,23 @@
  * the terms of any one of the MPL, the GPL or the LGPL.
  *
  */
+#include <climits>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if !defined WIN32
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <libxml/xmlIO.h>
 
 #include "fieldml_api.h"
+#include "SimpleBitset.h"
+#include "ThreadSupport.h"
 
 #include "SimpleTest.h"
 
@@ -228,6 +242,1391 @@ SIMPLE_TEST( FieldmlCreateBooleanTypeTest )
 }
 
 
+/**
+ * Ensure that bulk-set evaluator maps are ordered, and that later pairings override earlier ones.
+ */
+SIMPLE_TEST( FieldmlSetEvaluatorsTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    FmlObjectHandle two = Fieldml_CreateConstantEvaluator( session, "test.two", "2", realType );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    SIMPLE_ASSERT( piecewise != FML_INVALID_HANDLE );
+    
+    FmlErrorNumber err = Fieldml_SetEvaluator( session, piecewise, 5, one );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    
+    const FmlEnsembleValue elements[] = { 9, 2, 5, 7, 2 };
+    const FmlObjectHandle evaluators[] = { one, one, two, FML_INVALID_HANDLE, two };
+    err = Fieldml_SetEvaluators( session, piecewise, 5, elements, evaluators );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    
+    int count = Fieldml_GetEvaluatorCount( session, piecewise );
+    SIMPLE_ASSERT_EQUALS( 3, count );
+    
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetEvaluatorElement( session, piecewise, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 5, Fieldml_GetEvaluatorElement( session, piecewise, 2 ) );
+    SIMPLE_ASSERT_EQUALS( 9, Fieldml_GetEvaluatorElement( session, piecewise, 3 ) );
+    
+    SIMPLE_ASSERT_EQUALS( two, Fieldml_GetElementEvaluator( session, piecewise, 2, 0 ) );
+    SIMPLE_ASSERT_EQUALS( two, Fieldml_GetElementEvaluator( session, piecewise, 5, 0 ) );
+    SIMPLE_ASSERT_EQUALS( one, Fieldml_GetElementEvaluator( session, piecewise, 9, 0 ) );
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_GetElementEvaluator( session, piecewise, 7, 0 ) );
+    
+    //A single incompatible evaluator causes no pairings to be set.
+    FmlObjectHandle booleanType = Fieldml_CreateBooleanType( session, "test.boolean" );
+    FmlObjectHandle truth = Fieldml_CreateConstantEvaluator( session, "test.true", "1", booleanType );
+    const FmlObjectHandle badEvaluators[] = { one, truth };
+    err = Fieldml_SetEvaluators( session, piecewise, 2, elements, badEvaluators );
+    SIMPLE_ASSERT( err != FML_ERR_NO_ERROR );
+    
+    count = Fieldml_GetEvaluatorCount( session, piecewise );
+    SIMPLE_ASSERT_EQUALS( 3, count );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that the bitset agrees with a plain array across word and rank index block boundaries, including after
+ * bits are changed and the rank index has to be rebuilt.
+ */
+SIMPLE_TEST( SimpleBitsetTest )
+{
+    const int bitCount = 1100;
+    bool expected[bitCount];
+    SimpleBitset bitset;
+    
+    for( int i = 0; i < bitCount; i++ )
+    {
+        expected[i] = ( i % 7 == 0 ) || ( i % 31 == 3 ) || ( ( i >= 250 ) && ( i < 300 ) ) || ( i == bitCount - 1 );
+        bitset.setBit( i, expected[i] );
+    }
+    
+    //Setting a bit to its current state, or clearing a bit beyond the end, changes nothing.
+    bitset.setBit( 14, true );
+    bitset.setBit( 5000, false );
+    bitset.setBit( -1, true );
+    
+    for( int pass = 0; pass < 2; pass++ )
+    {
+        int count = 0;
+        for( int i = 0; i < bitCount; i++ )
+        {
+            SIMPLE_ASSERT_EQUALS( expected[i], bitset.getBit( i ) );
+            if( expected[i] )
+            {
+                count++;
+                SIMPLE_ASSERT_EQUALS( i, bitset.getTrueBit( count ) );
+            }
+        }
+        SIMPLE_ASSERT_EQUALS( count, bitset.getCount() );
+        SIMPLE_ASSERT_EQUALS( -1, bitset.getTrueBit( 0 ) );
+        SIMPLE_ASSERT_EQUALS( -1, bitset.getTrueBit( count + 1 ) );
+        
+        int next = -1;
+        for( int i = bitCount - 1; i >= 0; i-- )
+        {
+            if( expected[i] )
+            {
+                next = i;
+            }
+            SIMPLE_ASSERT_EQUALS( next, bitset.getNextTrueBit( i ) );
+        }
+        
+        //Clear bits in the first block, and set one in a new block, so every later rank moves.
+        bitset.setBit( 0, false );
+        expected[0] = false;
+        bitset.setBit( 260, false );
+        expected[260] = false;
+        bitset.setBit( 1030, true );
+        expected[1030] = true;
+    }
+    
+    SIMPLE_ASSERT_EQUALS( false, bitset.getBit( -1 ) );
+    SIMPLE_ASSERT_EQUALS( false, bitset.getBit( 100000 ) );
+    SIMPLE_ASSERT_EQUALS( -1, bitset.getNextTrueBit( 100000 ) );
+    
+    bitset.clear();
+    SIMPLE_ASSERT_EQUALS( 0, bitset.getCount() );
+    SIMPLE_ASSERT_EQUALS( -1, bitset.getTrueBit( 1 ) );
+    SIMPLE_ASSERT_EQUALS( -1, bitset.getNextTrueBit( 0 ) );
+}
+
+
+/**
+ * Ensure that bulk getters agree with the per-index getters, and respect the given capacity.
+ */
+SIMPLE_TEST( FieldmlBulkGettersTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    FmlObjectHandle two = Fieldml_CreateConstantEvaluator( session, "test.two", "2", realType );
+    FmlObjectHandle x = Fieldml_CreateArgumentEvaluator( session, "test.x", realType );
+    FmlObjectHandle y = Fieldml_CreateArgumentEvaluator( session, "test.y", realType );
+    FmlObjectHandle external = Fieldml_CreateExternalEvaluator( session, "test.external", realType );
+    Fieldml_AddArgument( session, external, x );
+    Fieldml_AddArgument( session, external, y );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    
+    const FmlEnsembleValue elements[] = { 3, 1, 2 };
+    const FmlObjectHandle evaluators[] = { one, two, external };
+    Fieldml_SetEvaluators( session, piecewise, 3, elements, evaluators );
+    Fieldml_SetBind( session, piecewise, y, two );
+    Fieldml_SetBind( session, piecewise, x, one );
+    
+    FmlEnsembleValue gotElements[3];
+    FmlObjectHandle gotEvaluators[3];
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetEvaluators( session, piecewise, gotElements, gotEvaluators, 3 ) );
+    for( int i = 0; i < 3; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetEvaluatorElement( session, piecewise, i + 1 ), gotElements[i] );
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetEvaluator( session, piecewise, i + 1 ), gotEvaluators[i] );
+    }
+    
+    //Only the given capacity is filled in, but the full count is returned.
+    gotElements[1] = -1;
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetEvaluators( session, piecewise, gotElements, NULL, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 1, gotElements[0] );
+    SIMPLE_ASSERT_EQUALS( -1, gotElements[1] );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEvaluators( session, piecewise, gotElements, gotEvaluators, -1 ) );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEvaluators( session, realType, gotElements, gotEvaluators, 3 ) );
+    
+    FmlObjectHandle gotArguments[2], gotSources[2];
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetBinds( session, piecewise, gotArguments, gotSources, 2 ) );
+    for( int i = 0; i < 2; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetBindArgument( session, piecewise, i + 1 ), gotArguments[i] );
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetBindEvaluator( session, piecewise, i + 1 ), gotSources[i] );
+    }
+    
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetArguments( session, external, 0, 1, gotArguments, 2 ) );
+    for( int i = 0; i < 2; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetArgument( session, external, i + 1, 0, 1 ), gotArguments[i] );
+    }
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetArguments( session, piecewise, 1, 1, NULL, 0 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetArguments( session, piecewise, 0, 1, gotArguments, 2 ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that borrowed strings match the allocated copies, and are not reallocated between calls.
+ */
+SIMPLE_TEST( FieldmlPeekStringTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1.5", realType );
+    FmlObjectHandle resource = Fieldml_CreateInlineDataResource( session, "test.resource" );
+    Fieldml_AddInlineData( session, resource, "1 2", 3 );
+    
+    const char *name = Fieldml_PeekObjectName( session, realType );
+    char *nameCopy = Fieldml_GetObjectName( session, realType );
+    SIMPLE_ASSERT( name != NULL );
+    SIMPLE_ASSERT( name != nameCopy );
+    SIMPLE_ASSERT( strcmp( name, nameCopy ) == 0 );
+    SIMPLE_ASSERT( name == Fieldml_PeekObjectName( session, realType ) );
+    Fieldml_FreeString( nameCopy );
+    
+    SIMPLE_ASSERT( strcmp( "test", Fieldml_PeekRegionName( session ) ) == 0 );
+    SIMPLE_ASSERT( strcmp( "1.5", Fieldml_PeekConstantEvaluatorValueString( session, one ) ) == 0 );
+    SIMPLE_ASSERT( strcmp( "1 2", Fieldml_PeekInlineData( session, resource ) ) == 0 );
+    
+    Fieldml_AddInlineData( session, resource, " 3", 2 );
+    SIMPLE_ASSERT( strcmp( "1 2 3", Fieldml_PeekInlineData( session, resource ) ) == 0 );
+    
+    SIMPLE_ASSERT( Fieldml_PeekObjectName( session, FML_INVALID_HANDLE ) == NULL );
+    SIMPLE_ASSERT( Fieldml_PeekInlineData( session, realType ) == NULL );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that inline data built up from many small chunks is stored contiguously and in order.
+ */
+SIMPLE_TEST( FieldmlInlineDataAppendTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle resource = Fieldml_CreateInlineDataResource( session, "test.resource" );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetInlineDataLength( session, resource ) );
+    
+    const int chunkCount = 10000;
+    for( int i = 0; i < chunkCount; i++ )
+    {
+        Fieldml_AddInlineData( session, resource, ( i % 2 ) ? "1 " : "0 ", 2 );
+    }
+    SIMPLE_ASSERT_EQUALS( chunkCount * 2, Fieldml_GetInlineDataLength( session, resource ) );
+    
+    const char *data = Fieldml_PeekInlineData( session, resource );
+    bool inOrder = true;
+    for( int i = 0; i < chunkCount; i++ )
+    {
+        inOrder = inOrder && ( data[i * 2] == ( ( i % 2 ) ? '1' : '0' ) ) && ( data[i * 2 + 1] == ' ' );
+    }
+    SIMPLE_ASSERT( inOrder );
+    
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_SetInlineData( session, resource, "2", 1 ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetInlineDataLength( session, resource ) );
+    SIMPLE_ASSERT( strcmp( "2", Fieldml_PeekInlineData( session, resource ) ) == 0 );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that memory usage figures track changes to the session, and add up to the total.
+ */
+SIMPLE_TEST( FieldmlMemoryUsageTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    SIMPLE_ASSERT( Fieldml_GetMemoryUsage( session, FML_MEMORY_OBJECTS ) > 0 );
+    SIMPLE_ASSERT( Fieldml_GetMemoryUsage( session, FML_MEMORY_NAMES ) > 0 );
+    
+    int64_t maps = Fieldml_GetMemoryUsage( session, FML_MEMORY_MAPS );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    for( int i = 1; i <= 1000; i++ )
+    {
+        Fieldml_SetEvaluator( session, piecewise, i, one );
+    }
+    SIMPLE_ASSERT( Fieldml_GetMemoryUsage( session, FML_MEMORY_MAPS ) >= maps + 1000 * (int64_t)sizeof( FmlObjectHandle ) * 2 );
+    
+    int64_t inlineData = Fieldml_GetMemoryUsage( session, FML_MEMORY_INLINE_DATA );
+    FmlObjectHandle resource = Fieldml_CreateInlineDataResource( session, "test.resource" );
+    for( int i = 0; i < 1000; i++ )
+    {
+        Fieldml_AddInlineData( session, resource, "0123456789", 10 );
+    }
+    SIMPLE_ASSERT( Fieldml_GetMemoryUsage( session, FML_MEMORY_INLINE_DATA ) >= inlineData + 10000 );
+    
+    int64_t caches = Fieldml_GetMemoryUsage( session, FML_MEMORY_CACHES );
+    Fieldml_GetArgumentCount( session, piecewise, 1, 1 );
+    SIMPLE_ASSERT( Fieldml_GetMemoryUsage( session, FML_MEMORY_CACHES ) > caches );
+    
+    int64_t total = 0;
+    for( int category = FML_MEMORY_OBJECTS; category <= FML_MEMORY_CACHES; category++ )
+    {
+        total += Fieldml_GetMemoryUsage( session, (FieldmlMemoryCategory)category );
+    }
+    SIMPLE_ASSERT_EQUALS( total, Fieldml_GetMemoryUsage( session, FML_MEMORY_TOTAL ) );
+    
+    SIMPLE_ASSERT_EQUALS( (int64_t)-1, Fieldml_GetMemoryUsage( session, (FieldmlMemoryCategory)-1 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_INVALID_PARAMETER_2, Fieldml_GetLastError( session ) );
+    SIMPLE_ASSERT_EQUALS( (int64_t)-1, Fieldml_GetMemoryUsage( FML_INVALID_HANDLE, FML_MEMORY_TOTAL ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that ensemble members can be enumerated, whether defined by a range or by member data.
+ */
+SIMPLE_TEST( FieldmlEnsembleMembersTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlEnsembleValue members[8];
+    
+    FmlObjectHandle rangeType = Fieldml_CreateEnsembleType( session, "test.range" );
+    Fieldml_SetEnsembleMembersRange( session, rangeType, 1, 10, 3 );
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetEnsembleMembers( session, rangeType, 1, members, 8 ) );
+    SIMPLE_ASSERT_EQUALS( 1, members[0] );
+    SIMPLE_ASSERT_EQUALS( 10, members[3] );
+    SIMPLE_ASSERT_EQUALS( 7, Fieldml_GetEnsembleMember( session, rangeType, 3 ) );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMember( session, rangeType, 5 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_INVALID_INDEX, Fieldml_GetLastError( session ) );
+    
+    FmlObjectHandle listResource = Fieldml_CreateInlineDataResource( session, "test.list_resource" );
+    const char *listData = "1 2 3 4 10 12 14 100\n";
+    Fieldml_SetInlineData( session, listResource, listData, strlen( listData ) );
+    FmlObjectHandle listSource = Fieldml_CreateArrayDataSource( session, "test.list_source", listResource, "1", 1 );
+    int listSizes[1] = { 8 };
+    Fieldml_SetArrayDataSourceRawSizes( session, listSource, listSizes );
+    FmlObjectHandle listType = Fieldml_CreateEnsembleType( session, "test.list" );
+    Fieldml_SetEnsembleMembersDataSource( session, listType, FML_ENSEMBLE_MEMBER_LIST_DATA, 8, listSource );
+    
+    const FmlEnsembleValue listMembers[8] = { 1, 2, 3, 4, 10, 12, 14, 100 };
+    int index = 1;
+    int copied;
+    while( ( copied = Fieldml_GetEnsembleMembers( session, listType, index, members, 3 ) ) > 0 )
+    {
+        for( int i = 0; i < copied; i++ )
+        {
+            SIMPLE_ASSERT_EQUALS( listMembers[index + i - 1], members[i] );
+        }
+        index += copied;
+    }
+    SIMPLE_ASSERT_EQUALS( 0, copied );
+    SIMPLE_ASSERT_EQUALS( 9, index );
+    SIMPLE_ASSERT_EQUALS( 12, Fieldml_GetEnsembleMember( session, listType, 6 ) );
+    
+    //Changing the member data must be reflected in the members.
+    const char *newListData = "5 6 7 8 9 10 11 12\n";
+    Fieldml_SetInlineData( session, listResource, newListData, strlen( newListData ) );
+    SIMPLE_ASSERT_EQUALS( 10, Fieldml_GetEnsembleMember( session, listType, 6 ) );
+    
+    //A bogus size must fail when the data runs out, rather than when reserving space for it.
+    int bogusSizes[1] = { 2000000000 };
+    Fieldml_SetArrayDataSourceRawSizes( session, listSource, bogusSizes );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMember( session, listType, 6 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( session ) );
+    Fieldml_SetArrayDataSourceRawSizes( session, listSource, listSizes );
+    
+    FmlObjectHandle rangeResource = Fieldml_CreateInlineDataResource( session, "test.range_resource" );
+    const char *rangeData = "1 5\n10 12\n";
+    Fieldml_SetInlineData( session, rangeResource, rangeData, strlen( rangeData ) );
+    FmlObjectHandle rangeSource = Fieldml_CreateArrayDataSource( session, "test.range_source", rangeResource, "1", 2 );
+    int rangeSizes[2] = { 2, 2 };
+    Fieldml_SetArrayDataSourceRawSizes( session, rangeSource, rangeSizes );
+    FmlObjectHandle rangeDataType = Fieldml_CreateEnsembleType( session, "test.range_data" );
+    Fieldml_SetEnsembleMembersDataSource( session, rangeDataType, FML_ENSEMBLE_MEMBER_RANGE_DATA, 8, rangeSource );
+    
+    SIMPLE_ASSERT_EQUALS( 8, Fieldml_GetEnsembleMembers( session, rangeDataType, 1, members, 8 ) );
+    SIMPLE_ASSERT_EQUALS( 5, members[4] );
+    SIMPLE_ASSERT_EQUALS( 10, members[5] );
+    SIMPLE_ASSERT_EQUALS( 12, members[7] );
+    
+    //A declared count that does not match the member data is an error.
+    Fieldml_SetEnsembleMembersDataSource( session, rangeDataType, FML_ENSEMBLE_MEMBER_RANGE_DATA, 7, rangeSource );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMembers( session, rangeDataType, 1, members, 8 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_MISCONFIGURED_OBJECT, Fieldml_GetLastError( session ) );
+    
+    //Values and member counts that do not fit in an int are errors, not wrapped around.
+    const char *hugeListData = "1 2 3 4 99999999999999999999 6 7 8\n";
+    Fieldml_SetInlineData( session, listResource, hugeListData, strlen( hugeListData ) );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMember( session, listType, 1 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( session ) );
+    
+    const char *minimumListData = "-2147483648 2 3 4 5 6 7 8\n";
+    Fieldml_SetInlineData( session, listResource, minimumListData, strlen( minimumListData ) );
+    SIMPLE_ASSERT_EQUALS( INT_MIN, Fieldml_GetEnsembleMember( session, listType, 1 ) );
+    
+    const char *hugeRangeData = "-2147483647 2147483647\n1 1\n";
+    Fieldml_SetInlineData( session, rangeResource, hugeRangeData, strlen( hugeRangeData ) );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMembers( session, rangeDataType, 1, members, 8 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_MISCONFIGURED_OBJECT, Fieldml_GetLastError( session ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+SIMPLE_TEST( FieldmlEnsembleMemberIndexTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle rangeType = Fieldml_CreateEnsembleType( session, "test.range" );
+    Fieldml_SetEnsembleMembersRange( session, rangeType, 1, 10, 3 );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetEnsembleMemberIndex( session, rangeType, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetEnsembleMemberIndex( session, rangeType, 10 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, rangeType, 5 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, rangeType, 13 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( session ) );
+    
+    //Dense members.
+    FmlObjectHandle denseResource = Fieldml_CreateInlineDataResource( session, "test.dense_resource" );
+    const char *denseData = "3 4 5 6 9 8 7 20\n";
+    Fieldml_SetInlineData( session, denseResource, denseData, strlen( denseData ) );
+    FmlObjectHandle denseSource = Fieldml_CreateArrayDataSource( session, "test.dense_source", denseResource, "1", 1 );
+    int sizes[1] = { 8 };
+    Fieldml_SetArrayDataSourceRawSizes( session, denseSource, sizes );
+    FmlObjectHandle denseType = Fieldml_CreateEnsembleType( session, "test.dense" );
+    Fieldml_SetEnsembleMembersDataSource( session, denseType, FML_ENSEMBLE_MEMBER_LIST_DATA, 8, denseSource );
+    
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetEnsembleMemberIndex( session, denseType, 3 ) );
+    SIMPLE_ASSERT_EQUALS( 5, Fieldml_GetEnsembleMemberIndex( session, denseType, 9 ) );
+    SIMPLE_ASSERT_EQUALS( 7, Fieldml_GetEnsembleMemberIndex( session, denseType, 7 ) );
+    SIMPLE_ASSERT_EQUALS( 8, Fieldml_GetEnsembleMemberIndex( session, denseType, 20 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, denseType, 10 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, denseType, -1 ) );
+    
+    //Sparse members.
+    FmlObjectHandle sparseResource = Fieldml_CreateInlineDataResource( session, "test.sparse_resource" );
+    const char *sparseData = "1000000 -5 17 2000000000 18 42 99999 3\n";
+    Fieldml_SetInlineData( session, sparseResource, sparseData, strlen( sparseData ) );
+    FmlObjectHandle sparseSource = Fieldml_CreateArrayDataSource( session, "test.sparse_source", sparseResource, "1", 1 );
+    Fieldml_SetArrayDataSourceRawSizes( session, sparseSource, sizes );
+    FmlObjectHandle sparseType = Fieldml_CreateEnsembleType( session, "test.sparse" );
+    Fieldml_SetEnsembleMembersDataSource( session, sparseType, FML_ENSEMBLE_MEMBER_LIST_DATA, 8, sparseSource );
+    
+    const FmlEnsembleValue sparseMembers[8] = { 1000000, -5, 17, 2000000000, 18, 42, 99999, 3 };
+    for( int i = 0; i < 8; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( i + 1, Fieldml_GetEnsembleMemberIndex( session, sparseType, sparseMembers[i] ) );
+    }
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, sparseType, 0 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, sparseType, 19 ) );
+    
+    //The index must follow changes to the member data.
+    const char *newSparseData = "1000000 -6 17 2000000000 18 42 99999 3\n";
+    Fieldml_SetInlineData( session, sparseResource, newSparseData, strlen( newSparseData ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetEnsembleMemberIndex( session, sparseType, -5 ) );
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetEnsembleMemberIndex( session, sparseType, -6 ) );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    SIMPLE_ASSERT_EQUALS( -1, Fieldml_GetEnsembleMemberIndex( session, realType, 1 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_INVALID_OBJECT, Fieldml_GetLastError( session ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+static void writeTestDocument( const char *filename, const char *content )
+{
+    FILE *file = fopen( filename, "w" );
+    fputs( content, file );
+    fclose( file );
+}
+
+
+SIMPLE_TEST( FieldmlStructuralValidationTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    SIMPLE_ASSERT_EQUALS( FML_ERR_INVALID_PARAMETER_2, Fieldml_SetValidationLevel( session, FML_VALIDATION_UNKNOWN ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_SetValidationLevel( session, FML_VALIDATION_STRUCTURAL ) );
+    
+    //The internal library must pass the structural checks.
+    int importIndex = Fieldml_AddImportSource( session, "http://www.fieldml.org/resources/xml/0.5/FieldML_Library_0.5.xml", "library" );
+    SIMPLE_ASSERT( importIndex > 0 );
+    SIMPLE_ASSERT( Fieldml_AddImport( session, importIndex, "test.real", "real.1d" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    
+    Fieldml_Destroy( session );
+    
+    const char *header =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n"
+        "<EnsembleType name=\"test.ensemble\"><Members><MemberRange min=\"1\" max=\"10\"/></Members></EnsembleType>\n";
+    const char *footer =
+        "</Region>\n"
+        "</Fieldml>\n";
+    
+    std::string valid = std::string( header ) + "<ArgumentEvaluator name=\"test.argument\" valueType=\"test.ensemble\"/>\n" + footer;
+    writeTestDocument( "structural_test.xml", valid.c_str() );
+    session = Fieldml_CreateFromFileWithValidation( "structural_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    SIMPLE_ASSERT( Fieldml_GetObjectByName( session, "test.argument" ) != FML_INVALID_HANDLE );
+    Fieldml_Destroy( session );
+    
+    std::string missingAttribute = std::string( header ) + "<ArgumentEvaluator name=\"test.argument\"/>\n" + footer;
+    writeTestDocument( "structural_test.xml", missingAttribute.c_str() );
+    session = Fieldml_CreateFromFileWithValidation( "structural_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( Fieldml_GetErrorCount( session ) > 0 );
+    SIMPLE_ASSERT_EQUALS( std::string( "Missing required attribute: valueType:: ArgumentEvaluator" ), std::string( Fieldml_GetError( session, 1 ) ) );
+    Fieldml_Destroy( session );
+    
+    std::string unexpectedElement = std::string( header ) + "<ArgumentEvaluator name=\"test.argument\" valueType=\"test.ensemble\"><Bindings/></ArgumentEvaluator>\n" + footer;
+    writeTestDocument( "structural_test.xml", unexpectedElement.c_str() );
+    session = Fieldml_CreateFromFileWithValidation( "structural_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( Fieldml_GetErrorCount( session ) > 0 );
+    SIMPLE_ASSERT_EQUALS( std::string( "Unexpected element: Bindings:: ArgumentEvaluator" ), std::string( Fieldml_GetError( session, 1 ) ) );
+    Fieldml_Destroy( session );
+    
+    std::string unresolvedReference = std::string( header ) + "<ArgumentEvaluator name=\"test.argument\" valueType=\"test.missing\"/>\n" + footer;
+    writeTestDocument( "structural_test.xml", unresolvedReference.c_str() );
+    session = Fieldml_CreateFromFileWithValidation( "structural_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( Fieldml_GetErrorCount( session ) > 0 );
+    SIMPLE_ASSERT_EQUALS( std::string( "Unresolved object reference: test.missing:: valueType" ), std::string( Fieldml_GetError( session, 1 ) ) );
+    Fieldml_Destroy( session );
+    
+    remove( "structural_test.xml" );
+}
+
+
+/**
+ * Ensure that objects can refer to objects defined later in the document, and that a later object with a duplicated
+ * name is the one referred to.
+ */
+SIMPLE_TEST( FieldmlForwardReferenceTest )
+{
+    //Each argument's value type is defined after it, in reverse order, so that each reference is looked up by name.
+    std::string document =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n";
+    char line[256];
+    for( int i = 0; i < 20; i++ )
+    {
+        sprintf( line, "<ArgumentEvaluator name=\"test.argument_%d\" valueType=\"test.ensemble_%d\"/>\n", i, i );
+        document += line;
+    }
+    for( int i = 19; i >= 0; i-- )
+    {
+        sprintf( line, "<EnsembleType name=\"test.ensemble_%d\"><Members><MemberRange min=\"1\" max=\"%d\"/></Members></EnsembleType>\n", i, i + 1 );
+        document += line;
+    }
+    document +=
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "forward_reference_test.xml", document.c_str() );
+    
+    FmlSessionHandle session = Fieldml_CreateFromFileWithValidation( "forward_reference_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    
+    for( int i = 0; i < 20; i++ )
+    {
+        char name[64];
+        sprintf( name, "test.argument_%d", i );
+        FmlObjectHandle valueType = Fieldml_GetValueType( session, Fieldml_GetObjectByName( session, name ) );
+        SIMPLE_ASSERT_EQUALS( FHT_ENSEMBLE_TYPE, Fieldml_GetObjectType( session, valueType ) );
+        SIMPLE_ASSERT_EQUALS( i + 1, Fieldml_GetMemberCount( session, valueType ) );
+    }
+    
+    Fieldml_Destroy( session );
+    
+    //Reading the whole document would fail on the duplicated name, but lazy imports only create the objects found.
+    const char *duplicated =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"imported\">\n"
+        "<ArgumentEvaluator name=\"imported.argument\" valueType=\"imported.duplicated\"/>\n"
+        "<ContinuousType name=\"imported.duplicated\"/>\n"
+        "<EnsembleType name=\"imported.duplicated\"><Members><MemberRange min=\"1\" max=\"3\"/></Members></EnsembleType>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "forward_reference_test.xml", duplicated );
+    
+    session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    Fieldml_SetLazyImports( session, 1 );
+    Fieldml_SetValidationLevel( session, FML_VALIDATION_STRUCTURAL );
+    int importIndex = Fieldml_AddImportSource( session, "forward_reference_test.xml", "imported" );
+    SIMPLE_ASSERT( importIndex > 0 );
+    
+    FmlObjectHandle argument = Fieldml_AddImport( session, importIndex, "test.argument", "imported.argument" );
+    SIMPLE_ASSERT( argument != FML_INVALID_HANDLE );
+    FmlObjectHandle valueType = Fieldml_GetValueType( session, argument );
+    SIMPLE_ASSERT_EQUALS( FHT_ENSEMBLE_TYPE, Fieldml_GetObjectType( session, valueType ) );
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetMemberCount( session, valueType ) );
+    SIMPLE_ASSERT_EQUALS( valueType, Fieldml_AddImport( session, importIndex, "test.duplicated", "imported.duplicated" ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    
+    Fieldml_Destroy( session );
+    
+    remove( "forward_reference_test.xml" );
+}
+
+
+SIMPLE_TEST( FieldmlStreamingLoadTest )
+{
+    //Enough inline data to span several reads of the file.
+    std::string data;
+    while( data.size() < 200000 )
+    {
+        data += "0.5 1.5 2.5 3.5\n";
+    }
+    int rowCount = (int)( data.size() / 16 );
+
+    char rowText[32];
+    sprintf( rowText, "%d", rowCount );
+
+    std::string document =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n"
+        "<ArgumentEvaluator name=\"test.argument\" valueType=\"test.ensemble\"/>\n"
+        "<EnsembleType name=\"test.ensemble\"><Members><MemberRange min=\"1\" max=\"10\"/></Members></EnsembleType>\n"
+        "<DataResource name=\"test.resource\">"
+        "<DataResourceDescription><DataResourceString>" + data + "</DataResourceString></DataResourceDescription>"
+        "<ArrayDataSource name=\"test.source\" location=\"1\" rank=\"2\"><RawArraySize>" + rowText + " 4</RawArraySize></ArrayDataSource>"
+        "</DataResource>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "streaming_test.xml", document.c_str() );
+
+    FmlSessionHandle session = Fieldml_CreateFromFileStreaming( "streaming_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+
+    FmlObjectHandle argument = Fieldml_GetObjectByName( session, "test.argument" );
+    SIMPLE_ASSERT( argument != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( Fieldml_GetObjectByName( session, "test.ensemble" ), Fieldml_GetValueType( session, argument ) );
+
+    FmlObjectHandle resource = Fieldml_GetObjectByName( session, "test.resource" );
+    SIMPLE_ASSERT_EQUALS( (int)data.size(), Fieldml_GetInlineDataLength( session, resource ) );
+    char tail[17] = { 0 };
+    SIMPLE_ASSERT_EQUALS( 16, Fieldml_CopyInlineData( session, resource, tail, 17, (int)data.size() - 16 ) );
+    SIMPLE_ASSERT_EQUALS( std::string( "0.5 1.5 2.5 3.5\n" ), std::string( tail ) );
+
+    FmlObjectHandle source = Fieldml_GetObjectByName( session, "test.source" );
+    SIMPLE_ASSERT_EQUALS( resource, Fieldml_GetDataSourceResource( session, source ) );
+    int sizes[2];
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetArrayDataSourceRawSizes( session, source, sizes ) );
+    SIMPLE_ASSERT_EQUALS( rowCount, sizes[0] );
+    SIMPLE_ASSERT_EQUALS( 4, sizes[1] );
+
+    Fieldml_Destroy( session );
+
+    std::string unexpectedElement =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\">\n"
+        "<Region name=\"test\">\n"
+        "<DataResource name=\"test.resource\"><Bogus/></DataResource>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "streaming_test.xml", unexpectedElement.c_str() );
+    session = Fieldml_CreateFromFileStreaming( "streaming_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( Fieldml_GetErrorCount( session ) > 0 );
+    SIMPLE_ASSERT_EQUALS( std::string( "Unexpected element: Bogus:: DataResource" ), std::string( Fieldml_GetError( session, 1 ) ) );
+    Fieldml_Destroy( session );
+
+    //Nothing is imported or created from a document found to be invalid after its imports and data have been read.
+    std::string invalidDocument =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n"
+        "<Import xlink:href=\"http://www.fieldml.org/resources/xml/0.5/FieldML_Library_0.5.xml\" region=\"library\">"
+        "<ImportType localName=\"test.real\" remoteName=\"real.1d\"/></Import>\n"
+        "<DataResource name=\"test.resource\">"
+        "<DataResourceDescription><DataResourceString>1 2 3 4</DataResourceString></DataResourceDescription>"
+        "<ArrayDataSource name=\"test.source\" location=\"1\" rank=\"1\"><RawArraySize>4</RawArraySize></ArrayDataSource>"
+        "</DataResource>\n"
+        "<Bogus>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "streaming_test.xml", invalidDocument.c_str() );
+    session = Fieldml_CreateFromFileStreaming( "streaming_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT( Fieldml_GetErrorCount( session ) > 0 );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetTotalObjectCount( session ) );
+    Fieldml_Destroy( session );
+
+    //The same document is read in full once it is valid.
+    invalidDocument.erase( invalidDocument.find( "<Bogus>\n" ), 8 );
+    writeTestDocument( "streaming_test.xml", invalidDocument.c_str() );
+    session = Fieldml_CreateFromFileStreaming( "streaming_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetImportSourceCount( session ) );
+    SIMPLE_ASSERT( Fieldml_GetObjectByName( session, "test.real" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( Fieldml_GetObjectByName( session, "test.resource" ), Fieldml_GetDataSourceResource( session, Fieldml_GetObjectByName( session, "test.source" ) ) );
+    SIMPLE_ASSERT_EQUALS( 7, Fieldml_GetInlineDataLength( session, Fieldml_GetObjectByName( session, "test.resource" ) ) );
+    Fieldml_Destroy( session );
+
+    remove( "streaming_test.xml" );
+}
+
+
+/**
+ * Ensure that the precompiled internal library creates the same objects, with the same handles, as its document.
+ */
+SIMPLE_TEST( FieldmlLibraryImageTest )
+{
+    FmlSessionHandle imported = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( imported, 0 );
+    SIMPLE_ASSERT( Fieldml_AddImportSource( imported, "http://www.fieldml.org/resources/xml/0.5/FieldML_Library_0.5.xml", "library" ) > 0 );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( imported ) );
+
+    FmlSessionHandle parsed = Fieldml_CreateFromFileWithValidation( "../FieldML_Library_0.5.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( parsed ) );
+
+    int count = Fieldml_GetTotalObjectCount( parsed );
+    SIMPLE_ASSERT( count > 0 );
+    SIMPLE_ASSERT_EQUALS( count, Fieldml_GetTotalObjectCount( imported ) );
+
+    for( int i = 1; i <= count; i++ )
+    {
+        FmlObjectHandle object = Fieldml_GetObjectByIndex( parsed, i );
+        SIMPLE_ASSERT_EQUALS( object, Fieldml_GetObjectByIndex( imported, i ) );
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetObjectType( parsed, object ), Fieldml_GetObjectType( imported, object ) );
+        SIMPLE_ASSERT_EQUALS( std::string( Fieldml_PeekObjectDeclaredName( parsed, object ) ), std::string( Fieldml_PeekObjectDeclaredName( imported, object ) ) );
+
+        FieldmlHandleType type = Fieldml_GetObjectType( parsed, object );
+        if( type == FHT_ENSEMBLE_TYPE )
+        {
+            SIMPLE_ASSERT_EQUALS( Fieldml_GetMemberCount( parsed, object ), Fieldml_GetMemberCount( imported, object ) );
+            SIMPLE_ASSERT_EQUALS( Fieldml_GetEnsembleMembersMin( parsed, object ), Fieldml_GetEnsembleMembersMin( imported, object ) );
+        }
+        else if( type == FHT_CONTINUOUS_TYPE )
+        {
+            SIMPLE_ASSERT_EQUALS( Fieldml_GetTypeComponentEnsemble( parsed, object ), Fieldml_GetTypeComponentEnsemble( imported, object ) );
+        }
+        else if( ( type == FHT_ARGUMENT_EVALUATOR ) || ( type == FHT_EXTERNAL_EVALUATOR ) )
+        {
+            SIMPLE_ASSERT_EQUALS( Fieldml_GetValueType( parsed, object ), Fieldml_GetValueType( imported, object ) );
+            int argumentCount = Fieldml_GetArgumentCount( parsed, object, 1, 1 );
+            SIMPLE_ASSERT_EQUALS( argumentCount, Fieldml_GetArgumentCount( imported, object, 1, 1 ) );
+            for( int j = 1; j <= argumentCount; j++ )
+            {
+                SIMPLE_ASSERT_EQUALS( Fieldml_GetArgument( parsed, object, j, 1, 1 ), Fieldml_GetArgument( imported, object, j, 1, 1 ) );
+            }
+        }
+    }
+
+    Fieldml_Destroy( parsed );
+    Fieldml_Destroy( imported );
+}
+
+
+/**
+ * Ensure that lazily imported documents only create the objects actually imported, and the objects they refer to.
+ */
+SIMPLE_TEST( FieldmlLazyImportTest )
+{
+    const char *imported =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"imported\">\n"
+        "<ArgumentEvaluator name=\"imported.argument\" valueType=\"imported.ensemble\"/>\n"
+        "<EnsembleType name=\"imported.ensemble\"><Members><MemberRange min=\"1\" max=\"10\"/></Members></EnsembleType>\n"
+        "<ContinuousType name=\"imported.unused\"/>\n"
+        "<ArgumentEvaluator name=\"imported.unused_argument\" valueType=\"imported.unused\"/>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    const char *main =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n"
+        "<Import xlink:href=\"lazy_imported.xml\" region=\"imported\">\n"
+        "<ImportType localName=\"test.argument\" remoteName=\"imported.argument\"/>\n"
+        "</Import>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    writeTestDocument( "lazy_imported.xml", imported );
+    writeTestDocument( "lazy_test.xml", main );
+
+    FmlSessionHandle eager = Fieldml_CreateFromFileWithValidation( "lazy_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( eager ) );
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetTotalObjectCount( eager ) );
+    Fieldml_Destroy( eager );
+
+    FmlSessionHandle session = Fieldml_CreateFromFileWithLazyImports( "lazy_test.xml", FML_VALIDATION_STRUCTURAL );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetTotalObjectCount( session ) );
+
+    FmlObjectHandle argument = Fieldml_GetObjectByName( session, "test.argument" );
+    SIMPLE_ASSERT( argument != FML_INVALID_HANDLE );
+    FmlObjectHandle ensemble = Fieldml_GetValueType( session, argument );
+    SIMPLE_ASSERT( ensemble != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( std::string( "imported.ensemble" ), std::string( Fieldml_PeekObjectDeclaredName( session, ensemble ) ) );
+    SIMPLE_ASSERT_EQUALS( 10, Fieldml_GetMemberCount( session, ensemble ) );
+
+    //Further objects are created as they are imported, and objects already created are reused.
+    SIMPLE_ASSERT( Fieldml_AddImport( session, 1, "test.unused_argument", "imported.unused_argument" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetTotalObjectCount( session ) );
+    SIMPLE_ASSERT_EQUALS( ensemble, Fieldml_AddImport( session, 1, "test.ensemble", "imported.ensemble" ) );
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetTotalObjectCount( session ) );
+
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_AddImport( session, 1, "test.missing", "imported.missing" ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_INVALID_PARAMETER_4, Fieldml_GetLastError( session ) );
+
+    Fieldml_Destroy( session );
+
+    //Importing into a session created through the API.
+    session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_SetLazyImports( session, 1 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_SetValidationLevel( session, FML_VALIDATION_STRUCTURAL ) );
+    int importIndex = Fieldml_AddImportSource( session, "lazy_imported.xml", "imported" );
+    SIMPLE_ASSERT( importIndex > 0 );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetTotalObjectCount( session ) );
+    SIMPLE_ASSERT( Fieldml_AddImport( session, importIndex, "test.unused", "imported.unused" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetTotalObjectCount( session ) );
+    Fieldml_Destroy( session );
+
+    remove( "lazy_imported.xml" );
+    remove( "lazy_test.xml" );
+}
+
+
+/**
+ * Ensure that a session read from a binary file has the same objects, with the same handles, as the session written.
+ */
+//Writes the given binary session file with one field of the given object's record replaced. The record layout is
+//private to the library, so the offsets used here must follow fieldml_binary.cpp.
+static void writePatchedBinary( const char *filename, std::string contents, FmlObjectHandle object, size_t fieldOffset, int64_t value, size_t size )
+{
+    int32_t counts[4];
+    memcpy( counts, contents.data() + 16, sizeof( counts ) );
+    size_t offset = 56 + counts[0] * 48 + counts[2] * 40 + counts[3] * 48 + object * 144 + fieldOffset;
+    if( size == sizeof( int32_t ) )
+    {
+        int32_t value32 = (int32_t)value;
+        contents.replace( offset, size, (const char*)&value32, size );
+    }
+    else
+    {
+        contents.replace( offset, size, (const char*)&value, size );
+    }
+    
+    FILE *file = fopen( filename, "wb" );
+    fwrite( contents.data(), 1, contents.size(), file );
+    fclose( file );
+}
+
+
+SIMPLE_TEST( FieldmlBinarySessionTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    
+    int importIndex = Fieldml_AddImportSource( session, "http://www.fieldml.org/resources/xml/0.5/FieldML_Library_0.5.xml", "library" );
+    FmlObjectHandle realType = Fieldml_AddImport( session, importIndex, "test.real", "real.1d" );
+    SIMPLE_ASSERT( realType != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle ensembleType = Fieldml_CreateEnsembleType( session, "test.ensemble" );
+    Fieldml_SetEnsembleMembersRange( session, ensembleType, 1, 4, 1 );
+    FmlObjectHandle index = Fieldml_CreateArgumentEvaluator( session, "test.index", ensembleType );
+    FmlObjectHandle x = Fieldml_CreateArgumentEvaluator( session, "test.x", realType );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    
+    FmlObjectHandle resource = Fieldml_CreateInlineDataResource( session, "test.resource" );
+    Fieldml_AddInlineData( session, resource, "0.5 1.5 2.5 3.5\n", 16 );
+    FmlObjectHandle source = Fieldml_CreateArrayDataSource( session, "test.source", resource, "1", 1 );
+    int sizes[] = { 4 };
+    Fieldml_SetArrayDataSourceRawSizes( session, source, sizes );
+    Fieldml_SetArrayDataSourceSizes( session, source, sizes );
+    
+    FmlObjectHandle parameters = Fieldml_CreateParameterEvaluator( session, "test.parameters", realType );
+    Fieldml_SetParameterDataDescription( session, parameters, FML_DATA_DESCRIPTION_DENSE_ARRAY );
+    Fieldml_SetDataSource( session, parameters, source );
+    Fieldml_AddDenseIndexEvaluator( session, parameters, index, FML_INVALID_HANDLE );
+    
+    FmlObjectHandle external = Fieldml_CreateExternalEvaluator( session, "test.external", realType );
+    Fieldml_AddArgument( session, external, x );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    Fieldml_SetIndexEvaluator( session, piecewise, 1, index );
+    Fieldml_SetDefaultEvaluator( session, piecewise, one );
+    const FmlEnsembleValue elements[] = { 2, 3 };
+    const FmlObjectHandle evaluators[] = { parameters, external };
+    Fieldml_SetEvaluators( session, piecewise, 2, elements, evaluators );
+    Fieldml_SetBind( session, piecewise, x, one );
+    FmlObjectHandle reference = Fieldml_CreateReferenceEvaluator( session, "test.reference", piecewise );
+    Fieldml_SetBind( session, reference, index, index );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_WriteBinary( session, "binary_test.fmlb" ) );
+    
+    FmlSessionHandle binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    Fieldml_SetDebug( binary, 0 );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( binary ) );
+    SIMPLE_ASSERT_EQUALS( std::string( "test" ), std::string( Fieldml_PeekRegionName( binary ) ) );
+    
+    int count = Fieldml_GetTotalObjectCount( session );
+    SIMPLE_ASSERT_EQUALS( count, Fieldml_GetTotalObjectCount( binary ) );
+    for( int i = 1; i <= count; i++ )
+    {
+        FmlObjectHandle object = Fieldml_GetObjectByIndex( session, i );
+        SIMPLE_ASSERT_EQUALS( object, Fieldml_GetObjectByIndex( binary, i ) );
+        SIMPLE_ASSERT_EQUALS( Fieldml_GetObjectType( session, object ), Fieldml_GetObjectType( binary, object ) );
+        SIMPLE_ASSERT_EQUALS( std::string( Fieldml_PeekObjectDeclaredName( session, object ) ), std::string( Fieldml_PeekObjectDeclaredName( binary, object ) ) );
+    }
+    
+    SIMPLE_ASSERT_EQUALS( Fieldml_GetImportSourceCount( session ), Fieldml_GetImportSourceCount( binary ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetImportCount( binary, importIndex ) );
+    SIMPLE_ASSERT_EQUALS( realType, Fieldml_GetImportObject( binary, importIndex, 1 ) );
+    SIMPLE_ASSERT_EQUALS( realType, Fieldml_GetObjectByName( binary, "test.real" ) );
+    
+    SIMPLE_ASSERT_EQUALS( 4, Fieldml_GetMemberCount( binary, ensembleType ) );
+    SIMPLE_ASSERT_EQUALS( 16, Fieldml_GetInlineDataLength( binary, resource ) );
+    char data[17] = { 0 };
+    SIMPLE_ASSERT_EQUALS( 16, Fieldml_CopyInlineData( binary, resource, data, 17, 0 ) );
+    SIMPLE_ASSERT_EQUALS( std::string( "0.5 1.5 2.5 3.5\n" ), std::string( data ) );
+    SIMPLE_ASSERT_EQUALS( resource, Fieldml_GetDataSourceResource( binary, source ) );
+    
+    SIMPLE_ASSERT_EQUALS( FML_DATA_DESCRIPTION_DENSE_ARRAY, Fieldml_GetParameterDataDescription( binary, parameters ) );
+    SIMPLE_ASSERT_EQUALS( source, Fieldml_GetDataSource( binary, parameters ) );
+    SIMPLE_ASSERT_EQUALS( index, Fieldml_GetParameterIndexEvaluator( binary, parameters, 1, 0 ) );
+    
+    SIMPLE_ASSERT_EQUALS( index, Fieldml_GetIndexEvaluator( binary, piecewise, 1 ) );
+    SIMPLE_ASSERT_EQUALS( one, Fieldml_GetDefaultEvaluator( binary, piecewise ) );
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetEvaluatorCount( binary, piecewise ) );
+    SIMPLE_ASSERT_EQUALS( external, Fieldml_GetElementEvaluator( binary, piecewise, 3, 0 ) );
+    SIMPLE_ASSERT_EQUALS( one, Fieldml_GetBindByArgument( binary, piecewise, x ) );
+    SIMPLE_ASSERT_EQUALS( piecewise, Fieldml_GetReferenceSourceEvaluator( binary, reference ) );
+    SIMPLE_ASSERT_EQUALS( Fieldml_GetArgumentCount( session, reference, 1, 1 ), Fieldml_GetArgumentCount( binary, reference, 1, 1 ) );
+    
+    //The session read is modifiable in the usual way.
+    SIMPLE_ASSERT( Fieldml_CreateContinuousType( binary, "test.extra" ) != FML_INVALID_HANDLE );
+    
+    Fieldml_Destroy( binary );
+    Fieldml_Destroy( session );
+    
+    //Truncated and foreign files are rejected.
+    FILE *file = fopen( "binary_test.fmlb", "rb" );
+    std::string contents;
+    char buffer[256];
+    size_t length;
+    while( ( length = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+    {
+        contents.append( buffer, length );
+    }
+    fclose( file );
+    
+    file = fopen( "binary_test.fmlb", "wb" );
+    fwrite( contents.data(), 1, contents.size() - 1, file );
+    fclose( file );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    //So are records which the API would not have allowed: a zero stride, a rank which does not match the data
+    //source's sizes, an unknown members type and a reference to the wrong type of object.
+    writePatchedBinary( "binary_test.fmlb", contents, ensembleType, 96, 0, sizeof( int64_t ) );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    writePatchedBinary( "binary_test.fmlb", contents, source, 80, 2, sizeof( int64_t ) );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    writePatchedBinary( "binary_test.fmlb", contents, ensembleType, 16, 99, sizeof( int32_t ) );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    writePatchedBinary( "binary_test.fmlb", contents, reference, 24, resource, sizeof( int32_t ) );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    //The unpatched file still reads.
+    writePatchedBinary( "binary_test.fmlb", contents, reference, 24, piecewise, sizeof( int32_t ) );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    writeTestDocument( "binary_test.fmlb", "<?xml version=\"1.0\"?>\n" );
+    binary = Fieldml_CreateFromBinary( "binary_test.fmlb" );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_READ_ERR, Fieldml_GetLastError( binary ) );
+    Fieldml_Destroy( binary );
+    
+    remove( "binary_test.fmlb" );
+}
+
+
+/**
+ * Ensure that argument lists reflect binds made after they were last queried.
+ */
+SIMPLE_TEST( FieldmlArgumentInvalidationTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    FmlObjectHandle x = Fieldml_CreateArgumentEvaluator( session, "test.x", realType );
+    FmlObjectHandle inner = Fieldml_CreateReferenceEvaluator( session, "test.inner", x );
+    FmlObjectHandle outer = Fieldml_CreateReferenceEvaluator( session, "test.outer", inner );
+    SIMPLE_ASSERT( outer != FML_INVALID_HANDLE );
+    
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetArgumentCount( session, outer, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( x, Fieldml_GetArgument( session, outer, 1, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetArgumentCount( session, inner, 0, 1 ) );
+    
+    FmlErrorNumber err = Fieldml_SetBind( session, inner, x, one );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetArgumentCount( session, inner, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetArgumentCount( session, outer, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetArgumentCount( session, outer, 1, 1 ) );
+    
+    //Cyclic dependency checks must also see the new delegate.
+    err = Fieldml_SetBind( session, inner, x, outer );
+    SIMPLE_ASSERT( err != FML_ERR_NO_ERROR );
+    
+    Fieldml_Destroy( session );
+}
+
+
+/**
+ * Ensure that only complete sessions can be frozen, and that frozen sessions cannot be modified.
+ */
+SIMPLE_TEST( FieldmlFreezeSessionTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle ensembleType = Fieldml_CreateEnsembleType( session, "test.ensemble" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    FmlObjectHandle index = Fieldml_CreateArgumentEvaluator( session, "test.index", ensembleType );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    Fieldml_SetEvaluator( session, piecewise, 1, one );
+    
+    FmlErrorNumber err = Fieldml_FreezeSession( session );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_MISCONFIGURED_OBJECT, err );
+    
+    Fieldml_SetIndexEvaluator( session, piecewise, 1, index );
+    SIMPLE_ASSERT_EQUALS( index, Fieldml_GetIndexEvaluator( session, piecewise, 1 ) );
+    
+    err = Fieldml_FreezeSession( session );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, err );
+    
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetArgumentCount( session, piecewise, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( index, Fieldml_GetArgument( session, piecewise, 1, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( one, Fieldml_GetEvaluator( session, piecewise, 1 ) );
+    
+    FmlObjectHandle newType = Fieldml_CreateContinuousType( session, "test.other" );
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, newType );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, Fieldml_GetLastError( session ) );
+    
+    err = Fieldml_SetEvaluator( session, piecewise, 2, one );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, err );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetEvaluatorCount( session, piecewise ) );
+    
+    //Session settings are shared by all threads, so they are frozen too.
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, Fieldml_SetDebug( session, 1 ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, Fieldml_ClearErrors( session ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, Fieldml_SetValidationLevel( session, FML_VALIDATION_STRUCTURAL ) );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_ACCESS_VIOLATION, Fieldml_SetLazyImports( session, 1 ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+SIMPLE_TEST( FieldmlCloneSessionTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT( session != FML_INVALID_HANDLE );
+    
+    FmlObjectHandle realType = Fieldml_CreateContinuousType( session, "test.real" );
+    FmlObjectHandle ensembleType = Fieldml_CreateEnsembleType( session, "test.ensemble" );
+    FmlObjectHandle one = Fieldml_CreateConstantEvaluator( session, "test.one", "1", realType );
+    FmlObjectHandle two = Fieldml_CreateConstantEvaluator( session, "test.two", "2", realType );
+    FmlObjectHandle index = Fieldml_CreateArgumentEvaluator( session, "test.index", ensembleType );
+    FmlObjectHandle otherIndex = Fieldml_CreateArgumentEvaluator( session, "test.other_index", ensembleType );
+    FmlObjectHandle piecewise = Fieldml_CreatePiecewiseEvaluator( session, "test.piecewise", realType );
+    Fieldml_SetIndexEvaluator( session, piecewise, 1, index );
+    Fieldml_SetEvaluator( session, piecewise, 1, one );
+    
+    FmlObjectHandle listResource = Fieldml_CreateInlineDataResource( session, "test.list_resource" );
+    const char *listData = "1 2 3 4\n";
+    Fieldml_SetInlineData( session, listResource, listData, strlen( listData ) );
+    FmlObjectHandle listSource = Fieldml_CreateArrayDataSource( session, "test.list_source", listResource, "1", 1 );
+    int listSizes[1] = { 4 };
+    Fieldml_SetArrayDataSourceRawSizes( session, listSource, listSizes );
+    FmlObjectHandle listType = Fieldml_CreateEnsembleType( session, "test.list" );
+    Fieldml_SetEnsembleMembersDataSource( session, listType, FML_ENSEMBLE_MEMBER_LIST_DATA, 4, listSource );
+    int objectCount = Fieldml_GetTotalObjectCount( session );
+    
+    FmlSessionHandle clone = Fieldml_CloneSession( session );
+    SIMPLE_ASSERT( clone != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT( clone != session );
+    SIMPLE_ASSERT_EQUALS( objectCount, Fieldml_GetTotalObjectCount( clone ) );
+    SIMPLE_ASSERT_EQUALS( piecewise, Fieldml_GetObjectByName( clone, "test.piecewise" ) );
+    
+    //The source is frozen, but the clone can be modified without affecting it.
+    Fieldml_SetEvaluator( clone, piecewise, 2, two );
+    Fieldml_SetIndexEvaluator( clone, piecewise, 1, otherIndex );
+    SIMPLE_ASSERT_EQUALS( 2, Fieldml_GetEvaluatorCount( clone, piecewise ) );
+    SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetEvaluatorCount( session, piecewise ) );
+    SIMPLE_ASSERT_EQUALS( otherIndex, Fieldml_GetArgument( clone, piecewise, 1, 0, 1 ) );
+    SIMPLE_ASSERT_EQUALS( index, Fieldml_GetArgument( session, piecewise, 1, 0, 1 ) );
+    
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_CreateContinuousType( session, "test.other" ) );
+    
+    FmlObjectHandle newType = Fieldml_CreateContinuousType( clone, "test.other" );
+    SIMPLE_ASSERT_EQUALS( objectCount, newType );
+    SIMPLE_ASSERT_EQUALS( newType, Fieldml_GetObjectByName( clone, "test.other" ) );
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_GetObjectByName( session, "test.other" ) );
+    SIMPLE_ASSERT_EQUALS( objectCount, Fieldml_GetTotalObjectCount( session ) );
+    
+    //Declared names are found in both the shared and the clone's own objects.
+    SIMPLE_ASSERT_EQUALS( piecewise, Fieldml_GetObjectByDeclaredName( clone, "test.piecewise" ) );
+    SIMPLE_ASSERT_EQUALS( newType, Fieldml_GetObjectByDeclaredName( clone, "test.other" ) );
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_GetObjectByDeclaredName( session, "test.other" ) );
+    SIMPLE_ASSERT_EQUALS( FML_INVALID_HANDLE, Fieldml_GetObjectByDeclaredName( clone, "test.missing" ) );
+    
+    //Rejected modifications neither copy shared objects nor discard decoded members.
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetEnsembleMember( clone, listType, 3 ) );
+    int64_t objectUsage = Fieldml_GetMemoryUsage( clone, FML_MEMORY_OBJECTS );
+    int64_t cacheUsage = Fieldml_GetMemoryUsage( clone, FML_MEMORY_CACHES );
+    SIMPLE_ASSERT( Fieldml_AddArgument( clone, piecewise, one ) != FML_ERR_NO_ERROR );
+    SIMPLE_ASSERT( Fieldml_SetInlineData( clone, listResource, NULL, 0 ) != FML_ERR_NO_ERROR );
+    SIMPLE_ASSERT( Fieldml_SetEnsembleMembersRange( clone, listType, 1, 4, 0 ) != FML_ERR_NO_ERROR );
+    SIMPLE_ASSERT_EQUALS( objectUsage, Fieldml_GetMemoryUsage( clone, FML_MEMORY_OBJECTS ) );
+    SIMPLE_ASSERT_EQUALS( cacheUsage, Fieldml_GetMemoryUsage( clone, FML_MEMORY_CACHES ) );
+    
+    //Data sources must follow their resource when it is copied.
+    const char *newListData = "5 6 7 8\n";
+    Fieldml_SetInlineData( clone, listResource, newListData, strlen( newListData ) );
+    SIMPLE_ASSERT_EQUALS( 7, Fieldml_GetEnsembleMember( clone, listType, 3 ) );
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetEnsembleMember( session, listType, 3 ) );
+    SIMPLE_ASSERT_EQUALS( listResource, Fieldml_GetDataSourceResource( clone, listSource ) );
+    
+    //The clone keeps the source's objects alive.
+    Fieldml_Destroy( session );
+    SIMPLE_ASSERT_EQUALS( realType, Fieldml_GetObjectByName( clone, "test.real" ) );
+    SIMPLE_ASSERT_EQUALS( one, Fieldml_GetEvaluator( clone, piecewise, 1 ) );
+    
+    Fieldml_Destroy( clone );
+}
+
+
+#if !defined WIN32
+
+static void *createSessions( void *arg )
+{
+    FmlSessionHandle *handles = (FmlSessionHandle*)arg;
+    
+    for( int i = 0; i < 16; i++ )
+    {
+        handles[i] = Fieldml_Create( "test_path", "test" );
+        Fieldml_CreateContinuousType( handles[i], "test.real" );
+    }
+    
+    return NULL;
+}
+
+
+static void *causeError( void *arg )
+{
+    FmlSessionHandle session = *(FmlSessionHandle*)arg;
+    
+    Fieldml_CreateContinuousType( session, NULL );
+    
+    return (void*)(long)Fieldml_GetLastError( session );
+}
+
+
+/**
+ * Ensure that sessions can be created concurrently, and that each thread sees only its own errors.
+ */
+SIMPLE_TEST( FieldmlThreadedSessionTest )
+{
+    FmlSessionHandle handles[4][16];
+    pthread_t threads[4];
+    
+    for( int i = 0; i < 4; i++ )
+    {
+        pthread_create( &threads[i], NULL, createSessions, handles[i] );
+    }
+    for( int i = 0; i < 4; i++ )
+    {
+        pthread_join( threads[i], NULL );
+    }
+    
+    for( int i = 0; i < 4; i++ )
+    {
+        for( int j = 0; j < 16; j++ )
+        {
+            SIMPLE_ASSERT( handles[i][j] != FML_INVALID_HANDLE );
+            SIMPLE_ASSERT_EQUALS( 1, Fieldml_GetTotalObjectCount( handles[i][j] ) );
+            Fieldml_Destroy( handles[i][j] );
+        }
+    }
+    
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( session ) );
+    
+    void *threadError;
+    pthread_create( &threads[0], NULL, causeError, &session );
+    pthread_join( threads[0], &threadError );
+    
+    SIMPLE_ASSERT( (long)threadError != FML_ERR_NO_ERROR );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( session ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
+static const char * const PREFETCH_DIRECTORY = "prefetch_test";
+static const char * const PREFETCH_DOCUMENTS[] = { "prefetch_main.xml", "prefetch_a.xml", "prefetch_b.xml", "prefetch_c.xml" };
+static const int PREFETCH_DOCUMENT_COUNT = 4;
+
+static pthread_mutex_t prefetchOpenLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t prefetchMainThread;
+static int prefetchOpenCounts[PREFETCH_DOCUMENT_COUNT];
+static int prefetchMainThreadOpenCounts[PREFETCH_DOCUMENT_COUNT];
+
+
+static int getPrefetchDocumentIndex( const char *filename )
+{
+    for( int i = 0; i < PREFETCH_DOCUMENT_COUNT; i++ )
+    {
+        if( ( strstr( filename, PREFETCH_DIRECTORY ) != NULL ) && ( strstr( filename, PREFETCH_DOCUMENTS[i] ) != NULL ) )
+        {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+
+static int matchPrefetchDocument( const char *filename )
+{
+    return getPrefetchDocumentIndex( filename ) >= 0;
+}
+
+
+static void *openPrefetchDocument( const char *filename )
+{
+    const int index = getPrefetchDocumentIndex( filename );
+    
+    pthread_mutex_lock( &prefetchOpenLock );
+    prefetchOpenCounts[index]++;
+    if( pthread_equal( pthread_self(), prefetchMainThread ) )
+    {
+        prefetchMainThreadOpenCounts[index]++;
+    }
+    pthread_mutex_unlock( &prefetchOpenLock );
+    
+    return fopen( filename, "rb" );
+}
+
+
+static int readPrefetchDocument( void *context, char *buffer, int length )
+{
+    return (int)fread( buffer, 1, length, (FILE*)context );
+}
+
+
+static int closePrefetchDocument( void *context )
+{
+    return fclose( (FILE*)context );
+}
+
+
+/**
+ * Loads the prefetch test document with the given concurrency.
+ */
+static FmlSessionHandle loadPrefetchDocument( int concurrency )
+{
+    memset( prefetchOpenCounts, 0, sizeof( prefetchOpenCounts ) );
+    memset( prefetchMainThreadOpenCounts, 0, sizeof( prefetchMainThreadOpenCounts ) );
+    prefetchMainThread = pthread_self();
+    
+    Thread::setConcurrency( concurrency );
+    FmlSessionHandle session = Fieldml_CreateFromFileWithValidation( "prefetch_test/prefetch_main.xml", FML_VALIDATION_STRUCTURAL );
+    Thread::setConcurrency( 0 );
+    
+    return session;
+}
+
+
+/**
+ * Ensure that the documents imported by a document in another directory are found, and read only once, whether
+ * or not they are read ahead on other threads.
+ */
+SIMPLE_TEST( FieldmlPrefetchedImportTest )
+{
+    const char *main =
+        "<?xml version=\"1.0\"?>\n"
+        "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+        "<Region name=\"test\">\n"
+        "<Import xlink:href=\"prefetch_a.xml\" region=\"a\"><ImportType localName=\"test.a\" remoteName=\"a.real\"/></Import>\n"
+        "<Import xlink:href=\"prefetch_b.xml\" region=\"b\"><ImportType localName=\"test.b\" remoteName=\"b.real\"/></Import>\n"
+        "<Import xlink:href=\"prefetch_c.xml\" region=\"c\"><ImportType localName=\"test.c\" remoteName=\"c.real\"/></Import>\n"
+        "</Region>\n"
+        "</Fieldml>\n";
+    
+    mkdir( PREFETCH_DIRECTORY, 0755 );
+    writeTestDocument( "prefetch_test/prefetch_main.xml", main );
+    for( int i = 1; i < PREFETCH_DOCUMENT_COUNT; i++ )
+    {
+        const std::string region( 1, 'a' + ( i - 1 ) );
+        const std::string imported =
+            "<?xml version=\"1.0\"?>\n"
+            "<Fieldml version=\"0.5\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n"
+            "<Region name=\"" + region + "\">\n"
+            "<ContinuousType name=\"" + region + ".real\"/>\n"
+            "</Region>\n"
+            "</Fieldml>\n";
+        writeTestDocument( ( std::string( "prefetch_test/" ) + PREFETCH_DOCUMENTS[i] ).c_str(), imported.c_str() );
+    }
+    
+    xmlRegisterInputCallbacks( matchPrefetchDocument, openPrefetchDocument, readPrefetchDocument, closePrefetchDocument );
+    
+    //The first import is read as it is reached, and the others ahead of time on other threads.
+    FmlSessionHandle session = loadPrefetchDocument( 4 );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetTotalObjectCount( session ) );
+    SIMPLE_ASSERT( Fieldml_GetObjectByName( session, "test.c" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( std::string( "prefetch_test" ), std::string( Fieldml_PeekRegionRoot( session ) ) );
+    for( int i = 0; i < PREFETCH_DOCUMENT_COUNT; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( 1, prefetchOpenCounts[i] );
+        SIMPLE_ASSERT_EQUALS( ( i < 2 ) ? 1 : 0, prefetchMainThreadOpenCounts[i] );
+    }
+    Fieldml_Destroy( session );
+    
+    //With only one processor, every import is read as it is reached.
+    session = loadPrefetchDocument( 1 );
+    SIMPLE_ASSERT_EQUALS( 0, Fieldml_GetErrorCount( session ) );
+    SIMPLE_ASSERT_EQUALS( 3, Fieldml_GetTotalObjectCount( session ) );
+    SIMPLE_ASSERT( Fieldml_GetObjectByName( session, "test.c" ) != FML_INVALID_HANDLE );
+    for( int i = 0; i < PREFETCH_DOCUMENT_COUNT; i++ )
+    {
+        SIMPLE_ASSERT_EQUALS( 1, prefetchOpenCounts[i] );
+        SIMPLE_ASSERT_EQUALS( 1, prefetchMainThreadOpenCounts[i] );
+    }
+    Fieldml_Destroy( session );
+    
+    xmlPopInputCallbacks();
+    
+    for( int i = 0; i < PREFETCH_DOCUMENT_COUNT; i++ )
+    {
+        remove( ( std::string( "prefetch_test/" ) + PREFETCH_DOCUMENTS[i] ).c_str() );
+    }
+    rmdir( PREFETCH_DIRECTORY );
+}
+
+#endif
+
+
+/**
+ * Ensure that a thread's errors are kept for each live session while many other sessions come and go.
+ */
+SIMPLE_TEST( FieldmlThreadStateTest )
+{
+    FmlSessionHandle session = Fieldml_Create( "test_path", "test" );
+    Fieldml_SetDebug( session, 0 );
+    Fieldml_CreateContinuousType( session, NULL );
+    FmlErrorNumber error = Fieldml_GetLastError( session );
+    SIMPLE_ASSERT( error != FML_ERR_NO_ERROR );
+    
+    for( int i = 0; i < 256; i++ )
+    {
+        FmlSessionHandle temporary = Fieldml_Create( "test_path", "test" );
+        Fieldml_SetDebug( temporary, 0 );
+        Fieldml_CreateContinuousType( temporary, NULL );
+        SIMPLE_ASSERT_EQUALS( error, Fieldml_GetLastError( temporary ) );
+        Fieldml_Destroy( temporary );
+    }
+    
+    SIMPLE_ASSERT_EQUALS( error, Fieldml_GetLastError( session ) );
+    SIMPLE_ASSERT( Fieldml_CreateContinuousType( session, "test.real" ) != FML_INVALID_HANDLE );
+    SIMPLE_ASSERT_EQUALS( FML_ERR_NO_ERROR, Fieldml_GetLastError( session ) );
+    
+    Fieldml_Destroy( session );
+}
+
+
 /**
  * Ensure that destroyed sessions are inaccessible.
  */